@@ -1,41 +1,93 @@
 
 #include "airline.h"
+#include "hashindex.h"
+#include "arena.h"
+#include "checkinqueue.h"
+#include "nodepool.h"
+#include "mpmcring.h"
+#include "stores.h"
+#include "persist.h"
+#include "routegraph.h"
+#include "apsp.h"
+#include "workpool.h"
+#include "routenetwork.h"
+#include "routequery.h"
+#include "journey.h"
+#include "routeupdate.h"
+#include "spanningtree.h"
+#include "reportwriter.h"
+#include "storequery.h"
+#include "waitlist.h"
+#include "seatmap.h"
+#include <math.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 #include <time.h>
 #include <stdbool.h>
 #include <float.h>
+#include <stdatomic.h>
+#include <pthread.h>
 
 // Globals
-Flight flights[MAX_FLIGHTS];
+RecordArena flightStore = RECORD_ARENA_INIT(FlightInfo, 10);
+FlightColumns flightColumns = FLIGHT_COLUMNS_INIT;
 int flightCount = 0;
-Passenger passengers[MAX_PASSENGERS];
+RecordArena airportStore = RECORD_ARENA_INIT(AirportCode, 8);
+int airportCount = 0;
+RecordArena passengerStore = RECORD_ARENA_INIT(Passenger, 12);
 int passengerCount = 0;
-CheckInNode* checkInFront = NULL;
-CheckInNode* checkInRear = NULL;
 
-#define MAX_ANALYSIS_AIRPORTS 40
-#define INF_WEIGHT 1e12
-#define APSP_FLOYD_THRESHOLD 10
+#define CHECKIN_POOL_PREALLOC 1024
+#define CHECKIN_RING_CAPACITY 4096
 
-typedef struct {
-    int src;
-    int dest;
-    double weight;
-} RouteEdge;
+static CheckInQueue checkInQueue = CHECKIN_QUEUE_INIT;
+static NodePool checkInNodePool = NODE_POOL_INIT(CheckInNode, 10);
+static MpmcRing checkInIngress;
+static MpmcRing checkInFreeNodes;         // released nodes, reused without checkInPoolLock
+static atomic_size_t checkInNodesParked;   // in checkInFreeNodes
+static atomic_size_t checkInNodesRecycled; // allocations served from checkInFreeNodes
+static atomic_ullong checkInSequence;
+static pthread_once_t checkInServiceOnce = PTHREAD_ONCE_INIT;
+static int checkInServiceReady; // set by initCheckInService() once both rings exist
+static pthread_mutex_t checkInHeapLock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_mutex_t checkInPoolLock = PTHREAD_MUTEX_INITIALIZER;
+// Guards passenger record appends and passengerIndex against concurrent bookings
+pthread_rwlock_t passengerRegistryLock = PTHREAD_RWLOCK_INITIALIZER;
 
-typedef struct {
-    int vertexCount;
-    int directed; // bool, but keep int for scanf compatibility
-    double **adjMatrix;
-} RouteGraph;
+static const char* flightKeyAt(void* ctx, int index) { (void)ctx; return flightAt(index)->flightNumber; }
+static const char* passengerKeyAt(void* ctx, int index) { (void)ctx; return passengerAt(index)->id; }
+static const char* airportKeyAt(void* ctx, int index) { (void)ctx; return airportCode(index); }
 
-typedef struct {
-    int src;
-    int dest;
-    double weight;
-} MSTResultEdge;
+// Hash indexes over flightNumber, passenger id and airport code, kept in sync with the stores on insert
+HashIndex flightIndex = HASH_INDEX_INIT(flightKeyAt);
+HashIndex passengerIndex = HASH_INDEX_INIT(passengerKeyAt);
+HashIndex airportIndex = HASH_INDEX_INIT(airportKeyAt);
+SecondaryIndex passengersByFlight = SECONDARY_INDEX_INIT;
+SecondaryIndex flightsByOrigin = SECONDARY_INDEX_INIT;
+
+#define TICKET_LOCK_STRIPES 64
+#define WAITLIST_DEFAULT_PRIORITY 2
+
+// One Waitlist per flight index. Waitlists are not persisted: they are rebuilt from
+// the passengers' ticket status on first use after a load, so warm start stays lazy.
+static RecordArena waitlistStore = RECORD_ARENA_INIT(Waitlist, 10);
+static atomic_int waitlistsBuilt;
+static pthread_mutex_t waitlistBuildLock = PTHREAD_MUTEX_INITIALIZER;
+// Seat maps likewise live outside the snapshot; seat numbers are kept on the passenger records.
+// The first flightsSeatMapped flights have one.
+static RecordArena seatMapStore = RECORD_ARENA_INIT(SeatMap, 10);
+static atomic_int flightsSeatMapped;
+static pthread_mutex_t seatMapBuildLock = PTHREAD_MUTEX_INITIALIZER;
+// Flight i's waitlist, seat hand-overs and passengers' seat numbers are guarded by
+// ticketLocks[i % TICKET_LOCK_STRIPES]; a thread holding one may take seatMapBuildLock
+// or passengerRegistryLock, never the other way round
+static pthread_mutex_t ticketLocks[TICKET_LOCK_STRIPES] = { [0 ... TICKET_LOCK_STRIPES - 1] = PTHREAD_MUTEX_INITIALIZER };
+
+// Dense matrix and all-pairs table cost V^2 doubles each (32 MiB at the limit)
+#define ROUTE_MATRIX_MAX_AIRPORTS 2048
+#define ROUTE_PRINT_MAX_AIRPORTS 12
+#define ROUTE_PRINT_MAX_ROWS 40
 
 typedef struct {
     const char* src;
@@ -55,6 +107,9 @@ typedef struct {
 
 /* Keep a single built-in demo scenario for simplicity — 6 Indian airports (undirected). */
 static const char* const SAMPLE_SMALL_APSP_NAMES[] = {"DEL", "BOM", "BLR", "HYD", "CCU", "PNQ"};
+static const double SAMPLE_SMALL_APSP_COORDS[][2] = {
+    {28.5665, 77.1031}, {19.0896, 72.8656}, {13.1986, 77.7066}, {17.2403, 78.4294}, {22.6547, 88.4467}, {18.5822, 73.9197}
+};
 static const SampleEdge SAMPLE_SMALL_APSP_EDGES[] = {
     {"DEL", "BOM", 720}, {"DEL", "BLR", 1740}, {"DEL", "HYD", 1265}, {"DEL", "CCU", 1300}, {"DEL", "PNQ", 1440},
     {"BOM", "BLR", 984}, {"BOM", "HYD", 710}, {"BOM", "CCU", 1650}, {"BOM", "PNQ", 148},
@@ -63,30 +118,555 @@ static const SampleEdge SAMPLE_SMALL_APSP_EDGES[] = {
     {"CCU", "PNQ", 1655}
 };
 
-static RouteGraph createRouteGraph(int vertices, int directed);
-static void freeRouteGraph(RouteGraph* graph);
-static double** allocateMatrix(int n, double initial);
-static void freeMatrix(double** matrix, int n);
-static void printGraphDiagram(const RouteGraph* graph, char airportNames[][NAME_LEN]);
-static int findAirportIndex(char airportNames[][NAME_LEN], int count, const char* name);
-static double primMST(const RouteGraph* graph, MSTResultEdge* output, int* edgeCount);
-static double kruskalMST(const RouteGraph* graph, RouteEdge* edges, int edgeCount, MSTResultEdge* output, int* mstEdgeCount);
-static int buildUndirectedEdgeList(const RouteGraph* graph, RouteEdge** edgesOut);
-static int disjointSetFind(int* parent, int v);
-static void disjointSetUnion(int* parent, int* rank, int a, int b);
-static int compareRouteEdges(const void* a, const void* b);
-static int floydWarshallAllPairs(const RouteGraph* graph, double** distOut);
-static void dijkstra(const RouteGraph* graph, int src, double* dist);
-static void printDistanceMatrix(double** dist, int n, char airportNames[][NAME_LEN]);
-/* We keep a single small built-in demo; no multiple-scenario helpers required. */
+static int loadSampleNetwork(RouteNetwork* net);
+static void printGraphDiagram(const RouteGraph* graph, const RouteNetwork* net);
+static void printMstEdges(const MSTResultEdge* edges, int count, const RouteNetwork* net);
+static void printMstOutcome(const char* engine, double weight, const MSTResultEdge* edges, int count, double ms,
+                            const RouteNetwork* net);
+static void printDistanceList(const double* dist, const RouteNetwork* net);
+static void printItinerary(const RouteNetwork* net, const CsrGraph* csr, int from, int to);
+static void printDistanceMatrix(const DistanceMatrix* dist, const RouteNetwork* net);
+static void applyRouteChanges(const RouteNetwork* net, DistanceMatrix* apsp);
+static double wallClockMs(void);
 
 // Functions
-void addFlight() {
-    if (flightCount >= MAX_FLIGHTS) {
-        printf("Flight list full!\n");
-        return;
+FlightInfo* flightAt(int index) {
+    return (FlightInfo*)recordArenaAt(&flightStore, (size_t)index);
+}
+
+void flightRow(int index, Flight* out) {
+    const FlightInfo* info = flightAt(index);
+    const FlightColumnBlock* block = flightColumnsBlock(&flightColumns, (size_t)index);
+    size_t slot = FLIGHT_ROW_SLOT(index);
+    memset(out, 0, sizeof(*out));
+    strcpy(out->flightNumber, info->flightNumber);
+    strcpy(out->origin, airportCode(info->origin));
+    strcpy(out->destination, airportCode(info->destination));
+    strcpy(out->departureTime, info->departureTime);
+    strcpy(out->arrivalTime, info->arrivalTime);
+    strcpy(out->aircraft, info->aircraft);
+    strcpy(out->status, info->status);
+    out->capacity = block->capacity[slot];
+    out->price = block->price[slot];
+    out->priority = block->priority[slot];
+    out->overbook = block->overbook[slot];
+    out->bookedSeats = atomic_load_explicit(&block->bookedSeats[slot], memory_order_relaxed);
+}
+
+int flightSeatsLeft(int index) {
+    const FlightColumnBlock* block = flightColumnsBlock(&flightColumns, (size_t)index);
+    size_t slot = FLIGHT_ROW_SLOT(index);
+    return block->capacity[slot] + block->overbook[slot] -
+           atomic_load_explicit(&block->bookedSeats[slot], memory_order_relaxed);
+}
+
+float flightPrice(int index) {
+    return flightColumnsBlock(&flightColumns, (size_t)index)->price[FLIGHT_ROW_SLOT(index)];
+}
+
+Passenger* passengerAt(int index) {
+    return (Passenger*)recordArenaAt(&passengerStore, (size_t)index);
+}
+
+// Called only from createFlight(), under the registry write lock, and from log replay
+int internAirport(const char* code) {
+    int existing = hashIndexFind(&airportIndex, code);
+    if (existing != -1) return existing;
+    size_t len = strlen(code);
+    if (len == 0 || len >= NAME_LEN) return -1;
+    AirportCode* a = (AirportCode*)recordArenaSlot(&airportStore, (size_t)airportCount);
+    if (!a) return -1;
+    memcpy(a->code, code, len + 1);
+    if (hashIndexInsert(&airportIndex, airportCount) != 0) return -1;
+    return airportCount++;
+}
+
+int findAirport(const char* code) {
+    return hashIndexFind(&airportIndex, code);
+}
+
+const char* airportCode(int airport) {
+    return ((const AirportCode*)recordArenaAt(&airportStore, (size_t)airport))->code;
+}
+
+int syncSecondaryIndexes(void) {
+    while (flightsByOrigin.indexedCount < flightCount) {
+        if (secondaryIndexAppend(&flightsByOrigin, flightAt(flightsByOrigin.indexedCount)->origin) != 0) return -1;
+    }
+    while (passengersByFlight.indexedCount < passengerCount) {
+        if (secondaryIndexAppend(&passengersByFlight, passengerAt(passengersByFlight.indexedCount)->flightIndex) != 0) return -1;
+    }
+    return 0;
+}
+
+const char* checkInStatusName(CheckInStatus status) {
+    switch (status) {
+        case CHECKIN_PENDING: return "pending";
+        case CHECKIN_DONE: return "checked-in";
+    }
+    return "unknown";
+}
+
+const char* passengerStatusName(const Passenger* p) {
+    if (p->ticketStatus == TICKET_CANCELLED) return "cancelled";
+    if (p->ticketStatus == TICKET_WAITLISTED) return "waitlisted";
+    return checkInStatusName((CheckInStatus)p->checkInStatus);
+}
+
+int findFlightIndex(const char* flightNumber) {
+    return hashIndexFind(&flightIndex, flightNumber);
+}
+
+int findPassengerIndex(const char* passengerId) {
+    pthread_rwlock_rdlock(&passengerRegistryLock);
+    int idx = hashIndexFind(&passengerIndex, passengerId);
+    pthread_rwlock_unlock(&passengerRegistryLock);
+    return idx;
+}
+
+const char* bookingStatusMessage(BookingStatus status) {
+    switch (status) {
+        case BOOKING_OK: return "OK";
+        case BOOKING_FLIGHT_NOT_FOUND: return "Flight not found!";
+        case BOOKING_FLIGHT_FULL: return "Flight is full!";
+        case BOOKING_DUPLICATE_ID: return "ID already exists!";
+        case BOOKING_NO_MEMORY: return "Out of memory!";
+        case BOOKING_WAITLISTED: return "Flight is full; added to the waitlist.";
+        case BOOKING_PASSENGER_NOT_FOUND: return "Passenger not found!";
+        case BOOKING_ALREADY_CANCELLED: return "Booking is already cancelled.";
+        case BOOKING_SEAT_UNAVAILABLE: return "Seat is not available!";
+        case BOOKING_NOT_CONFIRMED: return "Only confirmed tickets can hold a seat.";
+    }
+    return "Unknown error";
+}
+
+int flightClockMinutes(const char* hhmm) {
+    int h, m;
+    if (sscanf(hhmm, "%d:%d", &h, &m) != 2 || h < 0 || h > 23 || m < 0 || m > 59) return -1;
+    return h * 60 + m;
+}
+
+/*
+ * Seat inventory: bookedSeats is advanced with a per-flight CAS, so
+ * concurrent agents can never oversell and unrelated flights never
+ * contend with each other.
+ */
+int reserveSeats(int flightIndex, int seats) {
+    FlightColumnBlock* block = flightColumnsBlock(&flightColumns, (size_t)flightIndex);
+    size_t slot = FLIGHT_ROW_SLOT(flightIndex);
+    int booked = atomic_load_explicit(&block->bookedSeats[slot], memory_order_relaxed);
+    do {
+        if (booked + seats > block->capacity[slot] + block->overbook[slot]) return -1;
+    } while (!atomic_compare_exchange_weak_explicit(&block->bookedSeats[slot], &booked, booked + seats,
+                                                    memory_order_acq_rel, memory_order_relaxed));
+    return 0;
+}
+
+void releaseSeats(int flightIndex, int seats) {
+    FlightColumnBlock* block = flightColumnsBlock(&flightColumns, (size_t)flightIndex);
+    atomic_fetch_sub_explicit(&block->bookedSeats[FLIGHT_ROW_SLOT(flightIndex)], seats, memory_order_acq_rel);
+}
+
+// Room for one more flight row and its two airports, so nothing after the first intern can fail
+static int reserveFlightRow(void) {
+    if (!recordArenaSlot(&flightStore, (size_t)flightCount) || flightColumnsReserve(&flightColumns, (size_t)flightCount + 1) != 0 ||
+        !recordArenaSlot(&waitlistStore, (size_t)flightCount) || !recordArenaSlot(&seatMapStore, (size_t)flightCount) ||
+        !recordArenaSlot(&airportStore, (size_t)airportCount + 1) || hashIndexReserve(&airportIndex, airportIndex.count + 2) != 0 ||
+        hashIndexReserve(&flightIndex, flightIndex.count + 1) != 0) {
+        return -1;
+    }
+    return 0;
+}
+
+static int validAirportCode(const char* code) {
+    size_t len = strlen(code);
+    return len > 0 && len < NAME_LEN;
+}
+
+/*
+ * Flights are set up before agents start booking; this is not meant to
+ * race with bookPassenger(). Every store, index and count it touches
+ * changes under the registry write lock, so a compaction (which takes
+ * it) never sees an index slot for a record it does not save.
+ */
+BookingStatus createFlight(const Flight* details, int* indexOut) {
+    BookingStatus status = BOOKING_OK;
+    uint64_t lsn = 0;
+    pthread_rwlock_wrlock(&passengerRegistryLock);
+    // Checked before anything is reserved or interned, so a rejected flight leaves no orphan airports
+    if (findFlightIndex(details->flightNumber) != -1) {
+        status = BOOKING_DUPLICATE_ID;
+    } else if (!validAirportCode(details->origin) || !validAirportCode(details->destination) || reserveFlightRow() != 0) {
+        status = BOOKING_NO_MEMORY;
+    } else {
+        FlightInfo* f = (FlightInfo*)recordArenaAt(&flightStore, (size_t)flightCount);
+        strcpy(f->flightNumber, details->flightNumber);
+        f->origin = internAirport(details->origin);
+        f->destination = internAirport(details->destination);
+        strcpy(f->departureTime, details->departureTime);
+        strcpy(f->arrivalTime, details->arrivalTime);
+        strcpy(f->aircraft, details->aircraft);
+        strcpy(f->status, "scheduled");
+        FlightColumnBlock* block = flightColumnsBlock(&flightColumns, (size_t)flightCount);
+        size_t slot = FLIGHT_ROW_SLOT(flightCount);
+        block->capacity[slot] = details->capacity;
+        block->price[slot] = details->price;
+        block->priority[slot] = details->priority;
+        block->overbook[slot] = details->overbook > 0 ? details->overbook : 0;
+        atomic_store(&block->bookedSeats[slot], 0);
+        hashIndexInsert(&flightIndex, flightCount); // room reserved, number checked above
+        if (indexOut) *indexOut = flightCount;
+        lsn = persistLogFlight(flightCount);
+        flightCount++;
+        // Best effort: a query retries indexing if memory ran out here
+        syncSecondaryIndexes();
+    }
+    pthread_rwlock_unlock(&passengerRegistryLock);
+    if (status == BOOKING_OK) persistCommit(lsn);
+    return status;
+}
+
+// Appends a passenger record whose seat the caller has settled; *lsn is its log entry.
+static BookingStatus appendPassenger(const Passenger* details, int flightIdx, TicketStatus ticket, int priority,
+                                     int* indexOut, uint64_t* lsn) {
+    BookingStatus status = BOOKING_OK;
+    pthread_rwlock_wrlock(&passengerRegistryLock);
+    Passenger* p = (Passenger*)recordArenaSlot(&passengerStore, (size_t)passengerCount);
+    if (!p) {
+        status = BOOKING_NO_MEMORY;
+    } else {
+        *p = *details;
+        p->flightIndex = flightIdx;
+        p->checkInStatus = CHECKIN_PENDING;
+        p->ticketStatus = ticket;
+        p->waitlistPriority = priority;
+        p->seat = -1;
+        int indexed = hashIndexInsert(&passengerIndex, passengerCount);
+        if (indexed == 1) {
+            status = BOOKING_DUPLICATE_ID;
+        } else if (indexed != 0) {
+            status = BOOKING_NO_MEMORY;
+        } else {
+            if (indexOut) *indexOut = passengerCount;
+            *lsn = persistLogPassenger(passengerCount);
+            passengerCount++;
+            syncSecondaryIndexes();
+        }
+    }
+    pthread_rwlock_unlock(&passengerRegistryLock);
+    return status;
+}
+
+/*
+ * Thread-safe booking. The seat is claimed lock-free first; only the
+ * passenger record append and index insert are serialised, and the
+ * seat is handed back if that step fails. The log entry is appended
+ * under the registry lock, so the log holds passengers in store order,
+ * and committed after it is released, so concurrent bookings share syncs.
+ */
+BookingStatus bookPassenger(const Passenger* details, const char* flightNumber, int* indexOut) {
+    if (findPassengerIndex(details->id) != -1) return BOOKING_DUPLICATE_ID;
+    int flightIdx = findFlightIndex(flightNumber);
+    if (flightIdx == -1) return BOOKING_FLIGHT_NOT_FOUND;
+    if (reserveSeats(flightIdx, 1) != 0) return BOOKING_FLIGHT_FULL;
+
+    uint64_t lsn = 0;
+    BookingStatus status = appendPassenger(details, flightIdx, TICKET_CONFIRMED, 0, indexOut, &lsn);
+    if (status != BOOKING_OK) releaseSeats(flightIdx, 1);
+    else persistCommit(lsn);
+    return status;
+}
+
+static pthread_mutex_t* ticketLockFor(int flightIdx) {
+    return &ticketLocks[(unsigned)flightIdx % TICKET_LOCK_STRIPES];
+}
+
+// Queues every waitlisted record loaded from disk; runs once per load, on the first waitlist operation.
+static int ensureWaitlists(void) {
+    if (atomic_load_explicit(&waitlistsBuilt, memory_order_acquire)) return 0;
+    int status = 0;
+    pthread_mutex_lock(&waitlistBuildLock);
+    if (!atomic_load_explicit(&waitlistsBuilt, memory_order_relaxed)) {
+        if (flightCount > 0 && !recordArenaSlot(&waitlistStore, (size_t)flightCount - 1)) status = -1;
+        pthread_rwlock_rdlock(&passengerRegistryLock);
+        for (int i = 0; status == 0 && i < passengerCount; ++i) {
+            const Passenger* p = passengerAt(i);
+            if (p->ticketStatus != TICKET_WAITLISTED) continue;
+            Waitlist* list = (Waitlist*)recordArenaAt(&waitlistStore, (size_t)p->flightIndex);
+            if (waitlistPush(list, i, p->waitlistPriority) != 0) status = -1;
+            else list->live++;
+        }
+        pthread_rwlock_unlock(&passengerRegistryLock);
+        if (status == 0) {
+            atomic_store_explicit(&waitlistsBuilt, 1, memory_order_release);
+        } else if (flightCount > 0 && recordArenaCapacity(&waitlistStore) >= (size_t)flightCount) {
+            // Every list was empty before this pass; empty them again so a retry does not queue anyone twice
+            for (int f = 0; f < flightCount; ++f) {
+                Waitlist* list = (Waitlist*)recordArenaAt(&waitlistStore, (size_t)f);
+                list->count = 0;
+                list->live = 0;
+            }
+        }
+    }
+    pthread_mutex_unlock(&waitlistBuildLock);
+    return status;
+}
+
+// Records never move, but concurrent bookings may grow the arena's chunk directory while it is read
+static Passenger* sharedPassengerAt(int index) {
+    pthread_rwlock_rdlock(&passengerRegistryLock);
+    Passenger* p = passengerAt(index);
+    pthread_rwlock_unlock(&passengerRegistryLock);
+    return p;
+}
+
+/*
+ * Returns the flight's seat map, or NULL on allocation failure. Maps are
+ * built on first use for every flight created so far; the first pass
+ * after a load also re-takes the seats confirmed passengers hold. A seat
+ * that cannot be re-taken is reported, cleared and logged as a SEAT entry
+ * so the next load agrees. Seat numbers only change through functions
+ * that get here first, so none move while that pass reads them.
+ */
+static SeatMap* seatMapFor(int flightIdx) {
+    if (flightIdx < atomic_load_explicit(&flightsSeatMapped, memory_order_acquire)) {
+        return (SeatMap*)recordArenaAt(&seatMapStore, (size_t)flightIdx);
+    }
+    uint64_t lsn = 0;
+    pthread_mutex_lock(&seatMapBuildLock);
+    int mapped = atomic_load_explicit(&flightsSeatMapped, memory_order_relaxed);
+    int total = flightCount;
+    int built = mapped;
+    if (total > mapped && recordArenaSlot(&seatMapStore, (size_t)total - 1)) {
+        while (built < total) {
+            int capacity = flightColumnsBlock(&flightColumns, (size_t)built)->capacity[FLIGHT_ROW_SLOT(built)];
+            if (seatMapInit((SeatMap*)recordArenaAt(&seatMapStore, (size_t)built), capacity) != 0) break;
+            built++;
+        }
+    }
+    if (built < total) {
+        // All or nothing, so the restore below never runs against a partly built set
+        while (built > mapped) seatMapFree((SeatMap*)recordArenaAt(&seatMapStore, (size_t)--built));
+    } else if (mapped == 0) {
+        pthread_rwlock_rdlock(&passengerRegistryLock);
+        for (int i = 0; i < passengerCount; ++i) {
+            Passenger* p = passengerAt(i);
+            if (p->seat < 0 || p->flightIndex >= total) continue;
+            SeatMap* map = (SeatMap*)recordArenaAt(&seatMapStore, (size_t)p->flightIndex);
+            int confirmed = p->ticketStatus == TICKET_CONFIRMED;
+            if (confirmed && seatMapClaim(map, p->seat) == 0) continue;
+            // The first record keeps a doubly held seat; the loser's reset is logged like any seat change
+            const char* reason = !confirmed ? passengerStatusName(p)
+                               : p->seat >= map->capacity ? "no such seat" : "held by another booking";
+            char label[SEAT_LABEL_LEN];
+            seatMapLabel(map, p->seat, label);
+            if (label[0] == '-') snprintf(label, sizeof label, "#%d", p->seat);
+            printf("Warning: %s's seat %s on flight %s was cleared (%s).\n", p->id, label,
+                   flightAt(p->flightIndex)->flightNumber, reason);
+            p->seat = -1;
+            lsn = persistLogSeat(i);
+        }
+        pthread_rwlock_unlock(&passengerRegistryLock);
+    }
+    atomic_store_explicit(&flightsSeatMapped, built, memory_order_release);
+    pthread_mutex_unlock(&seatMapBuildLock);
+    persistCommit(lsn);
+    return flightIdx < built ? (SeatMap*)recordArenaAt(&seatMapStore, (size_t)flightIdx) : NULL;
+}
+
+static Waitlist* waitlistFor(int flightIdx) {
+    return (Waitlist*)recordArenaAt(&waitlistStore, (size_t)flightIdx);
+}
+
+// Gives a seat the caller already holds to the front booking still waiting; caller holds the flight's lock.
+static int promoteNextLocked(Waitlist* list, uint64_t* lsn) {
+    WaitlistEntry e;
+    while (waitlistPop(list, &e) == 0) {
+        Passenger* p = sharedPassengerAt(e.passenger);
+        if (p->ticketStatus != TICKET_WAITLISTED) continue; // cancelled while waiting
+        p->ticketStatus = TICKET_CONFIRMED;
+        list->live--;
+        *lsn = persistLogTicket(e.passenger);
+        return e.passenger;
     }
-    Flight* f = &flights[flightCount];
+    return -1;
+}
+
+BookingStatus bookOrWaitlist(const Passenger* details, const char* flightNumber, int priority, int* indexOut) {
+    if (findPassengerIndex(details->id) != -1) return BOOKING_DUPLICATE_ID;
+    int flightIdx = findFlightIndex(flightNumber);
+    if (flightIdx == -1) return BOOKING_FLIGHT_NOT_FOUND;
+    if (ensureWaitlists() != 0) return BOOKING_NO_MEMORY;
+    if (priority < 1) priority = 1;
+    Waitlist* list = waitlistFor(flightIdx);
+    pthread_mutex_t* lock = ticketLockFor(flightIdx);
+    int index = -1;
+    uint64_t lsn = 0;
+    pthread_mutex_lock(lock);
+    // Cancellations hand seats over under this lock, so a seat cannot come free unseen between
+    // this attempt and joining the queue
+    int seated = reserveSeats(flightIdx, 1) == 0;
+    BookingStatus status = appendPassenger(details, flightIdx, seated ? TICKET_CONFIRMED : TICKET_WAITLISTED,
+                                           seated ? 0 : priority, &index, &lsn);
+    if (status != BOOKING_OK) {
+        if (seated) releaseSeats(flightIdx, 1);
+    } else if (!seated) {
+        if (waitlistPush(list, index, priority) == 0) {
+            list->live++;
+            status = BOOKING_WAITLISTED;
+        } else {
+            // Nothing would ever promote it; the record stays as a tombstone
+            sharedPassengerAt(index)->ticketStatus = TICKET_CANCELLED;
+            lsn = persistLogTicket(index);
+            status = BOOKING_NO_MEMORY;
+        }
+    }
+    pthread_mutex_unlock(lock);
+    persistCommit(lsn);
+    if (indexOut) *indexOut = index;
+    return status;
+}
+
+BookingStatus cancelBooking(const char* passengerId, int* promotedOut) {
+    if (promotedOut) *promotedOut = -1;
+    int idx = findPassengerIndex(passengerId);
+    if (idx == -1) return BOOKING_PASSENGER_NOT_FOUND;
+    if (ensureWaitlists() != 0) return BOOKING_NO_MEMORY;
+    Passenger* p = sharedPassengerAt(idx);
+    int flightIdx = p->flightIndex;
+    SeatMap* seats = seatMapFor(flightIdx);
+    if (!seats) return BOOKING_NO_MEMORY;
+    Waitlist* list = waitlistFor(flightIdx);
+    pthread_mutex_t* lock = ticketLockFor(flightIdx);
+    BookingStatus status = BOOKING_OK;
+    int promoted = -1;
+    uint64_t lsn = 0;
+    pthread_mutex_lock(lock);
+    if (p->ticketStatus == TICKET_CANCELLED) {
+        status = BOOKING_ALREADY_CANCELLED;
+    } else {
+        int heldSeat = p->ticketStatus == TICKET_CONFIRMED;
+        if (!heldSeat) list->live--;
+        p->ticketStatus = TICKET_CANCELLED;
+        lsn = persistLogTicket(idx);
+        if (p->seat >= 0) {
+            seatMapRelease(seats, p->seat);
+            p->seat = -1;
+            lsn = persistLogSeat(idx);
+        }
+        // The seat changes hands without passing through the pool, unless a lowered
+        // overbooking limit means it is no longer sellable
+        if (heldSeat && list->live > 0 && flightSeatsLeft(flightIdx) >= 0) promoted = promoteNextLocked(list, &lsn);
+        if (heldSeat && promoted == -1) releaseSeats(flightIdx, 1);
+    }
+    pthread_mutex_unlock(lock);
+    persistCommit(lsn);
+    if (promotedOut) *promotedOut = promoted;
+    return status;
+}
+
+int setOverbookLimit(int flightIndex, int limit) {
+    if (flightIndex < 0 || flightIndex >= flightCount || limit < 0) return -1;
+    if (ensureWaitlists() != 0) return -1;
+    Waitlist* list = waitlistFor(flightIndex);
+    pthread_mutex_t* lock = ticketLockFor(flightIndex);
+    int promoted = 0;
+    pthread_mutex_lock(lock);
+    flightColumnsBlock(&flightColumns, (size_t)flightIndex)->overbook[FLIGHT_ROW_SLOT(flightIndex)] = limit;
+    uint64_t lsn = persistLogOverbook(flightIndex);
+    while (list->live > 0 && reserveSeats(flightIndex, 1) == 0) {
+        if (promoteNextLocked(list, &lsn) == -1) {
+            releaseSeats(flightIndex, 1);
+            break;
+        }
+        promoted++;
+    }
+    pthread_mutex_unlock(lock);
+    persistCommit(lsn);
+    return promoted;
+}
+
+BookingStatus assignSeat(int passengerIndex, int seat, SeatCabin cabin, SeatPreference pref, int* seatOut) {
+    if (seatOut) *seatOut = -1;
+    Passenger* p = sharedPassengerAt(passengerIndex);
+    int flightIdx = p->flightIndex;
+    SeatMap* map = seatMapFor(flightIdx);
+    if (!map) return BOOKING_NO_MEMORY;
+    pthread_mutex_t* lock = ticketLockFor(flightIdx);
+    BookingStatus status = BOOKING_OK;
+    uint64_t lsn = 0;
+    pthread_mutex_lock(lock);
+    if (p->ticketStatus != TICKET_CONFIRMED) {
+        status = BOOKING_NOT_CONFIRMED;
+    } else if (seat < 0 || seat != p->seat) {
+        int taken = seat >= 0 ? (seatMapClaim(map, seat) == 0 ? seat : -1) : seatMapClaimFirst(map, cabin, pref);
+        if (taken == -1) {
+            status = BOOKING_SEAT_UNAVAILABLE;
+        } else {
+            if (p->seat >= 0) seatMapRelease(map, p->seat);
+            p->seat = taken;
+            lsn = persistLogSeat(passengerIndex);
+        }
+    }
+    if (seatOut) *seatOut = p->seat;
+    pthread_mutex_unlock(lock);
+    persistCommit(lsn);
+    return status;
+}
+
+BookingStatus assignAdjacentSeats(int flightIndex, const int* passengers, int count, SeatCabin cabin, int* firstSeatOut) {
+    if (firstSeatOut) *firstSeatOut = -1;
+    if (flightIndex < 0 || flightIndex >= flightCount || count < 1) return BOOKING_FLIGHT_NOT_FOUND;
+    SeatMap* map = seatMapFor(flightIndex);
+    if (!map) return BOOKING_NO_MEMORY;
+    Passenger* group[SEAT_BLOCK_MAX];
+    if (count > SEAT_BLOCK_MAX) return BOOKING_SEAT_UNAVAILABLE;
+    for (int i = 0; i < count; ++i) {
+        group[i] = sharedPassengerAt(passengers[i]);
+        if (group[i]->flightIndex != flightIndex) return BOOKING_PASSENGER_NOT_FOUND;
+        for (int j = 0; j < i; ++j) {
+            if (group[j] == group[i]) return BOOKING_DUPLICATE_ID;
+        }
+    }
+    pthread_mutex_t* lock = ticketLockFor(flightIndex);
+    BookingStatus status = BOOKING_OK;
+    uint64_t lsn = 0;
+    pthread_mutex_lock(lock);
+    for (int i = 0; i < count && status == BOOKING_OK; ++i) {
+        if (group[i]->ticketStatus != TICKET_CONFIRMED) status = BOOKING_NOT_CONFIRMED;
+    }
+    int first = status == BOOKING_OK ? seatMapClaimAdjacent(map, cabin, count) : -1;
+    if (status == BOOKING_OK && first == -1) status = BOOKING_SEAT_UNAVAILABLE;
+    for (int i = 0; first != -1 && i < count; ++i) {
+        if (group[i]->seat >= 0) seatMapRelease(map, group[i]->seat);
+        group[i]->seat = first + i;
+        lsn = persistLogSeat(passengers[i]);
+    }
+    pthread_mutex_unlock(lock);
+    persistCommit(lsn);
+    if (firstSeatOut) *firstSeatOut = first;
+    return status;
+}
+
+void seatLabel(int flightIndex, int seat, char* out) {
+    SeatMap* map = seat >= 0 ? seatMapFor(flightIndex) : NULL;
+    if (map) seatMapLabel(map, seat, out);
+    else strcpy(out, "-");
+}
+
+int waitlistLength(int flightIndex) {
+    if (flightIndex < 0 || flightIndex >= flightCount || ensureWaitlists() != 0) return 0;
+    pthread_mutex_t* lock = ticketLockFor(flightIndex);
+    pthread_mutex_lock(lock);
+    int live = waitlistFor(flightIndex)->live;
+    pthread_mutex_unlock(lock);
+    return live;
+}
+
+void addFlight() {
+    Flight details;
+    memset(&details, 0, sizeof(details));
+    Flight* f = &details;
     printf("\n=== ADD NEW FLIGHT ===\n");
     printf("Flight Number: ");
     scanf("%s", f->flightNumber);
@@ -106,27 +686,152 @@ void addFlight() {
     scanf("%f", &f->price);
     printf("Priority (1-10): ");
     scanf("%d", &f->priority);
-    f->bookedSeats = 0;
-    strcpy(f->status, "scheduled");
-    flightCount++;
-    printf("Flight added successfully!\n");
+    BookingStatus status = createFlight(f, NULL);
+    if (status == BOOKING_DUPLICATE_ID) {
+        printf("Flight number already exists!\n");
+    } else if (status != BOOKING_OK) {
+        printf("Unable to add flight: %s\n", bookingStatusMessage(status));
+    } else {
+        printf("Flight added successfully!\n");
+    }
+}
+
+/* ---------- Reports (screen listings and exports share the column layouts) ---------- */
+
+static const ReportColumn FLIGHT_REPORT_COLUMNS[] = {
+    {"Flight", "flight", 10}, {"Route", "route", 12}, {"Departure", "departure", 12},
+    {"Arrival", "arrival", 12}, {"Price", "price", 10}, {"Available", "available", 15}
+};
+static const ReportColumn PASSENGER_REPORT_COLUMNS[] = {
+    {"ID", "id", 8}, {"Name", "name", 15}, {"Email", "email", 20}, {"Flight", "flight", 12}, {"Status", "status", 15}
+};
+static const ReportColumn CHECKIN_REPORT_COLUMNS[] = {
+    {"Passenger", "passenger", 15}, {"Flight", "flight", 15}, {"Priority", "priority", 10}
+};
+#define REPORT_COLUMN_COUNT(columns) ((int)(sizeof(columns) / sizeof((columns)[0])))
+
+static void reportFlightRow(ReportWriter* w, int i) {
+    const FlightInfo* f = flightAt(i);
+    reportText(w, f->flightNumber);
+    reportJoined(w, airportCode(f->origin), '-', airportCode(f->destination));
+    reportText(w, f->departureTime);
+    reportText(w, f->arrivalTime);
+    reportMoney(w, flightPrice(i));
+    reportInt(w, flightSeatsLeft(i));
+    reportEndRow(w);
+}
+
+static int writeFlightReport(FILE* out, ReportFormat format) {
+    ReportWriter w;
+    if (reportWriterOpen(&w, out, format, FLIGHT_REPORT_COLUMNS, REPORT_COLUMN_COUNT(FLIGHT_REPORT_COLUMNS)) != 0) return -1;
+    for (int i = 0; i < flightCount; i++) reportFlightRow(&w, i);
+    return reportWriterClose(&w);
+}
+
+static void reportPassengerRow(ReportWriter* w, int i) {
+    const Passenger* p = passengerAt(i);
+    reportText(w, p->id);
+    reportJoined(w, p->firstName, ' ', p->lastName);
+    reportText(w, p->email);
+    reportText(w, flightAt(p->flightIndex)->flightNumber);
+    reportText(w, passengerStatusName(p));
+    reportEndRow(w);
+}
+
+static int writePassengerReport(FILE* out, ReportFormat format) {
+    ReportWriter w;
+    if (reportWriterOpen(&w, out, format, PASSENGER_REPORT_COLUMNS, REPORT_COLUMN_COUNT(PASSENGER_REPORT_COLUMNS)) != 0) {
+        return -1;
+    }
+    for (int i = 0; i < passengerCount; i++) reportPassengerRow(&w, i);
+    return reportWriterClose(&w);
+}
+
+static int writeCheckInQueueReport(FILE* out, ReportFormat format);
+
+int writeReport(ReportKind kind, FILE* out, ReportFormat format) {
+    switch (kind) {
+        case REPORT_FLIGHTS: return writeFlightReport(out, format);
+        case REPORT_PASSENGERS: return writePassengerReport(out, format);
+        case REPORT_CHECKIN_QUEUE: return writeCheckInQueueReport(out, format);
+    }
+    return -1;
 }
 
 void displayFlights() {
     printf("\n=== ALL FLIGHTS ===\n");
-    printf("%-10s %-12s %-12s %-12s %-10s %-15s\n", "Flight", "Route", "Departure", "Arrival", "Price", "Available");
-    for (int i = 0; i < flightCount; i++) {
-        Flight* f = &flights[i];
-        printf("%-10s %-12s %-12s %-12s $%-9.2f %-15d\n", f->flightNumber, strcat(strcpy((char[32]){}, f->origin), strcat(strcpy((char[32]){}, "-"), f->destination)), f->departureTime, f->arrivalTime, f->price, f->capacity - f->bookedSeats);
+    if (writeFlightReport(stdout, REPORT_TEXT) != 0) printf("Unable to write the flight list.\n");
+}
+
+// Fare and availability filter; the scan only touches the price and seat columns
+void findAvailableFlights() {
+    float maxPrice;
+    int seats;
+    printf("\n=== FIND AVAILABLE FLIGHTS ===\n");
+    printf("Maximum price: $");
+    if (scanf("%f", &maxPrice) != 1) return;
+    printf("Seats needed: ");
+    if (scanf("%d", &seats) != 1) return;
+    if (seats < 1) seats = 1;
+    int* matches = (int*)malloc(sizeof(int) * (size_t)(flightCount > 0 ? flightCount : 1));
+    if (!matches) {
+        printf("Unable to allocate memory for the search.\n");
+        return;
+    }
+    double start = wallClockMs();
+    int found = flightColumnsFindAvailable(&flightColumns, flightCount, maxPrice, seats, matches, FLIGHT_SCAN_AUTO);
+    double elapsedMs = wallClockMs() - start;
+    int shown = found < ROUTE_PRINT_MAX_ROWS ? found : ROUTE_PRINT_MAX_ROWS;
+    ReportWriter w;
+    if (reportWriterOpen(&w, stdout, REPORT_TEXT, FLIGHT_REPORT_COLUMNS, REPORT_COLUMN_COUNT(FLIGHT_REPORT_COLUMNS)) == 0) {
+        for (int k = 0; k < shown; ++k) reportFlightRow(&w, matches[k]);
+        reportWriterClose(&w);
     }
+    if (shown < found) printf("... %d more flights\n", found - shown);
+    printf("%d of %d flights at or under $%.2f with %d seat(s) free (%s scan, %.3f ms)\n", found, flightCount, maxPrice,
+           seats, flightScanKernelName(flightScanDetectKernel()), elapsedMs);
+    free(matches);
 }
 
-void bookTicket() {
-    if (passengerCount >= MAX_PASSENGERS) {
-        printf("Passenger list full!\n");
+// Seat choice for a new booking: a seat label, or a preference for the frontmost matching free seat
+static void chooseSeat(int passengerIdx) {
+    char choice[NAME_LEN];
+    printf("Seat (e.g. 12A, window, aisle, business or any): ");
+    if (scanf("%31s", choice) != 1) return;
+    int flightIdx = passengerAt(passengerIdx)->flightIndex;
+    SeatMap* map = seatMapFor(flightIdx);
+    if (!map) {
+        printf("%s\n", bookingStatusMessage(BOOKING_NO_MEMORY));
         return;
     }
-    Passenger* p = &passengers[passengerCount];
+    SeatCabin cabin = SEAT_CABIN_ANY;
+    SeatPreference pref = SEAT_PREF_ANY;
+    int wanted = -1;
+    if (strcmp(choice, "window") == 0) pref = SEAT_PREF_WINDOW;
+    else if (strcmp(choice, "aisle") == 0) pref = SEAT_PREF_AISLE;
+    else if (strcmp(choice, "business") == 0) cabin = SEAT_CABIN_BUSINESS;
+    else if (strcmp(choice, "any") != 0 && (wanted = seatMapParse(map, choice)) == -1) wanted = -2;
+    int seat;
+    BookingStatus status = wanted == -2 ? BOOKING_SEAT_UNAVAILABLE : assignSeat(passengerIdx, wanted, cabin, pref, &seat);
+    if (status == BOOKING_SEAT_UNAVAILABLE && strcmp(choice, "any") != 0) {
+        printf("No %s seat is free; taking the first free seat.\n", choice);
+        status = assignSeat(passengerIdx, -1, SEAT_CABIN_ANY, SEAT_PREF_ANY, &seat);
+    }
+    if (status == BOOKING_SEAT_UNAVAILABLE) {
+        printf("Every seat is taken (the flight is overbooked); a seat is assigned at check-in if one frees up.\n");
+    } else if (status != BOOKING_OK) {
+        printf("%s\n", bookingStatusMessage(status));
+    } else {
+        char label[SEAT_LABEL_LEN];
+        seatMapLabel(map, seat, label);
+        printf("Seat %s assigned.\n", label);
+    }
+}
+
+void bookTicket() {
+    Passenger details;
+    memset(&details, 0, sizeof(details));
+    Passenger* p = &details;
     printf("\n=== BOOK TICKET ===\n");
     displayFlights();
     printf("Enter passenger details:\n");
@@ -140,61 +845,427 @@ void bookTicket() {
     scanf("%s", p->email);
     printf("Phone: ");
     scanf("%s", p->phone);
+    char flightNumber[FLIGHT_ID_LEN];
     printf("Flight Number: ");
-    scanf("%s", p->flightId);
-    for (int i = 0; i < flightCount; i++) {
-        Flight* f = &flights[i];
-        if (strcmp(f->flightNumber, p->flightId) == 0) {
-            if (f->bookedSeats < f->capacity) {
-                f->bookedSeats++;
-                strcpy(p->checkInStatus, "pending");
-                passengerCount++;
-                printf("Ticket booked successfully!\n");
-                return;
-            } else {
-                printf("Flight is full!\n");
-                return;
-            }
+    scanf("%7s", flightNumber);
+    int idx;
+    BookingStatus status = bookOrWaitlist(p, flightNumber, WAITLIST_DEFAULT_PRIORITY, &idx);
+    if (status == BOOKING_DUPLICATE_ID) {
+        printf("Passenger ID already exists!\n");
+    } else if (status == BOOKING_WAITLISTED) {
+        printf("Flight is full! Added to the waitlist (%d waiting).\n", waitlistLength(findFlightIndex(flightNumber)));
+    } else if (status != BOOKING_OK) {
+        printf("%s\n", bookingStatusMessage(status));
+    } else {
+        printf("Ticket booked successfully!\n");
+        chooseSeat(idx);
+    }
+}
+
+void showSeatMap() {
+    char flightNumber[FLIGHT_ID_LEN];
+    printf("\n=== SEAT MAP ===\n");
+    printf("Flight Number: ");
+    if (scanf("%7s", flightNumber) != 1) return;
+    int flightIdx = findFlightIndex(flightNumber);
+    if (flightIdx == -1) {
+        printf("Flight not found!\n");
+        return;
+    }
+    SeatMap* map = seatMapFor(flightIdx);
+    if (!map) {
+        printf("%s\n", bookingStatusMessage(BOOKING_NO_MEMORY));
+        return;
+    }
+    printf("%d of %d seats free (business %d, economy %d); '.' is taken\n", seatMapFreeSeats(map, SEAT_CABIN_ANY),
+           map->capacity, seatMapFreeSeats(map, SEAT_CABIN_BUSINESS), seatMapFreeSeats(map, SEAT_CABIN_ECONOMY));
+    char text[SEAT_ROW_TEXT_LEN];
+    for (int row = 0; row < map->rows; ++row) {
+        if (row == 0 && map->businessRows > 0) printf("-- Business --\n");
+        if (row == map->businessRows && map->businessRows > 0) printf("-- Economy --\n");
+        seatMapRowText(map, row, text);
+        printf("%4d  %s\n", row + 1, text);
+    }
+    int count;
+    printf("Seat a group together - number of passengers (0 to skip): ");
+    if (scanf("%d", &count) != 1 || count <= 0) return;
+    if (count > SEAT_BLOCK_MAX) {
+        printf("At most %d seats sit side by side.\n", SEAT_BLOCK_MAX);
+        return;
+    }
+    int group[SEAT_BLOCK_MAX];
+    for (int i = 0; i < count; ++i) {
+        char passengerId[NAME_LEN];
+        printf("Passenger ID %d: ", i + 1);
+        if (scanf("%31s", passengerId) != 1) return;
+        group[i] = findPassengerIndex(passengerId);
+        if (group[i] == -1) {
+            printf("Passenger not found!\n");
+            return;
+        }
+    }
+    int first;
+    BookingStatus status = assignAdjacentSeats(flightIdx, group, count, SEAT_CABIN_ANY, &first);
+    if (status == BOOKING_PASSENGER_NOT_FOUND) {
+        printf("Every passenger must be booked on %s.\n", flightNumber);
+    } else if (status == BOOKING_DUPLICATE_ID) {
+        printf("A passenger is listed twice.\n");
+    } else if (status == BOOKING_SEAT_UNAVAILABLE) {
+        printf("No %d free seats side by side.\n", count);
+    } else if (status != BOOKING_OK) {
+        printf("%s\n", bookingStatusMessage(status));
+    } else {
+        char from[SEAT_LABEL_LEN], to[SEAT_LABEL_LEN];
+        seatMapLabel(map, first, from);
+        seatMapLabel(map, first + count - 1, to);
+        printf("Seats %s to %s assigned.\n", from, to);
+    }
+}
+
+void cancelTicket() {
+    char passengerId[NAME_LEN];
+    printf("\n=== CANCEL TICKET ===\n");
+    printf("Passenger ID: ");
+    if (scanf("%31s", passengerId) != 1) return;
+    int promoted;
+    BookingStatus status = cancelBooking(passengerId, &promoted);
+    if (status != BOOKING_OK) {
+        printf("%s\n", bookingStatusMessage(status));
+        return;
+    }
+    printf("Booking cancelled.\n");
+    if (promoted != -1) {
+        const Passenger* p = passengerAt(promoted);
+        printf("Seat given to waitlisted passenger %s (%s %s).\n", p->id, p->firstName, p->lastName);
+    }
+}
+
+void manageWaitlist() {
+    char flightNumber[FLIGHT_ID_LEN];
+    printf("\n=== WAITLIST & OVERBOOKING ===\n");
+    printf("Flight Number: ");
+    if (scanf("%7s", flightNumber) != 1) return;
+    int flightIdx = findFlightIndex(flightNumber);
+    if (flightIdx == -1) {
+        printf("Flight not found!\n");
+        return;
+    }
+    Flight row;
+    flightRow(flightIdx, &row);
+    printf("Capacity %d, overbooking limit %d, booked %d, sellable seats left %d\n", row.capacity, row.overbook,
+           row.bookedSeats, flightSeatsLeft(flightIdx));
+    // Copy under the flight's lock, print after releasing it
+    WaitlistEntry* entries = NULL;
+    size_t count = 0;
+    if (ensureWaitlists() == 0) {
+        pthread_mutex_t* lock = ticketLockFor(flightIdx);
+        pthread_mutex_lock(lock);
+        Waitlist* list = waitlistFor(flightIdx);
+        entries = (WaitlistEntry*)malloc(sizeof(WaitlistEntry) * (list->count ? list->count : 1));
+        if (entries) {
+            count = list->count;
+            waitlistSnapshot(list, entries);
         }
+        pthread_mutex_unlock(lock);
+    }
+    int shown = 0;
+    for (size_t i = 0; i < count && shown < ROUTE_PRINT_MAX_ROWS; ++i) {
+        const Passenger* p = passengerAt(entries[i].passenger);
+        if (p->ticketStatus != TICKET_WAITLISTED) continue;
+        if (shown++ == 0) printf("%-4s %-8s %-8s %s\n", "#", "Priority", "ID", "Name");
+        printf("%-4d %-8d %-8s %s %s\n", shown, entries[i].priority, p->id, p->firstName, p->lastName);
     }
-    printf("Flight not found!\n");
+    free(entries);
+    int waiting = waitlistLength(flightIdx);
+    if (waiting == 0) printf("Nobody is waitlisted.\n");
+    else if (waiting > shown) printf("... %d waiting in total\n", waiting);
+    int limit;
+    printf("New overbooking limit (-1 to keep %d): ", row.overbook);
+    if (scanf("%d", &limit) != 1 || limit < 0) return;
+    int promoted = setOverbookLimit(flightIdx, limit);
+    if (promoted < 0) printf("Unable to change the overbooking limit.\n");
+    else printf("Overbooking limit set to %d; %d waitlisted booking(s) confirmed.\n", limit, promoted);
 }
 
 void displayPassengers() {
     printf("\n=== ALL PASSENGERS ===\n");
-    printf("%-8s %-15s %-20s %-12s %-15s\n", "ID", "Name", "Email", "Flight", "Status");
-    for (int i = 0; i < passengerCount; i++) {
-        Passenger* p = &passengers[i];
-        printf("%-8s %-15s %-20s %-12s %-15s\n", p->id, strcat(strcpy((char[32]){}, p->firstName), strcat(strcpy((char[32]){}, " "), p->lastName)), p->email, p->flightId, p->checkInStatus);
+    if (writePassengerReport(stdout, REPORT_TEXT) != 0) printf("Unable to write the passenger list.\n");
+}
+
+// Reads a filter word; "*" means any.
+static const char* readFilter(char* buf, const char* prompt) {
+    printf("%s ('*' for any): ", prompt);
+    if (scanf("%31s", buf) != 1) return NULL;
+    return strcmp(buf, "*") == 0 ? NULL : buf;
+}
+
+void searchRecords() {
+    int kind, sort, pageSize;
+    char origin[NAME_LEN], destination[NAME_LEN], flightNumber[NAME_LEN];
+    FlightQuery fq;
+    PassengerQuery pq;
+    flightQueryInit(&fq);
+    passengerQueryInit(&pq);
+    printf("\n=== SEARCH ===\n");
+    printf("Search (1=Flights, 2=Passengers): ");
+    if (scanf("%d", &kind) != 1) return;
+    if (kind == 1) {
+        fq.origin = readFilter(origin, "Origin");
+        fq.destination = readFilter(destination, "Destination");
+        printf("Maximum price (0 for any): $");
+        if (scanf("%f", &fq.maxPrice) != 1) return;
+        printf("Minimum seats left: ");
+        if (scanf("%d", &fq.minSeats) != 1) return;
+        printf("Sort by (1=Schedule, 2=Price, 3=Departure, 4=Seats left): ");
+        if (scanf("%d", &sort) != 1) return;
+        fq.sort = sort >= 1 && sort <= 4 ? (FlightSortKey)(sort - 1) : FLIGHT_SORT_SCHEDULE;
+        fq.descending = fq.sort == FLIGHT_SORT_SEATS_LEFT;
+    } else if (kind == 2) {
+        int status;
+        pq.flightNumber = readFilter(flightNumber, "Flight");
+        printf("Status (0=Any, 1=Pending, 2=Checked-in, 3=Waitlisted, 4=Cancelled): ");
+        if (scanf("%d", &status) != 1) return;
+        pq.checkInStatus = status == 1 ? CHECKIN_PENDING : status == 2 ? CHECKIN_DONE : -1;
+        pq.ticketStatus = status == 3 ? TICKET_WAITLISTED : status == 4 ? TICKET_CANCELLED : -1;
+        printf("Sort by (1=Booking, 2=Name, 3=ID): ");
+        if (scanf("%d", &sort) != 1) return;
+        pq.sort = sort >= 1 && sort <= 3 ? (PassengerSortKey)(sort - 1) : PASSENGER_SORT_BOOKING;
+    } else {
+        printf("Invalid choice!\n");
+        return;
     }
+    printf("Rows per page: ");
+    if (scanf("%d", &pageSize) != 1) return;
+    if (pageSize < 1) pageSize = 1;
+    if (pageSize > ROUTE_PRINT_MAX_ROWS) pageSize = ROUTE_PRINT_MAX_ROWS;
+
+    int rows[ROUTE_PRINT_MAX_ROWS];
+    QueryCursor cursor = QUERY_CURSOR_START;
+    int shown = 0;
+    for (;;) {
+        QueryPage page;
+        page.records = rows;
+        double start = wallClockMs();
+        int status = kind == 1 ? queryFlights(&fq, cursor, pageSize, &page) : queryPassengers(&pq, cursor, pageSize, &page);
+        double elapsedMs = wallClockMs() - start;
+        if (status != 0) {
+            printf("Unable to allocate memory for the search.\n");
+            return;
+        }
+        if (page.count == 0) {
+            printf("No matches.\n");
+            return;
+        }
+        ReportWriter w;
+        const ReportColumn* columns = kind == 1 ? FLIGHT_REPORT_COLUMNS : PASSENGER_REPORT_COLUMNS;
+        int columnCount = kind == 1 ? REPORT_COLUMN_COUNT(FLIGHT_REPORT_COLUMNS) : REPORT_COLUMN_COUNT(PASSENGER_REPORT_COLUMNS);
+        if (reportWriterOpen(&w, stdout, REPORT_TEXT, columns, columnCount) == 0) {
+            for (int i = 0; i < page.count; ++i) {
+                if (kind == 1) reportFlightRow(&w, rows[i]);
+                else reportPassengerRow(&w, rows[i]);
+            }
+            reportWriterClose(&w);
+        }
+        printf("Rows %d-%d of %d (%.3f ms)\n", shown + 1, shown + page.count, page.total, elapsedMs);
+        shown += page.count;
+        if (!page.hasMore) return;
+        int more;
+        printf("Next page? (1=Yes, 0=No): ");
+        if (scanf("%d", &more) != 1 || more != 1) return;
+        cursor = page.next;
+    }
+}
+
+void exportReport() {
+    int report, formatChoice;
+    char path[256];
+    printf("\n=== EXPORT REPORT ===\n");
+    printf("Report (1=Flights, 2=Passengers, 3=Check-in queue): ");
+    if (scanf("%d", &report) != 1) return;
+    printf("Format (1=CSV, 2=JSON, 3=Text): ");
+    if (scanf("%d", &formatChoice) != 1) return;
+    printf("Output file ('-' for screen): ");
+    if (scanf("%255s", path) != 1) return;
+    if (report < 1 || report > 3 || formatChoice < 1 || formatChoice > 3) {
+        printf("Invalid choice!\n");
+        return;
+    }
+    ReportFormat format = formatChoice == 1 ? REPORT_CSV : formatChoice == 2 ? REPORT_JSON : REPORT_TEXT;
+    int toScreen = strcmp(path, "-") == 0;
+    FILE* out = toScreen ? stdout : fopen(path, "wb");
+    if (!out) {
+        printf("Unable to open %s\n", path);
+        return;
+    }
+    double start = wallClockMs();
+    int status = writeReport((ReportKind)(report - 1), out, format);
+    double elapsedMs = wallClockMs() - start;
+    long bytes = toScreen ? -1 : ftell(out);
+    if (!toScreen && fclose(out) != 0) status = -1;
+    if (status != 0) {
+        printf("Export failed.\n");
+    } else if (!toScreen) {
+        printf("Wrote %ld bytes of %s to %s in %.2f ms\n", bytes, reportFormatName(format), path, elapsedMs);
+    }
+}
+
+/*
+ * Check-in service, safe to drive from several kiosk/counter threads:
+ * producers hand nodes to consumers through the lock-free ingress ring;
+ * consumers drain the ring into the priority heap under a short lock and
+ * pop the best entry. Released nodes are parked in a second ring, the
+ * free ring, and handed out again from there, so allocation is lock-free
+ * too; checkInPoolLock is only taken to carve a new node from the pool or
+ * to return one when the free ring is full. Nodes are owned by exactly
+ * one thread at a time (producer until pushed, consumer after popped), so
+ * recycling them cannot race with a reader.
+ */
+static void initCheckInService(void) {
+    if (mpmcRingInit(&checkInIngress, CHECKIN_RING_CAPACITY) != 0) return;
+    if (mpmcRingInit(&checkInFreeNodes, CHECKIN_RING_CAPACITY) != 0) {
+        mpmcRingFree(&checkInIngress);
+        return;
+    }
+    nodePoolReserve(&checkInNodePool, CHECKIN_POOL_PREALLOC); // best effort: nodes are also carved on demand
+    checkInServiceReady = 1;
+}
+
+static CheckInNode* allocCheckInNode(void) {
+    CheckInNode* node = (CheckInNode*)mpmcRingPop(&checkInFreeNodes);
+    if (node) {
+        atomic_fetch_sub_explicit(&checkInNodesParked, 1, memory_order_relaxed);
+        atomic_fetch_add_explicit(&checkInNodesRecycled, 1, memory_order_relaxed);
+        return node;
+    }
+    pthread_mutex_lock(&checkInPoolLock);
+    node = (CheckInNode*)nodePoolAlloc(&checkInNodePool);
+    pthread_mutex_unlock(&checkInPoolLock);
+    return node;
 }
 
-void enqueueCheckIn(Passenger passenger, int priority) {
-    CheckInNode* newNode = (CheckInNode*)malloc(sizeof(CheckInNode));
-    newNode->passenger = passenger;
+static void releaseCheckInNode(CheckInNode* node) {
+    if (mpmcRingPush(&checkInFreeNodes, node) == 0) {
+        atomic_fetch_add_explicit(&checkInNodesParked, 1, memory_order_relaxed);
+        return;
+    }
+    pthread_mutex_lock(&checkInPoolLock);
+    nodePoolRelease(&checkInNodePool, node);
+    pthread_mutex_unlock(&checkInPoolLock);
+}
+
+// Caller holds checkInHeapLock. Heap room is made before a node leaves the ring, so
+// if memory runs out the rest stay queued in the ring; returns -1 in that case.
+static int drainCheckInIngress(void) {
+    if (!checkInServiceReady) return 0;
+    while (checkInQueueReserve(&checkInQueue, checkInQueue.count + 1) == 0) {
+        CheckInNode* node = (CheckInNode*)mpmcRingPop(&checkInIngress);
+        if (!node) return 0;
+        checkInQueuePush(&checkInQueue, node);
+    }
+    return -1;
+}
+
+int enqueueCheckIn(int passengerIndex, int priority) {
+    pthread_once(&checkInServiceOnce, initCheckInService);
+    if (!checkInServiceReady) return -1;
+    CheckInNode* newNode = allocCheckInNode();
+    if (!newNode) return -1;
+    newNode->passengerIndex = passengerIndex;
     newNode->priority = priority;
-    time_t now = time(0);
-    strcpy(newNode->checkInTime, ctime(&now));
-    newNode->next= NULL;
-    if (!checkInFront) {
-        checkInFront = checkInRear = newNode;
-    } else if (priority == 1) {
-        newNode->next = checkInFront; 
-        checkInFront = newNode;
-    } else {
-        checkInRear->next = newNode;
-        checkInRear = newNode;
+    newNode->sequence = atomic_fetch_add_explicit(&checkInSequence, 1, memory_order_relaxed);
+    newNode->checkInTime = time(0);
+    if (mpmcRingPush(&checkInIngress, newNode) == 0) return 0;
+
+    // Ring full: consumers are behind, so move the backlog into the heap ourselves
+    pthread_mutex_lock(&checkInHeapLock);
+    int status = drainCheckInIngress();
+    if (status == 0) status = checkInQueuePush(&checkInQueue, newNode);
+    pthread_mutex_unlock(&checkInHeapLock);
+    if (status != 0) releaseCheckInNode(newNode);
+    return status;
+}
+
+int dequeueCheckIn(CheckInNode* out) {
+    pthread_once(&checkInServiceOnce, initCheckInService);
+    if (!checkInServiceReady) return -1;
+    pthread_mutex_lock(&checkInHeapLock);
+    drainCheckInIngress();
+    CheckInNode* node = checkInQueuePop(&checkInQueue);
+    pthread_mutex_unlock(&checkInHeapLock);
+    if (!node) return -1;
+    *out = *node;
+    releaseCheckInNode(node);
+    return 0;
+}
+
+static void displayCheckInPoolStats() {
+    pthread_mutex_lock(&checkInPoolLock);
+    const NodePool* pool = &checkInNodePool;
+    // The pool counts parked nodes as in use and never sees allocations the free ring served
+    size_t parked = atomic_load_explicit(&checkInNodesParked, memory_order_relaxed);
+    size_t recycled = atomic_load_explicit(&checkInNodesRecycled, memory_order_relaxed);
+    size_t hits = pool->hits + recycled;
+    size_t requests = hits + pool->misses;
+    printf("Node pool: %zu in use, %zu free, %zu slab slots, hits %zu (%zu lock-free), misses %zu (%.1f%% hit rate)\n",
+           pool->inUse > parked ? pool->inUse - parked : 0, parked, recordArenaCapacity(&pool->slabs), hits, recycled,
+           pool->misses, requests ? 100.0 * (double)hits / (double)requests : 100.0);
+    pthread_mutex_unlock(&checkInPoolLock);
+}
+
+static const char* priorityLabel(int priority, char* buf, size_t len) {
+    if (priority == 1) return "VIP";
+    if (priority == 2) return "Regular";
+    snprintf(buf, len, "Tier %d", priority);
+    return buf;
+}
+
+static int writeCheckInQueueReport(FILE* out, ReportFormat format) {
+    ReportWriter w;
+    if (reportWriterOpen(&w, out, format, CHECKIN_REPORT_COLUMNS, REPORT_COLUMN_COUNT(CHECKIN_REPORT_COLUMNS)) != 0) return -1;
+    pthread_once(&checkInServiceOnce, initCheckInService);
+    pthread_mutex_lock(&checkInHeapLock);
+    drainCheckInIngress();
+    int status = 0;
+    if (checkInQueue.count > 0) {
+        // Show entries in the order they will be served
+        CheckInHeapEntry* ordered = (CheckInHeapEntry*)malloc(sizeof(CheckInHeapEntry) * checkInQueue.count);
+        if (!ordered) {
+            status = -1;
+        } else {
+            checkInQueueSnapshot(&checkInQueue, ordered);
+            char tier[16];
+            for (size_t i = 0; i < checkInQueue.count; i++) {
+                const CheckInNode* node = ordered[i].node;
+                const Passenger* p = passengerAt(node->passengerIndex);
+                reportJoined(&w, p->firstName, ' ', p->lastName);
+                reportText(&w, flightAt(p->flightIndex)->flightNumber);
+                reportText(&w, priorityLabel(node->priority, tier, sizeof(tier)));
+                reportEndRow(&w);
+            }
+            free(ordered);
+        }
     }
+    pthread_mutex_unlock(&checkInHeapLock);
+    return reportWriterClose(&w) != 0 ? -1 : status;
 }
 
 void displayCheckInQueue() {
     printf("\n=== CHECK-IN QUEUE ===\n");
-    printf("%-15s %-15s %-10s\n", "Passenger", "Flight", "Priority");
-    CheckInNode* curr = checkInFront;
-    while (curr) {
-        printf("%-15s %-15s %-10s\n", strcat(strcpy((char[32]){}, curr->passenger.firstName), strcat(strcpy((char[32]){}, " "), curr->passenger.lastName)), curr->passenger.flightId, curr->priority == 1 ? "VIP" : "Regular");
-        curr = curr->next;
+    if (writeCheckInQueueReport(stdout, REPORT_TEXT) != 0) printf("Unable to write the check-in queue.\n");
+    displayCheckInPoolStats();
+}
+
+BookingStatus checkInBooking(int passengerIndex, int priority) {
+    if (passengerIndex < 0 || passengerIndex >= passengerCount) return BOOKING_PASSENGER_NOT_FOUND;
+    const Passenger* p = sharedPassengerAt(passengerIndex);
+    if (p->ticketStatus != TICKET_CONFIRMED) return BOOKING_NOT_CONFIRMED;
+    // Tickets without a seat (promoted from the waitlist, booked in batch) get the first free one
+    if (p->seat < 0) {
+        BookingStatus seated = assignSeat(passengerIndex, -1, SEAT_CABIN_ANY, SEAT_PREF_ANY, NULL);
+        if (seated != BOOKING_OK) return seated;
     }
+    if (priority < 1) priority = 1;
+    return enqueueCheckIn(passengerIndex, priority) == 0 ? BOOKING_OK : BOOKING_NO_MEMORY;
 }
 
 void checkInPassenger() {
@@ -203,40 +1274,77 @@ void checkInPassenger() {
     printf("\n=== CHECK-IN PASSENGER ===\n");
     printf("Passenger ID: ");
     scanf("%s", passengerId);
-    printf("Priority (1=VIP, 2=Regular): ");
+    printf("Priority (1=VIP, 2=Regular, 3+=lower tiers): ");
     scanf("%d", &priority);
-    for (int i = 0; i < passengerCount; i++) {
-        if (strcmp(passengers[i].id, passengerId) == 0) {
-            enqueueCheckIn(passengers[i], priority);
-            printf("Passenger added to check-in queue!\n");
-            return;
-        }
+    int idx = findPassengerIndex(passengerId);
+    if (idx == -1) {
+        printf("Passenger not found!\n");
+        return;
+    }
+    BookingStatus status = checkInBooking(idx, priority);
+    switch (status) {
+        case BOOKING_OK: printf("Passenger added to check-in queue!\n"); break;
+        case BOOKING_NOT_CONFIRMED:
+            printf("Only confirmed tickets can check in (this one is %s).\n", passengerStatusName(passengerAt(idx)));
+            break;
+        case BOOKING_SEAT_UNAVAILABLE: printf("No seat is free on this flight (it is overbooked); check-in refused.\n"); break;
+        case BOOKING_NO_MEMORY: printf("Unable to queue passenger (out of memory).\n"); break;
+        default: printf("%s\n", bookingStatusMessage(status)); break;
     }
-    printf("Passenger not found!\n");
 }
 
 void processCheckInQueue() {
     printf("\n=== PROCESSING CHECK-IN QUEUE ===\n");
-    if (!checkInFront) {
+    CheckInNode next;
+    if (dequeueCheckIn(&next) != 0) {
         printf("No passengers in queue.\n");
         return;
     }
-    CheckInNode* temp = checkInFront;
-    Passenger p = temp->passenger;
-    printf("Processing check-in for: %s %s\n", p.firstName, p.lastName);
-    printf("Flight: %s\n", p.flightId);
-    for (int i = 0; i < passengerCount; i++) {
-        if (strcmp(passengers[i].id, p.id) == 0) {
-            strcpy(passengers[i].checkInStatus, "checked-in");
-            break;
-        }
+    Passenger* p = passengerAt(next.passengerIndex);
+    if (p->ticketStatus != TICKET_CONFIRMED) {
+        printf("Skipping %s %s: ticket is %s now.\n", p->firstName, p->lastName, passengerStatusName(p));
+        return;
     }
-    checkInFront = checkInFront->next;
-    if (!checkInFront) checkInRear = NULL;
-    free(temp);
+    printf("Processing check-in for: %s %s\n", p->firstName, p->lastName);
+    char label[SEAT_LABEL_LEN];
+    seatLabel(p->flightIndex, p->seat, label);
+    printf("Flight: %s, seat %s\n", flightAt(p->flightIndex)->flightNumber, label);
+    p->checkInStatus = CHECKIN_DONE;
+    persistCommit(persistLogCheckIn(next.passengerIndex));
     printf("Check-in completed successfully!\n");
 }
 
+void resetStores(void) {
+    pthread_once(&checkInServiceOnce, initCheckInService);
+    pthread_mutex_lock(&checkInHeapLock);
+    CheckInNode* node;
+    drainCheckInIngress();
+    while ((node = checkInQueuePop(&checkInQueue)) != NULL) releaseCheckInNode(node);
+    pthread_mutex_unlock(&checkInHeapLock);
+
+    pthread_rwlock_wrlock(&passengerRegistryLock);
+    hashIndexFree(&flightIndex);
+    hashIndexFree(&passengerIndex);
+    hashIndexFree(&airportIndex);
+    secondaryIndexFree(&passengersByFlight);
+    secondaryIndexFree(&flightsByOrigin);
+    for (size_t f = 0; f < recordArenaCapacity(&waitlistStore); ++f) waitlistFree(waitlistFor((int)f));
+    recordArenaFree(&waitlistStore);
+    atomic_store(&waitlistsBuilt, 0);
+    for (int f = 0; f < atomic_load(&flightsSeatMapped); ++f) seatMapFree((SeatMap*)recordArenaAt(&seatMapStore, (size_t)f));
+    recordArenaFree(&seatMapStore);
+    atomic_store(&flightsSeatMapped, 0);
+    recordArenaFree(&flightStore);
+    recordArenaFree(&airportStore);
+    flightColumnsFree(&flightColumns);
+    recordArenaFree(&passengerStore);
+    flightCount = 0;
+    airportCount = 0;
+    passengerCount = 0;
+    persistUnmapSnapshot();
+    pthread_rwlock_unlock(&passengerRegistryLock);
+}
+
 
 
 void mainMenu() {
@@ -253,6 +1361,13 @@ void mainMenu() {
     printf("| 6. Display All Passengers           |\n");
     printf("| 7. Display Check-in Queue           |\n");
     printf("| 8. Analyze Route Network            |\n");
+    printf("| 9. Plan Journey (schedule)          |\n");
+    printf("| 10. Find Available Flights          |\n");
+    printf("| 11. Export Report (CSV/JSON)        |\n");
+    printf("| 12. Search Flights/Passengers       |\n");
+    printf("| 13. Cancel Ticket                   |\n");
+    printf("| 14. Waitlist & Overbooking          |\n");
+    printf("| 15. Seat Map                        |\n");
     printf("| 0. Exit                             |\n");
     printf("+--------------------------------------+\n");
         printf("Enter your choice: ");
@@ -266,12 +1381,21 @@ void mainMenu() {
             case 6: displayPassengers(); break;
             case 7: displayCheckInQueue(); break;
             case 8: analyzeRouteNetwork(); break;
+            case 9: planJourney(); break;
+            case 10: findAvailableFlights(); break;
+            case 11: exportReport(); break;
+            case 12: searchRecords(); break;
+            case 13: cancelTicket(); break;
+            case 14: manageWaitlist(); break;
+            case 15: showSeatMap(); break;
             case 0:
+                persistClose();
                 printf("Thank you for using Airline Management System!\n");
                 exit(0);
             default:
                 printf("Invalid choice! Please try again.\n");
         }
+        persistSync();
     }
 }
 
@@ -279,129 +1403,182 @@ void mainMenu() {
 /* Multiple-scenario helpers removed — we use a single built-in demo dataset now. */
 void analyzeRouteNetwork() {
     printf("\n=== ROUTE NETWORK ANALYSIS ===\n");
-    printf("Using built-in demo dataset: Regional shuttle circuit (small)\n");
-
-    RouteGraph graph;
-    graph.vertexCount = 0;
-    graph.directed = 0; /* demo uses undirected Indian network */
-    graph.adjMatrix = NULL;
-
-    int airportCount = (int)(sizeof(SAMPLE_SMALL_APSP_NAMES) / sizeof(SAMPLE_SMALL_APSP_NAMES[0]));
-    int acceptedRoutes = 0;
-    char airportNames[MAX_ANALYSIS_AIRPORTS][NAME_LEN];
+    printf("Choose route data:\n");
+    printf("  1. Built-in demo (6 Indian airports)\n");
+    printf("  2. Current flight inventory\n");
+    printf("  3. Route file (SRC,DST[,WEIGHT] or OpenFlights routes.dat)\n");
+    printf("Enter choice: ");
+    int sourceChoice = 0;
+    if (scanf("%d", &sourceChoice) != 1) sourceChoice = 1;
 
-    graph = createRouteGraph(airportCount, 0);
-    if (!graph.adjMatrix) {
-        printf("Unable to allocate memory for demo dataset.\n");
+    /* Flights and route files are one-way; the demo lists each city pair once */
+    RouteNetwork net;
+    routeNetworkInit(&net, sourceChoice == 2 || sourceChoice == 3);
+    double startLoad = wallClockMs();
+    int loaded;
+    if (sourceChoice == 2) {
+        printf("Using current flight inventory (%d flights, weights = block minutes)\n", flightCount);
+        loaded = routeNetworkLoadFlights(&net);
+    } else if (sourceChoice == 3) {
+        char path[256];
+        printf("Enter route file path: ");
+        scanf("%255s", path);
+        loaded = routeNetworkLoadFile(&net, path);
+        if (loaded >= 0) {
+            printf("Airport coordinates file for A* routing (CODE,LAT,LON or OpenFlights airports.dat; - to skip): ");
+            scanf("%255s", path);
+            if (strcmp(path, "-") != 0 && routeNetworkLoadAirportsFile(&net, path) < 0) {
+                printf("Unable to read coordinates file; routing without them.\n");
+            }
+        }
+    } else {
+        printf("Using built-in demo dataset: Regional shuttle circuit (small)\n");
+        loaded = loadSampleNetwork(&net);
+    }
+    double loadMs = wallClockMs() - startLoad;
+    if (loaded < 0) {
+        printf("Unable to load route data.\n");
+        routeNetworkFree(&net);
         return;
     }
-    for (int i = 0; i < airportCount; ++i) {
-        strncpy(airportNames[i], SAMPLE_SMALL_APSP_NAMES[i], NAME_LEN - 1);
-        airportNames[i][NAME_LEN - 1] = '\0';
+    int airportCount = net.airportCount;
+    printf("Loaded %d airports and %d routes in %.1f ms", airportCount, net.routeCount, loadMs);
+    if (net.skippedLines) printf(" (%ld lines skipped)", net.skippedLines);
+    printf("\n");
+    if (net.coordinateCount) printf("Coordinates known for %d of %d airports\n", net.coordinateCount, airportCount);
+    if (airportCount == 0) {
+        printf("No routes to analyze.\n");
+        routeNetworkFree(&net);
+        return;
     }
-    for (int i = airportCount; i < MAX_ANALYSIS_AIRPORTS; ++i) airportNames[i][0] = '\0';
 
-    int edgeCount = (int)(sizeof(SAMPLE_SMALL_APSP_EDGES) / sizeof(SAMPLE_SMALL_APSP_EDGES[0]));
-    for (int i = 0; i < edgeCount; ++i) {
-        int s = findAirportIndex(airportNames, airportCount, SAMPLE_SMALL_APSP_EDGES[i].src);
-        int d = findAirportIndex(airportNames, airportCount, SAMPLE_SMALL_APSP_EDGES[i].dest);
-        if (s == -1 || d == -1) continue;
-        double w = SAMPLE_SMALL_APSP_EDGES[i].weight;
-        if (graph.adjMatrix[s][d] > w) graph.adjMatrix[s][d] = w;
-        if (!graph.directed && graph.adjMatrix[d][s] > w) graph.adjMatrix[d][s] = w;
-        ++acceptedRoutes;
+    /* Sparse adjacency for heap-based searches; the dense matrix only while it stays small */
+    CsrGraph csr;
+    if (routeNetworkBuildCsr(&net, &csr) != 0) {
+        csr.vertexCount = 0;
+        csr.rowStart = NULL;
     }
-    printf("Airports: %d  Routes: %d  Directed: %s\n", airportCount, acceptedRoutes, graph.directed ? "Yes" : "No");
-
-    /* Build undirected edge list (needed if user chooses Kruskal) and APSP buffer */
-    RouteEdge* undirectedEdges = NULL;
-    int undirectedEdgeCount = buildUndirectedEdgeList(&graph, &undirectedEdges);
-    double** floydDist = allocateMatrix(airportCount, INF_WEIGHT);
+    RouteGraph graph = { 0, net.directed, NULL };
+    if (airportCount <= ROUTE_MATRIX_MAX_AIRPORTS && routeNetworkBuildMatrix(&net, &graph, 0) != 0) {
+        printf("Unable to allocate the route matrix.\n");
+    }
+    printf("Airports: %d  Routes: %d  Directed: %s\n", airportCount, net.routeCount, net.directed ? "Yes" : "No");
 
-    printGraphDiagram(&graph, airportNames);
+    printGraphDiagram(&graph, &net);
 
     /* --- Minimum Spanning Tree: let user choose which algorithm to run --- */
     printf("\n--- Minimum Spanning Tree (MST) ---\n");
     printf("Choose MST algorithm to run:\n");
-    printf("  1. Prim's Algorithm\n");
+    printf("  1. Prim's Algorithm (route matrix)\n");
     printf("  2. Kruskal's Algorithm\n");
     printf("  3. Skip MST\n");
+    printf("  4. Prim's Algorithm (indexed heap, sparse routes)\n");
+    printf("  5. Boruvka's Algorithm (parallel, large networks)\n");
     printf("Enter choice: ");
     int mstChoice = 0;
     if (scanf("%d", &mstChoice) != 1) mstChoice = 3;
 
-    if (mstChoice == 1) {
+    if (mstChoice == 1 && !graph.adjMatrix) {
+        printf("Prim's algorithm needs the route matrix, which is only built for up to %d airports; try option 4.\n",
+               ROUTE_MATRIX_MAX_AIRPORTS);
+    } else if (mstChoice == 1) {
+        /* Prim grows along matrix rows, so a one-way network is viewed as two-way here */
+        RouteGraph primGraph = graph;
+        if (net.directed && routeNetworkBuildMatrix(&net, &primGraph, 1) != 0) primGraph.adjMatrix = NULL;
         if (airportCount < 2) {
             printf("Not enough vertices to run Prim's algorithm.\n");
+        } else if (!primGraph.adjMatrix) {
+            printf("Unable to allocate memory for Prim's algorithm.\n");
         } else {
             MSTResultEdge* primEdges = (MSTResultEdge*)malloc(sizeof(MSTResultEdge) * (airportCount - 1));
             int primEdgeCount = 0;
-            clock_t startPrim = clock();
-            double primWeight = primMST(&graph, primEdges, &primEdgeCount);
-            double primMs = ((double)(clock() - startPrim) * 1000.0) / CLOCKS_PER_SEC;
-            if (primEdgeCount == airportCount - 1 && primWeight < INF_WEIGHT / 2.0) {
-                printf("Prim's Algorithm succeeded (Time: %.3f ms, Total weight: %.2f)\n", primMs, primWeight);
-                for (int i = 0; i < primEdgeCount; ++i) {
-                    printf("  %s -- %s : %.2f\n", airportNames[primEdges[i].src], airportNames[primEdges[i].dest], primEdges[i].weight);
-                }
-            } else {
-                printf("Prim's Algorithm could not produce an MST (graph disconnected).\n");
-            }
+            double primWeight = -1.0;
+            double startPrim = wallClockMs();
+            if (primEdges) primWeight = primMST(&primGraph, primEdges, &primEdgeCount);
+            printMstOutcome("Prim's Algorithm", primWeight, primEdges, primEdgeCount, wallClockMs() - startPrim, &net);
             free(primEdges);
         }
-    } else if (mstChoice == 2) {
-        if (undirectedEdgeCount < airportCount - 1) {
-            printf("Not enough undirected edges to run Kruskal's algorithm.\n");
-        } else {
-            MSTResultEdge* kruskalEdges = (MSTResultEdge*)malloc(sizeof(MSTResultEdge) * (airportCount - 1));
-            int kruskalEdgeCount = 0;
-            clock_t startKruskal = clock();
-            double kruskalWeight = kruskalMST(&graph, undirectedEdges, undirectedEdgeCount, kruskalEdges, &kruskalEdgeCount);
-            double kruskalMs = ((double)(clock() - startKruskal) * 1000.0) / CLOCKS_PER_SEC;
-            if (kruskalEdgeCount == airportCount - 1 && kruskalWeight < INF_WEIGHT / 2.0) {
-                printf("Kruskal's Algorithm succeeded (Time: %.3f ms, Total weight: %.2f)\n", kruskalMs, kruskalWeight);
-                for (int i = 0; i < kruskalEdgeCount; ++i) {
-                    printf("  %s -- %s : %.2f\n", airportNames[kruskalEdges[i].src], airportNames[kruskalEdges[i].dest], kruskalEdges[i].weight);
-                }
-            } else {
-                printf("Kruskal's Algorithm could not produce an MST (graph disconnected).\n");
-            }
-            free(kruskalEdges);
+        if (primGraph.adjMatrix != graph.adjMatrix) freeRouteGraph(&primGraph);
+    } else if (mstChoice == 4) {
+        /* Heap Prim walks adjacency lists, which must hold every route both ways */
+        CsrGraph undirected;
+        int haveUndirected = net.directed ? buildCsrGraph(&undirected, airportCount, net.routes, net.routeCount, 0) == 0
+                                          : csr.rowStart != NULL;
+        MSTResultEdge* primEdges = (MSTResultEdge*)malloc(sizeof(MSTResultEdge) * airportCount);
+        double primWeight = -1.0;
+        int primEdgeCount = 0;
+        double startPrim = wallClockMs();
+        if (haveUndirected && primEdges) {
+            primWeight = primForestCsr(net.directed ? &undirected : &csr, primEdges, &primEdgeCount);
         }
+        printMstOutcome("Prim's Algorithm (indexed heap)", primWeight, primEdges, primEdgeCount,
+                        wallClockMs() - startPrim, &net);
+        if (net.directed && haveUndirected) freeCsrGraph(&undirected);
+        free(primEdges);
+    } else if (mstChoice == 2 || mstChoice == 5) {
+        /* Straight off the route list, so no matrix and no airport limit; sorting reorders the copy */
+        RouteEdge* kruskalInput = NULL;
+        if (mstChoice == 2) kruskalInput = (RouteEdge*)malloc(sizeof(RouteEdge) * (net.routeCount > 0 ? net.routeCount : 1));
+        MSTResultEdge* forestEdges = (MSTResultEdge*)malloc(sizeof(MSTResultEdge) * airportCount);
+        WorkPool pool;
+        int havePool = workPoolInit(&pool, 0) == 0;
+        double forestWeight = -1.0;
+        int forestEdgeCount = 0;
+        double startForest = wallClockMs();
+        if (mstChoice == 2 && kruskalInput && forestEdges) {
+            memcpy(kruskalInput, net.routes, sizeof(RouteEdge) * net.routeCount);
+            forestWeight = filterKruskalForest(airportCount, kruskalInput, net.routeCount, forestEdges, &forestEdgeCount,
+                                               havePool ? &pool : NULL);
+        } else if (mstChoice == 5 && forestEdges) {
+            forestWeight = boruvkaForest(airportCount, net.routes, net.routeCount, forestEdges, &forestEdgeCount,
+                                         havePool ? &pool : NULL);
+        }
+        printMstOutcome(mstChoice == 2 ? "Kruskal's Algorithm" : "Boruvka's Algorithm", forestWeight, forestEdges,
+                        forestEdgeCount, wallClockMs() - startForest, &net);
+        if (mstChoice == 5 && havePool) printf("Boruvka ran on %d worker thread(s)\n", pool.threadCount);
+        if (havePool) workPoolDestroy(&pool);
+        free(kruskalInput);
+        free(forestEdges);
     } else {
         printf("Skipping MST analysis as requested.\n");
     }
 
-    /* --- Shortest paths: let user choose Floyd-Warshall (all-pairs) or single-source Dijkstra --- */
+    /* --- Shortest paths: all-pairs (strategy picked by cost model) or single-source Dijkstra --- */
     printf("\n--- Shortest Paths ---\n");
     printf("Choose algorithm:\n");
-    printf("  1. Floyd-Warshall (all-pairs)\n");
+    printf("  1. All-pairs (blocked Floyd-Warshall or parallel Dijkstra, whichever is cheaper)\n");
     printf("  2. Single-source Dijkstra\n");
     printf("  3. Skip shortest-paths\n");
+    printf("  4. Best itinerary between two airports\n");
     printf("Enter choice: ");
     int spChoice = 0;
     if (scanf("%d", &spChoice) != 1) spChoice = 3;
 
-    if (spChoice == 1) {
-        if (!floydDist) {
-            printf("Unable to allocate memory for Floyd-Warshall.\n");
+    DistanceMatrix apsp;
+    int haveApsp = 0;
+    if (spChoice == 1 && !graph.adjMatrix) {
+        printf("The all-pairs table is only built for up to %d airports.\n", ROUTE_MATRIX_MAX_AIRPORTS);
+    } else if (spChoice == 1) {
+        WorkPool pool;
+        int havePool = workPoolInit(&pool, 0) == 0;
+        double startApsp = wallClockMs();
+        int strategy = apspAllPairs(&apsp, &graph, csr.rowStart ? &csr : NULL, havePool ? &pool : NULL);
+        double apspMs = wallClockMs() - startApsp;
+        if (strategy >= 0) {
+            printf("All-pairs shortest paths completed (%s, %d thread(s), Time: %.3f ms)\n",
+                   apspStrategyName((ApspStrategy)strategy),
+                   strategy == APSP_STRATEGY_PARALLEL_DIJKSTRA ? pool.threadCount : 1, apspMs);
+            printDistanceMatrix(&apsp, &net);
+            haveApsp = 1;
         } else {
-            clock_t startFloyd = clock();
-            int floydStatus = floydWarshallAllPairs(&graph, floydDist);
-            double floydMs = ((double)(clock() - startFloyd) * 1000.0) / CLOCKS_PER_SEC;
-            if (floydStatus == 0) {
-                printf("Floyd-Warshall completed (Time: %.3f ms)\n", floydMs);
-                printf("\nShortest path matrix (Floyd-Warshall):\n");
-                printDistanceMatrix(floydDist, airportCount, airportNames);
-            } else {
-                printf("Floyd-Warshall encountered an error.\n");
-            }
+            printf("Unable to allocate memory for all-pairs shortest paths.\n");
         }
+        if (havePool) workPoolDestroy(&pool);
     } else if (spChoice == 2) {
         printf("Enter source airport code: ");
-        char srcName[NAME_LEN];
+        char srcName[AIRPORT_CODE_LEN];
         scanf("%31s", srcName);
-        int srcIndex = findAirportIndex(airportNames, airportCount, srcName);
+        int srcIndex = routeNetworkFind(&net, srcName);
         if (srcIndex == -1) {
             printf("Unknown airport code.\n");
         } else {
@@ -409,91 +1586,130 @@ void analyzeRouteNetwork() {
             if (!dist) {
                 printf("Allocation failed for Dijkstra.\n");
             } else {
-                clock_t startD = clock();
-                dijkstra(&graph, srcIndex, dist);
-                double dMs = ((double)(clock() - startD) * 1000.0) / CLOCKS_PER_SEC;
-                printf("Dijkstra from %s completed (Time: %.3f ms)\n", airportNames[srcIndex], dMs);
-                printf("%-12s %-12s\n", "Airport", "Distance");
-                for (int i = 0; i < airportCount; ++i) {
-                    if (dist[i] >= INF_WEIGHT / 2.0) {
-                        printf("%-12s %-12s\n", airportNames[i], "INF");
-                    } else {
-                        printf("%-12s %-12.2f\n", airportNames[i], dist[i]);
-                    }
+                double startD = wallClockMs();
+                int engine = shortestPathsFrom(&graph, csr.rowStart ? &csr : NULL, srcIndex, dist);
+                double dMs = wallClockMs() - startD;
+                if (engine < 0) {
+                    printf("Dijkstra failed (out of memory).\n");
+                } else {
+                    printf("Dijkstra from %s completed (%s, Time: %.3f ms)\n", srcName,
+                           engine == 1 ? "dense matrix scan" : "CSR + indexed heap", dMs);
+                    printDistanceList(dist, &net);
                 }
             }
             free(dist);
         }
+    } else if (spChoice == 4) {
+        char fromCode[AIRPORT_CODE_LEN], toCode[AIRPORT_CODE_LEN];
+        printf("Enter origin airport code: ");
+        scanf("%31s", fromCode);
+        printf("Enter destination airport code: ");
+        scanf("%31s", toCode);
+        printItinerary(&net, csr.rowStart ? &csr : NULL, routeNetworkFind(&net, fromCode), routeNetworkFind(&net, toCode));
     } else {
         printf("Skipping shortest-paths as requested.\n");
     }
 
+    /* The all-pairs table, if one was computed, is handed over and kept current */
+    applyRouteChanges(&net, haveApsp ? &apsp : NULL);
+
     freeRouteGraph(&graph);
-    if (undirectedEdges) free(undirectedEdges);
-    freeMatrix(floydDist, airportCount);
+    freeCsrGraph(&csr);
+    routeNetworkFree(&net);
     printf("\nRoute analysis complete.\n");
 }
 
-static RouteGraph createRouteGraph(int vertices, int directed) {
-    RouteGraph graph;
-    graph.vertexCount = vertices;
-    graph.directed = directed ? 1 : 0;
-    graph.adjMatrix = allocateMatrix(vertices, INF_WEIGHT);
-    if (graph.adjMatrix) {
-        for (int i = 0; i < vertices; ++i) {
-            graph.adjMatrix[i][i] = 0.0;
-        }
+void planJourney() {
+    printf("\n=== PLAN JOURNEY ===\n");
+    char fromCode[NAME_LEN], toCode[NAME_LEN], after[8];
+    printf("Enter origin: ");
+    scanf("%31s", fromCode);
+    printf("Enter destination: ");
+    scanf("%31s", toCode);
+    printf("Earliest departure (HH:MM): ");
+    scanf("%7s", after);
+    int departAfter = flightClockMinutes(after);
+    if (departAfter < 0) {
+        printf("Invalid time, expected HH:MM.\n");
+        return;
     }
-    return graph;
-}
 
-static void freeRouteGraph(RouteGraph* graph) {
-    if (!graph || !graph->adjMatrix) return;
-    freeMatrix(graph->adjMatrix, graph->vertexCount);
-    graph->adjMatrix = NULL;
-}
-
-static double** allocateMatrix(int n, double initial) {
-    if (n <= 0) return NULL;
-    double** matrix = (double**)malloc(sizeof(double*) * n);
-    if (!matrix) return NULL;
-    for (int i = 0; i < n; ++i) {
-        matrix[i] = (double*)malloc(sizeof(double) * n);
-        if (!matrix[i]) {
-            for (int k = 0; k < i; ++k) {
-                free(matrix[k]);
-            }
-            free(matrix);
-            return NULL;
-        }
-        for (int j = 0; j < n; ++j) {
-            matrix[i][j] = initial;
+    Timetable tt;
+    timetableInit(&tt, JOURNEY_MIN_CONNECTION_MINUTES);
+    if (timetableBuildFromFlights(&tt) != 0) {
+        printf("Unable to allocate memory for the timetable.\n");
+        timetableFree(&tt);
+        return;
+    }
+    int from = routeNetworkFind(&tt.airports, fromCode);
+    int to = routeNetworkFind(&tt.airports, toCode);
+    if (from == -1 || to == -1) {
+        printf("No scheduled flights %s %s.\n", from == -1 ? "from" : "to", from == -1 ? fromCode : toCode);
+        timetableFree(&tt);
+        return;
+    }
+    Journey journey;
+    journeyInit(&journey);
+    double start = wallClockMs();
+    int status = timetableEarliestArrival(&tt, from, to, departAfter, &journey);
+    double elapsedMs = wallClockMs() - start;
+    if (status == 1) {
+        printf("No connection from %s to %s within %d days.\n", fromCode, toCode, JOURNEY_HORIZON_DAYS);
+    } else if (status != 0) {
+        printf("Unable to allocate memory for the journey.\n");
+    } else if (journey.legCount == 0) {
+        printf("Origin and destination are the same.\n");
+    } else {
+        int arrival = journey.legs[journey.legCount - 1].arrival;
+        printf("Earliest arrival %02d:%02d%s, %d flight(s), min connection %d min (%d connections scanned, %.3f ms)\n",
+               (arrival % MINUTES_PER_DAY) / 60, arrival % 60, arrival >= MINUTES_PER_DAY ? " (+1 day)" : "",
+               journey.legCount, tt.minConnectionMinutes, journey.scanned, elapsedMs);
+        printf("%-10s %-10s %-10s %-8s %-8s\n", "Flight", "From", "To", "Dep", "Arr");
+        for (int i = 0; i < journey.legCount; ++i) {
+            const JourneyLeg* leg = &journey.legs[i];
+            const FlightInfo* f = flightAt(leg->flightIndex);
+            printf("%-10s %-10s %-10s %-8s %-8s%s\n", f->flightNumber, airportCode(f->origin), airportCode(f->destination), f->departureTime,
+                   f->arrivalTime, leg->departure >= MINUTES_PER_DAY ? " (+1 day)" : "");
         }
     }
-    return matrix;
+    journeyFree(&journey);
+    timetableFree(&tt);
 }
 
-static void freeMatrix(double** matrix, int n) {
-    if (!matrix) return;
-    for (int i = 0; i < n; ++i) {
-        free(matrix[i]);
+static int loadSampleNetwork(RouteNetwork* net) {
+    int airportCount = (int)(sizeof(SAMPLE_SMALL_APSP_NAMES) / sizeof(SAMPLE_SMALL_APSP_NAMES[0]));
+    for (int i = 0; i < airportCount; ++i) {
+        int airport = routeNetworkIntern(net, SAMPLE_SMALL_APSP_NAMES[i]);
+        if (airport == -1) return -1;
+        routeNetworkSetCoordinates(net, airport, SAMPLE_SMALL_APSP_COORDS[i][0], SAMPLE_SMALL_APSP_COORDS[i][1]);
+    }
+    int edgeCount = (int)(sizeof(SAMPLE_SMALL_APSP_EDGES) / sizeof(SAMPLE_SMALL_APSP_EDGES[0]));
+    for (int i = 0; i < edgeCount; ++i) {
+        int s = routeNetworkFind(net, SAMPLE_SMALL_APSP_EDGES[i].src);
+        int d = routeNetworkFind(net, SAMPLE_SMALL_APSP_EDGES[i].dest);
+        if (s == -1 || d == -1) continue;
+        if (routeNetworkAddRoute(net, s, d, SAMPLE_SMALL_APSP_EDGES[i].weight) != 0) return -1;
     }
-    free(matrix);
+    return net->routeCount;
 }
 
-static void printGraphDiagram(const RouteGraph* graph, char airportNames[][NAME_LEN]) {
+static void printGraphDiagram(const RouteGraph* graph, const RouteNetwork* net) {
     if (!graph || !graph->adjMatrix) {
-        printf("Graph not available.\n");
+        printf("Route matrix not built for %d airports (limit %d).\n", net->airportCount, ROUTE_MATRIX_MAX_AIRPORTS);
+        return;
+    }
+    if (graph->vertexCount > ROUTE_PRINT_MAX_AIRPORTS) {
+        printf("Route matrix not printed for %d airports.\n", graph->vertexCount);
         return;
     }
     printf("\nRoute weight matrix (%s):\n", graph->directed ? "directed" : "undirected");
     printf("%-12s", " ");
     for (int j = 0; j < graph->vertexCount; ++j) {
-        printf("%-12s", airportNames[j]);
+        printf("%-12s", routeNetworkAirportCode(net, j));
     }
     printf("\n");
     for (int i = 0; i < graph->vertexCount; ++i) {
-        printf("%-12s", airportNames[i]);
+        printf("%-12s", routeNetworkAirportCode(net, i));
         for (int j = 0; j < graph->vertexCount; ++j) {
             if (graph->adjMatrix[i][j] >= INF_WEIGHT / 2.0) {
                 printf("%-12s", "INF");
@@ -505,251 +1721,203 @@ static void printGraphDiagram(const RouteGraph* graph, char airportNames[][NAME_
     }
 }
 
-static int findAirportIndex(char airportNames[][NAME_LEN], int count, const char* name) {
-    for (int i = 0; i < count; ++i) {
-        if (strcmp(airportNames[i], name) == 0) {
-            return i;
-        }
+static void printMstEdges(const MSTResultEdge* edges, int count, const RouteNetwork* net) {
+    int shown = count < ROUTE_PRINT_MAX_ROWS ? count : ROUTE_PRINT_MAX_ROWS;
+    for (int i = 0; i < shown; ++i) {
+        printf("  %s -- %s : %.2f\n", routeNetworkAirportCode(net, edges[i].src), routeNetworkAirportCode(net, edges[i].dest), edges[i].weight);
     }
-    return -1;
+    if (shown < count) printf("  ... %d more edges\n", count - shown);
 }
 
-static double primMST(const RouteGraph* graph, MSTResultEdge* output, int* edgeCount) {
-    int V = graph->vertexCount;
-    
-    double* key = (double*)malloc(sizeof(double) * V);
-    int* parent = (int*)malloc(sizeof(int) * V);
-    bool* inMST = (bool*)malloc(sizeof(bool) * V);
-    
-    // Initialize arrays
-    for (int i = 0; i < V; i++) {
-        key[i] = INF_WEIGHT;
-        parent[i] = -1;
-        inMST[i] = false;
-    }
-    
-    key[0] = 0.0;  // Start from vertex 0
-    
-    // Build MST
-    for (int count = 0; count < V - 1; count++) {
-        // Find minimum key vertex not in MST
-        double min = INF_WEIGHT;
-        int u = -1;
-        for (int v = 0; v < V; v++) {
-            if (inMST[v] == false && key[v] < min) {
-                min = key[v];
-                u = v;
-            }
-        }
-        
-        inMST[u] = true;
-        
-        // Update keys of adjacent vertices
-        for (int v = 0; v < V; v++) {
-            double weight = graph->adjMatrix[u][v];
-            if (inMST[v] == false && weight < key[v]) {
-                key[v] = weight;
-                parent[v] = u;
-            }
-        }
-    }
-    
-    // Build output and calculate total weight
-    double total = 0.0;
-    int idx = 0;
-    for (int v = 1; v < V; v++) {
-        output[idx].src = parent[v];
-        output[idx].dest = v;
-        output[idx].weight = graph->adjMatrix[parent[v]][v];
-        total += output[idx].weight;
-        idx++;
-    }
-    
-    *edgeCount = idx;
-    
-    free(key);
-    free(parent);
-    free(inMST);
-    
-    return total;
-}
-
-static int buildUndirectedEdgeList(const RouteGraph* graph, RouteEdge** edgesOut) {
-    if (!graph || !graph->adjMatrix) {
-        *edgesOut = NULL;
-        return 0;
-    }
-    int V = graph->vertexCount;
-    int capacity = V * (V - 1) / 2;
-    if (capacity <= 0) {
-        *edgesOut = NULL;
-        return 0;
-    }
-    RouteEdge* edges = (RouteEdge*)malloc(sizeof(RouteEdge) * capacity);
-    if (!edges) {
-        *edgesOut = NULL;
-        return 0;
-    }
-    int count = 0;
-    for (int i = 0; i < V; ++i) {
-        for (int j = i + 1; j < V; ++j) {
-            double wForward = graph->adjMatrix[i][j];
-            double wBackward = graph->adjMatrix[j][i];
-            double weight = wForward;
-            if (wBackward < weight) weight = wBackward;
-            if (weight < INF_WEIGHT / 2.0) {
-                edges[count].src = i;
-                edges[count].dest = j;
-                edges[count].weight = weight;
-                ++count;
-            }
-        }
+// Every engine returns a forest, so a disconnected network is reported rather than rejected
+static void printMstOutcome(const char* engine, double weight, const MSTResultEdge* edges, int count, double ms,
+                            const RouteNetwork* net) {
+    if (weight < 0) {
+        printf("Unable to allocate memory for %s.\n", engine);
+        return;
     }
-    *edgesOut = edges;
-    return count;
-}
-
-static double kruskalMST(const RouteGraph* graph, RouteEdge* edges, int edgeCount, MSTResultEdge* output, int* mstEdgeCount) {
-    int V = graph->vertexCount;
-    int parent[100];
-    int count = 0;
-    double weight = 0;
-    
-    // Sort edges
-    qsort(edges, edgeCount, sizeof(RouteEdge), compareRouteEdges);
-    
-    // Initialize
-    for (int i = 0; i < V; i++) {
-        parent[i] = i;
-    }
-    
-    // Process edges
-    for (int i = 0; i < edgeCount; i++) {
-        
-        int u = edges[i].src;
-        int v = edges[i].dest;
-        
-        // Find root of u
-        int ru = u;
-        while (parent[ru] != ru) ru = parent[ru];
-        
-        // Find root of v
-        int rv = v;
-        while (parent[rv] != rv) rv = parent[rv];
-        
-        // Different roots? Add edge
-        if (ru != rv) {
-            output[count].src = edges[i].src;
-            output[count].dest = edges[i].dest;
-            output[count].weight = edges[i].weight;
-            weight = weight + edges[i].weight;
-            count = count + 1;
-            parent[ru] = rv;
-        }
-    }
-    
-    *mstEdgeCount = count;
-    return weight;
-}
-
-static int disjointSetFind(int* parent, int v) {
-    if (parent[v] != v) {
-        parent[v] = disjointSetFind(parent, parent[v]);
-    }
-    return parent[v];
-}
-
-static void disjointSetUnion(int* parent, int* rank, int a, int b) {
-    a = disjointSetFind(parent, a);
-    b = disjointSetFind(parent, b);
-    if (a == b) return;
-    if (rank[a] < rank[b]) {
-        parent[a] = b;
-    } else if (rank[a] > rank[b]) {
-        parent[b] = a;
+    if (count == net->airportCount - 1) {
+        printf("%s succeeded (Time: %.3f ms, Total weight: %.2f)\n", engine, ms, weight);
     } else {
-        parent[b] = a;
-        rank[a]++;
+        printf("Graph is disconnected: minimum spanning forest of %d trees (Time: %.3f ms, Total weight: %.2f)\n",
+               net->airportCount - count, ms, weight);
     }
+    printMstEdges(edges, count, net);
 }
 
-static int compareRouteEdges(const void* a, const void* b) {
-    const RouteEdge* ea = (const RouteEdge*)a;
-    const RouteEdge* eb = (const RouteEdge*)b;
-    if (ea->weight < eb->weight) return -1;
-    if (ea->weight > eb->weight) return 1;
-    return 0;
-}
-
-/* Simple Dijkstra (single-source) using adjacency matrix (non-negative weights only) */
-static void dijkstra(const RouteGraph* graph, int src, double* dist) {
-    int V = graph->vertexCount;
-    bool* visited = (bool*)calloc(V, sizeof(bool));
-    for (int i = 0; i < V; ++i) dist[i] = INF_WEIGHT;
-    dist[src] = 0.0;
-
-    for (int count = 0; count < V; ++count) {
-        double minDist = INF_WEIGHT;
-        int u = -1;
-        for (int v = 0; v < V; ++v) {
-            if (!visited[v] && dist[v] < minDist) {
-                minDist = dist[v];
-                u = v;
-            }
-        }
-        if (u == -1) break;
-        visited[u] = true;
-        for (int v = 0; v < V; ++v) {
-            double w = graph->adjMatrix[u][v];
-            if (w >= INF_WEIGHT / 2.0) continue;
-            double alt = dist[u] + w;
-            if (alt < dist[v]) dist[v] = alt;
+static void printDistanceList(const double* dist, const RouteNetwork* net) {
+    int reachable = 0;
+    printf("%-12s %-12s\n", "Airport", "Distance");
+    for (int i = 0; i < net->airportCount; ++i) {
+        int isReachable = dist[i] < INF_WEIGHT / 2.0;
+        reachable += isReachable;
+        if (i >= ROUTE_PRINT_MAX_ROWS) continue;
+        if (isReachable) {
+            printf("%-12s %-12.2f\n", routeNetworkAirportCode(net, i), dist[i]);
+        } else {
+            printf("%-12s %-12s\n", routeNetworkAirportCode(net, i), "INF");
         }
     }
-    free(visited);
+    if (net->airportCount > ROUTE_PRINT_MAX_ROWS) printf("... %d more airports\n", net->airportCount - ROUTE_PRINT_MAX_ROWS);
+    printf("Reachable: %d of %d airports\n", reachable, net->airportCount);
 }
 
-static int floydWarshallAllPairs(const RouteGraph* graph, double** distOut) {
-    if (!graph || !graph->adjMatrix || !distOut) return -1;
-    int V = graph->vertexCount;
-    for (int i = 0; i < V; ++i) {
-        for (int j = 0; j < V; ++j) {
-            distOut[i][j] = graph->adjMatrix[i][j];
-        }
-        distOut[i][i] = 0.0;
+static void printItinerary(const RouteNetwork* net, const CsrGraph* csr, int from, int to) {
+    if (from == -1 || to == -1) {
+        printf("Unknown airport code.\n");
+        return;
     }
-
-    for (int k = 0; k < V; ++k) {
-        for (int i = 0; i < V; ++i) {
-            if (distOut[i][k] >= INF_WEIGHT / 2.0) continue;
-            for (int j = 0; j < V; ++j) {
-                if (distOut[k][j] >= INF_WEIGHT / 2.0) continue;
-                double alt = distOut[i][k] + distOut[k][j];
-                if (alt < distOut[i][j]) {
-                    distOut[i][j] = alt;
-                }
-            }
+    RouteQuery query;
+    if (!csr || routeQueryInit(&query, net, csr) != 0) {
+        printf("Unable to allocate memory for routing.\n");
+        return;
+    }
+    RouteItinerary it;
+    routeItineraryInit(&it);
+    double start = wallClockMs();
+    int status = routeQueryBest(&query, from, to, &it);
+    double elapsedMs = wallClockMs() - start;
+    if (status == 1) {
+        printf("No itinerary from %s to %s.\n", routeNetworkAirportCode(net, from), routeNetworkAirportCode(net, to));
+    } else if (status != 0) {
+        printf("Unable to allocate memory for routing.\n");
+    } else {
+        printf("Best itinerary %s -> %s: total %.2f, %d leg(s) (%s, %d airports settled, %.3f ms)\n",
+               routeNetworkAirportCode(net, from), routeNetworkAirportCode(net, to), it.cost, it.stopCount - 1,
+               query.heuristicScale > 0 ? "bidirectional A*" : "bidirectional Dijkstra", it.settled, elapsedMs);
+        for (int i = 0; i + 1 < it.stopCount; ++i) {
+            printf("  %-8s -> %-8s %10.2f\n", routeNetworkAirportCode(net, it.stops[i]),
+                   routeNetworkAirportCode(net, it.stops[i + 1]), csrArcWeight(csr, it.stops[i], it.stops[i + 1]));
         }
     }
-    return 0;
+    routeItineraryFree(&it);
+    routeQueryFree(&query);
 }
 
+static double wallClockMs(void) {
+    // clock() adds up CPU time across threads, which hides parallel speedup
+    struct timespec ts;
+    timespec_get(&ts, TIME_UTC);
+    return ts.tv_sec * 1000.0 + ts.tv_nsec / 1e6;
+}
 
-static void printDistanceMatrix(double** dist, int n, char airportNames[][NAME_LEN]) {
+static void printDistanceMatrix(const DistanceMatrix* dist, const RouteNetwork* net) {
+    int n = net->airportCount;
+    if (n > ROUTE_PRINT_MAX_AIRPORTS) {
+        printf("Shortest path matrix not printed for %d airports.\n", n);
+        return;
+    }
+    printf("\nShortest path matrix:\n");
     printf("%-12s", " ");
     for (int j = 0; j < n; ++j) {
-        printf("%-12s", airportNames[j]);
+        printf("%-12s", routeNetworkAirportCode(net, j));
     }
     printf("\n");
     for (int i = 0; i < n; ++i) {
-        printf("%-12s", airportNames[i]);
+        printf("%-12s", routeNetworkAirportCode(net, i));
+        const double* row = distanceMatrixRow(dist, i);
         for (int j = 0; j < n; ++j) {
-            if (dist[i][j] >= INF_WEIGHT / 2.0) {
+            if (row[j] >= INF_WEIGHT / 2.0) {
                 printf("%-12s", "INF");
             } else {
-                printf("%-12.2f", dist[i][j]);
+                printf("%-12.2f", row[j]);
             }
         }
         printf("\n");
     }
-}
\ No newline at end of file
+}
+
+static void printRouteChangeResult(const DynamicRoutes* routes, const RouteNetwork* net, int src, int dest, double ms) {
+    printf("Updated in %.3f ms. ", ms);
+    if (routes->forestEdges == net->airportCount - 1) {
+        printf("MST weight: %.2f\n", routes->forestWeight);
+    } else {
+        printf("Spanning forest weight: %.2f (%d trees, graph disconnected)\n", routes->forestWeight,
+               net->airportCount - routes->forestEdges);
+    }
+    if (!routes->hasDistances) return;
+    double d = dynamicRoutesDistance(routes, src, dest);
+    if (d >= INF_WEIGHT / 2.0) {
+        printf("Shortest distance %s -> %s: unreachable\n", routeNetworkAirportCode(net, src), routeNetworkAirportCode(net, dest));
+    } else {
+        printf("Shortest distance %s -> %s: %.2f\n", routeNetworkAirportCode(net, src), routeNetworkAirportCode(net, dest), d);
+    }
+}
+
+/*
+ * Add, reprice or cancel single routes and keep the MST, and the all-pairs
+ * table while the network fits the matrix limit, current without
+ * recomputing them. apsp, if given, is taken over.
+ */
+static void applyRouteChanges(const RouteNetwork* net, DistanceMatrix* apsp) {
+    DynamicRoutes routes;
+    int ready = 0;
+    for (;;) {
+        printf("\n--- Route Changes ---\n");
+        printf("  1. Add or reprice a route\n");
+        printf("  2. Cancel a route\n");
+        printf("  3. Done\n");
+        printf("Enter choice: ");
+        int choice = 0;
+        if (scanf("%d", &choice) != 1 || (choice != 1 && choice != 2)) break;
+
+        if (!ready) {
+            double startInit = wallClockMs();
+            if (dynamicRoutesInit(&routes, net->airportCount, net->routes, net->routeCount, net->directed) != 0) {
+                printf("Unable to allocate memory for route changes.\n");
+                break;
+            }
+            ready = 1;
+            if (net->airportCount <= ROUTE_MATRIX_MAX_AIRPORTS) {
+                if (dynamicRoutesTrackDistances(&routes, apsp) == 0) {
+                    apsp = NULL;
+                } else {
+                    printf("Unable to allocate the all-pairs table; tracking the MST only.\n");
+                }
+            }
+            printf("Change tracking ready in %.3f ms (MST%s)\n", wallClockMs() - startInit,
+                   routes.hasDistances ? " and all-pairs distances" : "");
+        }
+
+        char srcCode[AIRPORT_CODE_LEN], destCode[AIRPORT_CODE_LEN];
+        printf("Enter origin airport code: ");
+        scanf("%31s", srcCode);
+        printf("Enter destination airport code: ");
+        scanf("%31s", destCode);
+        int src = routeNetworkFind(net, srcCode);
+        int dest = routeNetworkFind(net, destCode);
+        if (src == -1 || dest == -1 || src == dest) {
+            printf("Both airports must already be in the network and differ.\n");
+            continue;
+        }
+        int existing = dynamicRoutesFind(&routes, src, dest);
+        double start = wallClockMs();
+        int result;
+        if (choice == 1) {
+            double weight;
+            printf("Enter route weight: ");
+            if (scanf("%lf", &weight) != 1 || !isfinite(weight) || weight < 0) {
+                printf("Invalid weight.\n");
+                continue;
+            }
+            start = wallClockMs();
+            result = existing == -1 ? dynamicRoutesAdd(&routes, src, dest, weight)
+                                    : dynamicRoutesReprice(&routes, existing, weight);
+            if (result != -1) printf("%s %s -> %s at %.2f\n", existing == -1 ? "Added" : "Repriced", srcCode, destCode, weight);
+        } else {
+            if (existing == -1) {
+                printf("No route between %s and %s.\n", srcCode, destCode);
+                continue;
+            }
+            result = dynamicRoutesRemove(&routes, existing);
+            if (result != -1) printf("Cancelled %s -> %s\n", srcCode, destCode);
+        }
+        if (result == -1) {
+            printf("Route change failed (out of memory).\n");
+            continue;
+        }
+        printRouteChangeResult(&routes, net, src, dest, wallClockMs() - start);
+    }
+    if (ready) dynamicRoutesFree(&routes);
+    if (apsp) distanceMatrixFree(apsp);
+}
@@ -6,16 +6,20 @@
 #include <stdlib.h>
 #include <string.h>
 #include <time.h>
+#include <stdatomic.h>
+#include <stdint.h>
+#include "checkinqueue.h"
+#include "reportwriter.h"
+#include "seatmap.h"
 
-#define MAX_FLIGHTS 100
-#define MAX_PASSENGERS 200
 #define NAME_LEN 32
 #define EMAIL_LEN 64
 #define PHONE_LEN 16
 #define FLIGHT_ID_LEN 8
 #define STATUS_LEN 16
 
-// Flight structure
+// Flight as entered, displayed and logged. Stored split by row index: the
+// strings in the flight store (FlightInfo), the numbers in flight columns.
 typedef struct {
     char flightNumber[FLIGHT_ID_LEN];
     char origin[NAME_LEN];
@@ -28,37 +32,143 @@ typedef struct {
     int priority;
     int bookedSeats;
     char status[STATUS_LEN];
+    int overbook; // seats that may be sold past capacity
 } Flight;
 
-// Passenger structure
+// Cold part of a stored flight; only read to display or route it.
+// Airports are ids in the airport store (see airportCode()).
+typedef struct {
+    char flightNumber[FLIGHT_ID_LEN];
+    int32_t origin;
+    int32_t destination;
+    char departureTime[8];
+    char arrivalTime[8];
+    char aircraft[NAME_LEN];
+    char status[STATUS_LEN];
+} FlightInfo;
+
+typedef enum {
+    CHECKIN_PENDING = 0,
+    CHECKIN_DONE
+} CheckInStatus;
+
+typedef enum {
+    TICKET_CONFIRMED = 0, // holds a seat
+    TICKET_WAITLISTED,    // queued on the flight's waitlist, no seat yet
+    TICKET_CANCELLED      // tombstone: the record stays so indexes never shift
+} TicketStatus;
+
+// Passenger structure; the flight is resolved to its index when booked
 typedef struct {
     char id[NAME_LEN];
     char firstName[NAME_LEN];
     char lastName[NAME_LEN];
     char email[EMAIL_LEN];
     char phone[PHONE_LEN];
-    char flightId[FLIGHT_ID_LEN];
-    char checkInStatus[STATUS_LEN];
+    int32_t flightIndex;
+    int32_t checkInStatus; // CheckInStatus
+    int32_t ticketStatus;  // TicketStatus
+    int32_t waitlistPriority;
+    int32_t seat; // seat number on the flight's seat map, -1 = not assigned
 } Passenger;
 
-// Linked List Node for Check-in Queue
-typedef struct CheckInNode {
-    Passenger passenger;
-    int priority;
-    char checkInTime[32];
-    struct CheckInNode* next;
-} CheckInNode;
+typedef enum {
+    REPORT_FLIGHTS = 0,
+    REPORT_PASSENGERS,
+    REPORT_CHECKIN_QUEUE
+} ReportKind;
+
+typedef enum {
+    BOOKING_OK = 0,
+    BOOKING_FLIGHT_NOT_FOUND,
+    BOOKING_FLIGHT_FULL,
+    BOOKING_DUPLICATE_ID,
+    BOOKING_NO_MEMORY,
+    BOOKING_WAITLISTED,
+    BOOKING_PASSENGER_NOT_FOUND,
+    BOOKING_ALREADY_CANCELLED,
+    BOOKING_SEAT_UNAVAILABLE,
+    BOOKING_NOT_CONFIRMED
+} BookingStatus;
 
 // Function prototypes
+FlightInfo* flightAt(int index);
+// Gathers a stored flight's strings and columns into one row.
+void flightRow(int index, Flight* out);
+// Sellable seats: capacity plus the overbooking limit, less seats booked.
+int flightSeatsLeft(int index);
+float flightPrice(int index);
+Passenger* passengerAt(int index);
+/*
+ * Airport codes are interned once, when a flight is created, into dense
+ * ids shared by every flight; the route and journey planners index
+ * their vertices by them instead of hashing strings again.
+ */
+int internAirport(const char* code);
+// Airport id for code, or -1 if no flight uses it.
+int findAirport(const char* code);
+const char* airportCode(int airport);
+const char* checkInStatusName(CheckInStatus status);
+// "cancelled", "waitlisted", or the check-in status of a confirmed ticket
+const char* passengerStatusName(const Passenger* p);
+int findFlightIndex(const char* flightNumber);
+int findPassengerIndex(const char* passengerId);
+const char* bookingStatusMessage(BookingStatus status);
+// "HH:MM" -> minutes after midnight, or -1 if malformed.
+int flightClockMinutes(const char* hhmm);
+int reserveSeats(int flightIndex, int seats);
+void releaseSeats(int flightIndex, int seats);
+BookingStatus createFlight(const Flight* details, int* indexOut);
+BookingStatus bookPassenger(const Passenger* details, const char* flightNumber, int* indexOut);
+/*
+ * Cancellation and waitlists. A full flight's bookings can queue on its
+ * waitlist by priority; a cancelled confirmed ticket hands its seat
+ * straight to the front of the waitlist, so the seat is never released
+ * to the pool while someone is waiting. Records are tombstoned, never
+ * removed. Each flight's waitlist and seat hand-overs are serialised by
+ * a striped lock; plain bookings stay lock-free.
+ */
+// Books like bookPassenger(), or joins the waitlist (BOOKING_WAITLISTED) if the flight is full.
+BookingStatus bookOrWaitlist(const Passenger* details, const char* flightNumber, int priority, int* indexOut);
+// *promotedOut is the passenger given the freed seat, or -1. Either may be NULL.
+BookingStatus cancelBooking(const char* passengerId, int* promotedOut);
+// Seats sellable past capacity (>= 0); promotes waitlisted bookings into new room. Returns how many, or -1.
+int setOverbookLimit(int flightIndex, int limit);
+int waitlistLength(int flightIndex);
+/*
+ * Seat assignment on the flight's seat map, for confirmed tickets only.
+ * Searching and claiming seats is lock-free; writing the passenger's
+ * seat number takes the same striped lock as cancellation, which gives
+ * the seat back. Taking a new seat releases the one held before.
+ */
+// seat >= 0 asks for that seat, else the first free one matching cabin and pref. *seatOut may be NULL.
+BookingStatus assignSeat(int passengerIndex, int seat, SeatCabin cabin, SeatPreference pref, int* seatOut);
+// Seats up to SEAT_BLOCK_MAX passengers of one flight side by side in one row, in the order given.
+BookingStatus assignAdjacentSeats(int flightIndex, const int* passengers, int count, SeatCabin cabin, int* firstSeatOut);
+// Writes the seat's label ("12A"), or "-" for none; out needs SEAT_LABEL_LEN bytes.
+void seatLabel(int flightIndex, int seat, char* out);
 void addFlight();
 void displayFlights();
+void findAvailableFlights();
 void bookTicket();
 void displayPassengers(); 
-void enqueueCheckIn(Passenger passenger, int priority);
+// Full listing in any format; the screen listings are the REPORT_TEXT form. 0, or -1 on failure.
+int writeReport(ReportKind kind, FILE* out, ReportFormat format);
+void exportReport();
+void searchRecords();
+void cancelTicket();
+void manageWaitlist();
+void showSeatMap();
+int enqueueCheckIn(int passengerIndex, int priority);
+int dequeueCheckIn(CheckInNode* out);
+// Queues a confirmed ticket for check-in, first giving it a seat if it has none
+// (BOOKING_SEAT_UNAVAILABLE when the flight is overbooked). Menu and batch both go through this.
+BookingStatus checkInBooking(int passengerIndex, int priority);
 void displayCheckInQueue();
 void checkInPassenger();
 void processCheckInQueue();
 void mainMenu();
 void analyzeRouteNetwork();
+void planJourney();
 
 #endif // AIRLINE_H
\ No newline at end of file
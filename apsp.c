@@ -0,0 +1,352 @@
+#include "apsp.h"
+#include <stdlib.h>
+#include <string.h>
+#ifdef _WIN32
+#include <malloc.h>
+#endif
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define APSP_X86_DISPATCH 1
+#include <immintrin.h>
+#endif
+
+/*
+ * Two tile kernels per instruction set, both computing
+ *     c[i][j] = min(c[i][j], a[i][k] + b[k][j])   for k in the tile.
+ * minPlusTile keeps k outermost, which stays correct when c aliases a
+ * or b (diagonal and row/column phases). minPlusTileDisjoint is only
+ * called when c is a different tile from a and b, so it can hold a row
+ * of c in registers across the whole k loop.
+ *
+ * No INF test is needed: INF_WEIGHT + anything >= INF_WEIGHT, so an
+ * unreachable cell can only be replaced by a real, shorter path.
+ */
+typedef void (*MinPlusTileFn)(double* c, const double* a, const double* b, size_t stride);
+
+static void minPlusTileScalar(double* c, const double* a, const double* b, size_t stride) {
+    for (int k = 0; k < APSP_BLOCK; ++k) {
+        const double* bk = b + (size_t)k * stride;
+        for (int i = 0; i < APSP_BLOCK; ++i) {
+            double aik = a[(size_t)i * stride + k];
+            double* ci = c + (size_t)i * stride;
+            for (int j = 0; j < APSP_BLOCK; ++j) {
+                double alt = aik + bk[j];
+                ci[j] = alt < ci[j] ? alt : ci[j];
+            }
+        }
+    }
+}
+
+static void minPlusTileDisjointScalar(double* restrict c, const double* restrict a, const double* restrict b, size_t stride) {
+    double row[APSP_BLOCK];
+    for (int i = 0; i < APSP_BLOCK; ++i) {
+        double* ci = c + (size_t)i * stride;
+        const double* ai = a + (size_t)i * stride;
+        memcpy(row, ci, sizeof(row));
+        for (int k = 0; k < APSP_BLOCK; ++k) {
+            const double* bk = b + (size_t)k * stride;
+            double aik = ai[k];
+            for (int j = 0; j < APSP_BLOCK; ++j) {
+                double alt = aik + bk[j];
+                row[j] = alt < row[j] ? alt : row[j];
+            }
+        }
+        memcpy(ci, row, sizeof(row));
+    }
+}
+
+#ifdef APSP_X86_DISPATCH
+__attribute__((target("avx2")))
+static void minPlusTileAvx2(double* c, const double* a, const double* b, size_t stride) {
+    for (int k = 0; k < APSP_BLOCK; ++k) {
+        const double* bk = b + (size_t)k * stride;
+        for (int i = 0; i < APSP_BLOCK; ++i) {
+            __m256d aik = _mm256_broadcast_sd(a + (size_t)i * stride + k);
+            double* ci = c + (size_t)i * stride;
+            for (int j = 0; j < APSP_BLOCK; j += 4) {
+                __m256d alt = _mm256_add_pd(aik, _mm256_load_pd(bk + j));
+                _mm256_store_pd(ci + j, _mm256_min_pd(alt, _mm256_load_pd(ci + j)));
+            }
+        }
+    }
+}
+
+// Half a tile row (32 doubles) per pass keeps the accumulators within the 16 ymm registers
+__attribute__((target("avx2")))
+static void minPlusTileDisjointAvx2(double* c, const double* a, const double* b, size_t stride) {
+    for (int i = 0; i < APSP_BLOCK; ++i) {
+        double* ci = c + (size_t)i * stride;
+        const double* ai = a + (size_t)i * stride;
+        for (int half = 0; half < APSP_BLOCK; half += 32) {
+            __m256d r0 = _mm256_load_pd(ci + half), r1 = _mm256_load_pd(ci + half + 4);
+            __m256d r2 = _mm256_load_pd(ci + half + 8), r3 = _mm256_load_pd(ci + half + 12);
+            __m256d r4 = _mm256_load_pd(ci + half + 16), r5 = _mm256_load_pd(ci + half + 20);
+            __m256d r6 = _mm256_load_pd(ci + half + 24), r7 = _mm256_load_pd(ci + half + 28);
+            for (int k = 0; k < APSP_BLOCK; ++k) {
+                const double* bk = b + (size_t)k * stride + half;
+                __m256d aik = _mm256_broadcast_sd(ai + k);
+                r0 = _mm256_min_pd(r0, _mm256_add_pd(aik, _mm256_load_pd(bk)));
+                r1 = _mm256_min_pd(r1, _mm256_add_pd(aik, _mm256_load_pd(bk + 4)));
+                r2 = _mm256_min_pd(r2, _mm256_add_pd(aik, _mm256_load_pd(bk + 8)));
+                r3 = _mm256_min_pd(r3, _mm256_add_pd(aik, _mm256_load_pd(bk + 12)));
+                r4 = _mm256_min_pd(r4, _mm256_add_pd(aik, _mm256_load_pd(bk + 16)));
+                r5 = _mm256_min_pd(r5, _mm256_add_pd(aik, _mm256_load_pd(bk + 20)));
+                r6 = _mm256_min_pd(r6, _mm256_add_pd(aik, _mm256_load_pd(bk + 24)));
+                r7 = _mm256_min_pd(r7, _mm256_add_pd(aik, _mm256_load_pd(bk + 28)));
+            }
+            _mm256_store_pd(ci + half, r0);
+            _mm256_store_pd(ci + half + 4, r1);
+            _mm256_store_pd(ci + half + 8, r2);
+            _mm256_store_pd(ci + half + 12, r3);
+            _mm256_store_pd(ci + half + 16, r4);
+            _mm256_store_pd(ci + half + 20, r5);
+            _mm256_store_pd(ci + half + 24, r6);
+            _mm256_store_pd(ci + half + 28, r7);
+        }
+    }
+}
+
+__attribute__((target("avx512f")))
+static void minPlusTileAvx512(double* c, const double* a, const double* b, size_t stride) {
+    for (int k = 0; k < APSP_BLOCK; ++k) {
+        const double* bk = b + (size_t)k * stride;
+        for (int i = 0; i < APSP_BLOCK; ++i) {
+            __m512d aik = _mm512_set1_pd(a[(size_t)i * stride + k]);
+            double* ci = c + (size_t)i * stride;
+            for (int j = 0; j < APSP_BLOCK; j += 8) {
+                __m512d alt = _mm512_add_pd(aik, _mm512_load_pd(bk + j));
+                _mm512_store_pd(ci + j, _mm512_min_pd(alt, _mm512_load_pd(ci + j)));
+            }
+        }
+    }
+}
+
+// A whole tile row fits in 8 zmm accumulators
+__attribute__((target("avx512f")))
+static void minPlusTileDisjointAvx512(double* c, const double* a, const double* b, size_t stride) {
+    for (int i = 0; i < APSP_BLOCK; ++i) {
+        double* ci = c + (size_t)i * stride;
+        const double* ai = a + (size_t)i * stride;
+        __m512d r0 = _mm512_load_pd(ci), r1 = _mm512_load_pd(ci + 8);
+        __m512d r2 = _mm512_load_pd(ci + 16), r3 = _mm512_load_pd(ci + 24);
+        __m512d r4 = _mm512_load_pd(ci + 32), r5 = _mm512_load_pd(ci + 40);
+        __m512d r6 = _mm512_load_pd(ci + 48), r7 = _mm512_load_pd(ci + 56);
+        for (int k = 0; k < APSP_BLOCK; ++k) {
+            const double* bk = b + (size_t)k * stride;
+            __m512d aik = _mm512_set1_pd(ai[k]);
+            r0 = _mm512_min_pd(r0, _mm512_add_pd(aik, _mm512_load_pd(bk)));
+            r1 = _mm512_min_pd(r1, _mm512_add_pd(aik, _mm512_load_pd(bk + 8)));
+            r2 = _mm512_min_pd(r2, _mm512_add_pd(aik, _mm512_load_pd(bk + 16)));
+            r3 = _mm512_min_pd(r3, _mm512_add_pd(aik, _mm512_load_pd(bk + 24)));
+            r4 = _mm512_min_pd(r4, _mm512_add_pd(aik, _mm512_load_pd(bk + 32)));
+            r5 = _mm512_min_pd(r5, _mm512_add_pd(aik, _mm512_load_pd(bk + 40)));
+            r6 = _mm512_min_pd(r6, _mm512_add_pd(aik, _mm512_load_pd(bk + 48)));
+            r7 = _mm512_min_pd(r7, _mm512_add_pd(aik, _mm512_load_pd(bk + 56)));
+        }
+        _mm512_store_pd(ci, r0);
+        _mm512_store_pd(ci + 8, r1);
+        _mm512_store_pd(ci + 16, r2);
+        _mm512_store_pd(ci + 24, r3);
+        _mm512_store_pd(ci + 32, r4);
+        _mm512_store_pd(ci + 40, r5);
+        _mm512_store_pd(ci + 48, r6);
+        _mm512_store_pd(ci + 56, r7);
+    }
+}
+#endif
+
+int distanceMatrixInit(DistanceMatrix* m, int n) {
+    m->n = n;
+    m->stride = ((size_t)(n > 0 ? n : 1) + APSP_BLOCK - 1) / APSP_BLOCK * APSP_BLOCK;
+    size_t bytes = m->stride * m->stride * sizeof(double);
+#ifdef _WIN32
+    m->data = (double*)_aligned_malloc(bytes, 64);
+#else
+    m->data = (double*)aligned_alloc(64, bytes);
+#endif
+    if (!m->data) return -1;
+    size_t cells = m->stride * m->stride;
+    for (size_t i = 0; i < cells; ++i) m->data[i] = INF_WEIGHT;
+    for (size_t i = 0; i < m->stride; ++i) m->data[i * m->stride + i] = 0.0;
+    return 0;
+}
+
+void distanceMatrixFree(DistanceMatrix* m) {
+#ifdef _WIN32
+    _aligned_free(m->data);
+#else
+    free(m->data);
+#endif
+    m->data = NULL;
+    m->n = 0;
+    m->stride = 0;
+}
+
+int distanceMatrixFromGraph(DistanceMatrix* m, const RouteGraph* graph) {
+    if (!graph || !graph->adjMatrix) return -1;
+    int n = graph->vertexCount;
+    if (distanceMatrixInit(m, n) != 0) return -1;
+    for (int i = 0; i < n; ++i) {
+        double* row = distanceMatrixRow(m, i);
+        memcpy(row, graph->adjMatrix[i], sizeof(double) * (size_t)n);
+        row[i] = 0.0;
+    }
+    return 0;
+}
+
+ApspKernel apspDetectKernel(void) {
+#ifdef APSP_X86_DISPATCH
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx512f")) return APSP_KERNEL_AVX512;
+    if (__builtin_cpu_supports("avx2")) return APSP_KERNEL_AVX2;
+#endif
+    return APSP_KERNEL_SCALAR;
+}
+
+int apspKernelSupported(ApspKernel kernel) {
+    switch (kernel) {
+        case APSP_KERNEL_AUTO:
+        case APSP_KERNEL_SCALAR:
+            return 1;
+        case APSP_KERNEL_AVX2:
+            return apspDetectKernel() >= APSP_KERNEL_AVX2;
+        case APSP_KERNEL_AVX512:
+            return apspDetectKernel() >= APSP_KERNEL_AVX512;
+    }
+    return 0;
+}
+
+const char* apspKernelName(ApspKernel kernel) {
+    switch (kernel) {
+        case APSP_KERNEL_AUTO: return "auto";
+        case APSP_KERNEL_SCALAR: return "scalar";
+        case APSP_KERNEL_AVX2: return "avx2";
+        case APSP_KERNEL_AVX512: return "avx512";
+    }
+    return "unknown";
+}
+
+/*
+ * Classic three-phase blocking: for each diagonal tile kb, first close
+ * the diagonal tile itself, then the tiles sharing its row or column,
+ * then every remaining tile from those two. Each phase touches three
+ * 32 KiB tiles at a time, so the inner loops run out of L1/L2.
+ */
+int apspBlockedFloydWarshall(DistanceMatrix* m, ApspKernel kernel) {
+    if (kernel == APSP_KERNEL_AUTO) kernel = apspDetectKernel();
+    if (!apspKernelSupported(kernel)) return -1;
+
+    MinPlusTileFn tile = minPlusTileScalar;
+    MinPlusTileFn disjoint = minPlusTileDisjointScalar;
+#ifdef APSP_X86_DISPATCH
+    if (kernel == APSP_KERNEL_AVX512) {
+        tile = minPlusTileAvx512;
+        disjoint = minPlusTileDisjointAvx512;
+    } else if (kernel == APSP_KERNEL_AVX2) {
+        tile = minPlusTileAvx2;
+        disjoint = minPlusTileDisjointAvx2;
+    }
+#endif
+
+    size_t stride = m->stride;
+    int blocks = (int)(stride / APSP_BLOCK);
+#define TILE(bi, bj) (m->data + (size_t)(bi) * APSP_BLOCK * stride + (size_t)(bj) * APSP_BLOCK)
+
+    for (int kb = 0; kb < blocks; ++kb) {
+        double* diag = TILE(kb, kb);
+        tile(diag, diag, diag, stride);
+        for (int b = 0; b < blocks; ++b) {
+            if (b == kb) continue;
+            tile(TILE(kb, b), diag, TILE(kb, b), stride);
+            tile(TILE(b, kb), TILE(b, kb), diag, stride);
+        }
+        for (int bi = 0; bi < blocks; ++bi) {
+            if (bi == kb) continue;
+            const double* colTile = TILE(bi, kb);
+            for (int bj = 0; bj < blocks; ++bj) {
+                if (bj == kb) continue;
+                disjoint(TILE(bi, bj), colTile, TILE(kb, bj), stride);
+            }
+        }
+    }
+#undef TILE
+    return (int)kernel;
+}
+
+double apspEstimateFloydNs(int vertexCount, ApspKernel kernel) {
+    if (kernel == APSP_KERNEL_AUTO) kernel = apspDetectKernel();
+    // Padding to whole tiles is real work too
+    double padded = (double)((vertexCount + APSP_BLOCK - 1) / APSP_BLOCK * APSP_BLOCK);
+    double perUpdate = APSP_NS_PER_FLOYD_UPDATE_SCALAR;
+    if (kernel == APSP_KERNEL_AVX2) perUpdate = APSP_NS_PER_FLOYD_UPDATE_AVX2;
+    if (kernel == APSP_KERNEL_AVX512) perUpdate = APSP_NS_PER_FLOYD_UPDATE_AVX512;
+    return padded * padded * padded * perUpdate;
+}
+
+double apspEstimateDijkstraNs(int vertexCount, long arcCount, int threads) {
+    if (threads < 1) threads = 1;
+    int logV = 1; // ceil(log2 V), without pulling in libm
+    while ((1L << logV) < vertexCount) ++logV;
+    double v = (double)vertexCount;
+    double steps = v * (v + (double)arcCount) * logV;
+    return steps * APSP_NS_PER_DIJKSTRA_STEP / threads + (threads > 1 ? APSP_POOL_STARTUP_NS : 0.0);
+}
+
+ApspStrategy apspChooseStrategy(int vertexCount, long arcCount, int threads, ApspKernel kernel) {
+    double floyd = apspEstimateFloydNs(vertexCount, kernel);
+    double dijkstra = apspEstimateDijkstraNs(vertexCount, arcCount, threads);
+    return dijkstra < floyd ? APSP_STRATEGY_PARALLEL_DIJKSTRA : APSP_STRATEGY_FLOYD;
+}
+
+const char* apspStrategyName(ApspStrategy strategy) {
+    return strategy == APSP_STRATEGY_PARALLEL_DIJKSTRA ? "parallel Dijkstra" : "blocked Floyd-Warshall";
+}
+
+typedef struct {
+    DistanceMatrix* matrix;
+    const CsrGraph* csr;
+    IndexedHeap* heaps; // one per worker, reused across sources
+} ParallelDijkstraJob;
+
+static void runDijkstraSource(void* ctx, long src, int worker) {
+    ParallelDijkstraJob* job = (ParallelDijkstraJob*)ctx;
+    dijkstraCsrWithHeap(job->csr, (int)src, distanceMatrixRow(job->matrix, (int)src), &job->heaps[worker]);
+}
+
+int apspParallelDijkstra(DistanceMatrix* m, const CsrGraph* csr, WorkPool* pool) {
+    int workers = pool->threadCount;
+    IndexedHeap* heaps = (IndexedHeap*)calloc((size_t)workers, sizeof(IndexedHeap));
+    if (!heaps) return -1;
+    int status = 0;
+    for (int i = 0; i < workers; ++i) {
+        if (indexedHeapInit(&heaps[i], csr->vertexCount) != 0) status = -1;
+    }
+    if (status == 0) {
+        ParallelDijkstraJob job = { m, csr, heaps };
+        workPoolRun(pool, csr->vertexCount, runDijkstraSource, &job);
+    }
+    for (int i = 0; i < workers; ++i) indexedHeapFree(&heaps[i]);
+    free(heaps);
+    return status;
+}
+
+int apspAllPairs(DistanceMatrix* m, const RouteGraph* graph, const CsrGraph* csr, WorkPool* pool) {
+    ApspStrategy strategy = APSP_STRATEGY_FLOYD;
+    if (pool && csr && csr->rowStart) {
+        strategy = apspChooseStrategy(csr->vertexCount, csr->arcCount, pool->threadCount, APSP_KERNEL_AUTO);
+    }
+    if (strategy == APSP_STRATEGY_PARALLEL_DIJKSTRA) {
+        if (distanceMatrixInit(m, csr->vertexCount) != 0) return -1;
+        if (apspParallelDijkstra(m, csr, pool) != 0) {
+            distanceMatrixFree(m);
+            return -1;
+        }
+        return (int)strategy;
+    }
+    if (distanceMatrixFromGraph(m, graph) != 0) return -1;
+    if (apspBlockedFloydWarshall(m, APSP_KERNEL_AUTO) < 0) {
+        distanceMatrixFree(m);
+        return -1;
+    }
+    return (int)strategy;
+}
@@ -0,0 +1,78 @@
+#ifndef APSP_H
+#define APSP_H
+
+#include <stddef.h>
+#include "routegraph.h"
+#include "workpool.h"
+
+/*
+ * All-pairs shortest paths over one contiguous, 64-byte aligned buffer.
+ * Rows are padded to a multiple of APSP_BLOCK so the blocked
+ * Floyd-Warshall kernel only ever sees full tiles; padding cells hold
+ * INF_WEIGHT and never shorten a real path.
+ */
+#define APSP_BLOCK 64
+
+typedef struct {
+    int n;
+    size_t stride; // doubles per row, multiple of APSP_BLOCK
+    double* data;
+} DistanceMatrix;
+
+typedef enum {
+    APSP_KERNEL_AUTO = 0,
+    APSP_KERNEL_SCALAR,
+    APSP_KERNEL_AVX2,
+    APSP_KERNEL_AVX512
+} ApspKernel;
+
+// Every cell INF_WEIGHT except a zero diagonal. Returns 0 or -1 on allocation failure.
+int distanceMatrixInit(DistanceMatrix* m, int n);
+void distanceMatrixFree(DistanceMatrix* m);
+int distanceMatrixFromGraph(DistanceMatrix* m, const RouteGraph* graph);
+
+static inline double* distanceMatrixRow(const DistanceMatrix* m, int i) {
+    return m->data + (size_t)i * m->stride;
+}
+
+// Best kernel this CPU can run; AUTO resolves to it.
+ApspKernel apspDetectKernel(void);
+int apspKernelSupported(ApspKernel kernel);
+const char* apspKernelName(ApspKernel kernel);
+
+// Blocked, branch-free min-plus Floyd-Warshall in place.
+// Returns the kernel actually used, or -1 if it is not supported here.
+int apspBlockedFloydWarshall(DistanceMatrix* m, ApspKernel kernel);
+
+typedef enum {
+    APSP_STRATEGY_FLOYD = 0,
+    APSP_STRATEGY_PARALLEL_DIJKSTRA
+} ApspStrategy;
+
+/*
+ * Cost model for choosing an all-pairs strategy, calibrated with
+ * "airline --bench apsp" and "--bench dijkstra" on one core:
+ *   blocked Floyd-Warshall  ~ V^3 cell updates
+ *   Dijkstra per source     ~ (V + arcs) * log2(V) heap/relax steps
+ * The Dijkstra side is divided by the worker count.
+ */
+#define APSP_NS_PER_FLOYD_UPDATE_SCALAR 0.75
+#define APSP_NS_PER_FLOYD_UPDATE_AVX2 0.25
+#define APSP_NS_PER_FLOYD_UPDATE_AVX512 0.15
+#define APSP_NS_PER_DIJKSTRA_STEP 1.5
+#define APSP_POOL_STARTUP_NS 20000.0
+
+double apspEstimateFloydNs(int vertexCount, ApspKernel kernel);
+double apspEstimateDijkstraNs(int vertexCount, long arcCount, int threads);
+ApspStrategy apspChooseStrategy(int vertexCount, long arcCount, int threads, ApspKernel kernel);
+const char* apspStrategyName(ApspStrategy strategy);
+
+// One dijkstraCsr per source spread over the pool; row s of m receives distances from s.
+// m must already be initialised for csr->vertexCount vertices. Returns 0 or -1.
+int apspParallelDijkstra(DistanceMatrix* m, const CsrGraph* csr, WorkPool* pool);
+
+// Fills m (uninitialised on entry) with all-pairs distances using the cheaper strategy.
+// pool may be NULL, which forces Floyd-Warshall. Returns the strategy used or -1.
+int apspAllPairs(DistanceMatrix* m, const RouteGraph* graph, const CsrGraph* csr, WorkPool* pool);
+
+#endif // APSP_H
@@ -0,0 +1,57 @@
+#include "arena.h"
+#include <stdlib.h>
+#include <string.h>
+
+static int growDirectory(RecordArena* arena, size_t needed) {
+    size_t size = arena->directorySize ? arena->directorySize : 16;
+    while (size < needed) size *= 2;
+    char** chunks = (char**)realloc(arena->chunks, sizeof(char*) * size);
+    if (!chunks) return -1;
+    arena->chunks = chunks;
+    arena->directorySize = size;
+    return 0;
+}
+
+int recordArenaReserve(RecordArena* arena, size_t records) {
+    size_t chunkRecords = (size_t)1 << arena->chunkShift;
+    size_t neededChunks = (records + chunkRecords - 1) >> arena->chunkShift;
+    if (neededChunks <= arena->chunkCount) return 0;
+    if (neededChunks > arena->directorySize && growDirectory(arena, neededChunks) != 0) return -1;
+    while (arena->chunkCount < neededChunks) {
+        // calloc lets large chunks come straight from zeroed pages
+        char* chunk = (char*)calloc(chunkRecords, arena->recordSize);
+        if (!chunk) return -1;
+        arena->chunks[arena->chunkCount++] = chunk;
+    }
+    return 0;
+}
+
+int recordArenaAdopt(RecordArena* arena, char* base, size_t records) {
+    if (arena->chunkCount != 0) return -1;
+    size_t chunkRecords = (size_t)1 << arena->chunkShift;
+    size_t chunkBytes = chunkRecords * arena->recordSize;
+    size_t fullChunks = records >> arena->chunkShift;
+    size_t tail = records & (chunkRecords - 1);
+    if (growDirectory(arena, fullChunks + 1) != 0) return -1;
+    for (size_t i = 0; i < fullChunks; ++i) {
+        arena->chunks[i] = base + i * chunkBytes;
+    }
+    arena->chunkCount = fullChunks;
+    arena->borrowedChunks = fullChunks;
+    if (tail > 0) {
+        if (recordArenaReserve(arena, records) != 0) return -1;
+        memcpy(arena->chunks[fullChunks], base + fullChunks * chunkBytes, tail * arena->recordSize);
+    }
+    return 0;
+}
+
+void recordArenaFree(RecordArena* arena) {
+    for (size_t i = arena->borrowedChunks; i < arena->chunkCount; ++i) {
+        free(arena->chunks[i]);
+    }
+    free(arena->chunks);
+    arena->chunks = NULL;
+    arena->chunkCount = 0;
+    arena->directorySize = 0;
+    arena->borrowedChunks = 0;
+}
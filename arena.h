@@ -0,0 +1,47 @@
+#ifndef ARENA_H
+#define ARENA_H
+
+#include <stddef.h>
+
+/*
+ * Chunked record arena: fixed-size records carved out of large chunks.
+ * Growing only appends a chunk and (rarely) grows the small chunk
+ * directory, so existing records are never moved or copied and pointers
+ * to them stay valid for the arena's lifetime.
+ */
+typedef struct {
+    size_t recordSize;
+    unsigned chunkShift;  // records per chunk = 1 << chunkShift
+    char** chunks;
+    size_t chunkCount;
+    size_t directorySize;  // allocated entries in chunks[]
+    size_t borrowedChunks; // leading chunks that point into memory the arena does not own
+} RecordArena;
+
+#define RECORD_ARENA_INIT(type, shift) { sizeof(type), (shift), NULL, 0, 0, 0 }
+
+// Slot for an index known to be below recordArenaCapacity().
+static inline void* recordArenaAt(const RecordArena* arena, size_t index) {
+    size_t mask = ((size_t)1 << arena->chunkShift) - 1;
+    return arena->chunks[index >> arena->chunkShift] + (index & mask) * arena->recordSize;
+}
+
+static inline size_t recordArenaCapacity(const RecordArena* arena) {
+    return arena->chunkCount << arena->chunkShift;
+}
+
+int recordArenaReserve(RecordArena* arena, size_t records);
+// Points an empty arena at `records` contiguous records in base (e.g. an mmap'd
+// snapshot) without copying whole chunks; only the partial tail chunk is copied.
+int recordArenaAdopt(RecordArena* arena, char* base, size_t records);
+
+// Slot for index, allocating zeroed chunks as needed. NULL on allocation failure.
+static inline void* recordArenaSlot(RecordArena* arena, size_t index) {
+    if (index >= recordArenaCapacity(arena) && recordArenaReserve(arena, index + 1) != 0) {
+        return NULL;
+    }
+    return recordArenaAt(arena, index);
+}
+void recordArenaFree(RecordArena* arena);
+
+#endif // ARENA_H
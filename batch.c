@@ -0,0 +1,183 @@
+#include "batch.h"
+#include "airline.h"
+#include "linereader.h"
+#include "persist.h"
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#define BATCH_MAX_FIELDS 12
+
+static double batchNowSeconds(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+// Splits line in place on ','; returns the number of fields.
+static int splitFields(char* line, char* fields[], int maxFields) {
+    int count = 0;
+    fields[count++] = line;
+    for (char* c = line; *c; ++c) {
+        if (*c == ',') {
+            *c = '\0';
+            if (count == maxFields) return -1;
+            fields[count++] = c + 1;
+        }
+    }
+    return count;
+}
+
+static int copyField(char* dst, size_t cap, const char* src) {
+    size_t len = strlen(src);
+    if (len == 0 || len >= cap) return -1;
+    memcpy(dst, src, len + 1);
+    return 0;
+}
+
+static int parseIntField(const char* src, int* out) {
+    char* end;
+    long value = strtol(src, &end, 10);
+    if (end == src || *end != '\0') return -1;
+    *out = (int)value;
+    return 0;
+}
+
+static void batchFlight(char* fields[], int count, BatchSummary* summary) {
+    Flight f;
+    memset(&f, 0, sizeof(f));
+    char* end;
+    if (count != 10 || copyField(f.flightNumber, sizeof(f.flightNumber), fields[1]) ||
+        copyField(f.origin, sizeof(f.origin), fields[2]) || copyField(f.destination, sizeof(f.destination), fields[3]) ||
+        copyField(f.departureTime, sizeof(f.departureTime), fields[4]) ||
+        copyField(f.arrivalTime, sizeof(f.arrivalTime), fields[5]) ||
+        copyField(f.aircraft, sizeof(f.aircraft), fields[6]) || parseIntField(fields[7], &f.capacity) ||
+        parseIntField(fields[9], &f.priority) || f.capacity < 0) {
+        summary->malformed++;
+        return;
+    }
+    f.price = strtof(fields[8], &end);
+    if (end == fields[8] || *end != '\0') {
+        summary->malformed++;
+        return;
+    }
+    switch (createFlight(&f, NULL)) {
+        case BOOKING_OK: summary->flightsAccepted++; break;
+        case BOOKING_DUPLICATE_ID: summary->flightsDuplicate++; break;
+        default: summary->otherErrors++; break;
+    }
+}
+
+static void batchBooking(char* fields[], int count, BatchSummary* summary) {
+    Passenger p;
+    char flightNumber[FLIGHT_ID_LEN];
+    memset(&p, 0, sizeof(p));
+    if (count != 7 || copyField(p.id, sizeof(p.id), fields[1]) || copyField(p.firstName, sizeof(p.firstName), fields[2]) ||
+        copyField(p.lastName, sizeof(p.lastName), fields[3]) || copyField(p.email, sizeof(p.email), fields[4]) ||
+        copyField(p.phone, sizeof(p.phone), fields[5]) || copyField(flightNumber, sizeof(flightNumber), fields[6])) {
+        summary->malformed++;
+        return;
+    }
+    switch (bookPassenger(&p, flightNumber, NULL)) {
+        case BOOKING_OK: summary->bookingsAccepted++; break;
+        case BOOKING_FLIGHT_FULL: summary->bookingsFull++; break;
+        case BOOKING_FLIGHT_NOT_FOUND: summary->bookingsUnknownFlight++; break;
+        case BOOKING_DUPLICATE_ID: summary->bookingsDuplicate++; break;
+        default: summary->otherErrors++; break;
+    }
+}
+
+static void batchCheckIn(char* fields[], int count, BatchSummary* summary) {
+    int priority;
+    if (count != 3 || parseIntField(fields[2], &priority) || priority < 1) {
+        summary->malformed++;
+        return;
+    }
+    int idx = findPassengerIndex(fields[1]);
+    if (idx == -1) {
+        summary->checkInsUnknownPassenger++;
+        return;
+    }
+    switch (checkInBooking(idx, priority)) {
+        case BOOKING_OK: summary->checkInsAccepted++; break;
+        case BOOKING_NOT_CONFIRMED: summary->checkInsNotConfirmed++; break;
+        case BOOKING_SEAT_UNAVAILABLE: summary->checkInsNoSeat++; break;
+        default: summary->otherErrors++; break;
+    }
+}
+
+static void batchLine(char* line, size_t len, BatchSummary* summary) {
+    if (len > 0 && line[len - 1] == '\r') line[--len] = '\0';
+    summary->lines++;
+    if (len == 0 || line[0] == '#') return;
+    char* fields[BATCH_MAX_FIELDS];
+    int count = splitFields(line, fields, BATCH_MAX_FIELDS);
+    if (count < 1 || fields[0][0] == '\0' || fields[0][1] != '\0') {
+        summary->malformed++;
+        return;
+    }
+    switch (fields[0][0]) {
+        case 'F': batchFlight(fields, count, summary); break;
+        case 'B': batchBooking(fields, count, summary); break;
+        case 'C': batchCheckIn(fields, count, summary); break;
+        default: summary->malformed++; break;
+    }
+}
+
+// Lines longer than the reader's buffer arrive as NULL and count as malformed.
+static void batchReaderLine(void* ctx, char* line, size_t len) {
+    BatchSummary* summary = (BatchSummary*)ctx;
+    if (!line) {
+        summary->lines++;
+        summary->malformed++;
+        return;
+    }
+    batchLine(line, len, summary);
+}
+
+int runBatchStream(FILE* in, BatchSummary* summary) {
+    memset(summary, 0, sizeof(*summary));
+    double start = batchNowSeconds();
+    // One log sync for the whole stream instead of one per row
+    persistBeginBatch();
+    int status = lineReaderRun(in, batchReaderLine, summary);
+    if (persistEndBatch() != 0) summary->otherErrors++;
+    summary->seconds = batchNowSeconds() - start;
+    return status;
+}
+
+void printBatchSummary(const BatchSummary* s) {
+    long bookingRows = s->bookingsAccepted + s->bookingsFull + s->bookingsUnknownFlight + s->bookingsDuplicate;
+    printf("\n=== BATCH SUMMARY ===\n");
+    printf("Lines read:          %ld (%.3f s, %.0f lines/s)\n", s->lines, s->seconds,
+           s->seconds > 0 ? s->lines / s->seconds : 0.0);
+    printf("Flights accepted:    %ld\n", s->flightsAccepted);
+    printf("Flights rejected:    %ld (duplicate number)\n", s->flightsDuplicate);
+    printf("Bookings accepted:   %ld of %ld\n", s->bookingsAccepted, bookingRows);
+    printf("  rejected full:     %ld\n", s->bookingsFull);
+    printf("  unknown flight:    %ld\n", s->bookingsUnknownFlight);
+    printf("  duplicate ID:      %ld\n", s->bookingsDuplicate);
+    long checkInRows = s->checkInsAccepted + s->checkInsUnknownPassenger + s->checkInsNotConfirmed + s->checkInsNoSeat;
+    printf("Check-ins queued:    %ld of %ld\n", s->checkInsAccepted, checkInRows);
+    printf("  unknown passenger: %ld\n", s->checkInsUnknownPassenger);
+    printf("  not confirmed:     %ld\n", s->checkInsNotConfirmed);
+    printf("  no seat free:      %ld\n", s->checkInsNoSeat);
+    printf("Malformed rows:      %ld\n", s->malformed);
+    if (s->otherErrors) printf("Other errors:        %ld\n", s->otherErrors);
+}
+
+int runBatchFile(const char* path) {
+    FILE* in = strcmp(path, "-") == 0 ? stdin : fopen(path, "rb");
+    if (!in) {
+        printf("Unable to open batch file: %s\n", path);
+        return 1;
+    }
+    BatchSummary summary;
+    int status = runBatchStream(in, &summary);
+    if (in != stdin) fclose(in);
+    if (status != 0) {
+        printf("Error while reading batch input.\n");
+    }
+    printBatchSummary(&summary);
+    return status == 0 ? 0 : 1;
+}
@@ -0,0 +1,36 @@
+#ifndef BATCH_H
+#define BATCH_H
+
+#include <stdio.h>
+
+/*
+ * Non-interactive batch input, one command per line (CSV, '#' comments):
+ *   F,flightNumber,origin,destination,departure,arrival,aircraft,capacity,price,priority
+ *   B,passengerId,firstName,lastName,email,phone,flightNumber
+ *   C,passengerId,priority
+ * Rows go through the same core calls as the menus (createFlight,
+ * bookPassenger, checkInBooking).
+ */
+typedef struct {
+    long lines;
+    long flightsAccepted;
+    long flightsDuplicate;
+    long bookingsAccepted;
+    long bookingsFull;
+    long bookingsUnknownFlight;
+    long bookingsDuplicate;
+    long checkInsAccepted;
+    long checkInsUnknownPassenger;
+    long checkInsNotConfirmed; // waitlisted or cancelled ticket
+    long checkInsNoSeat;       // unseated ticket on an overbooked flight
+    long malformed;
+    long otherErrors;
+    double seconds;
+} BatchSummary;
+
+int runBatchStream(FILE* in, BatchSummary* summary);
+// Reads path ("-" for stdin), prints the summary; returns 0 on success.
+int runBatchFile(const char* path);
+void printBatchSummary(const BatchSummary* summary);
+
+#endif // BATCH_H
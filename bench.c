@@ -0,0 +1,2123 @@
+#include "bench.h"
+#include "benchkit.h"
+#include "airline.h"
+#include "hashindex.h"
+#include "arena.h"
+#include "checkinqueue.h"
+#include "nodepool.h"
+#include "mpmcring.h"
+#include "batch.h"
+#include "persist.h"
+#include "stores.h"
+#include "routegraph.h"
+#include "apsp.h"
+#include "routenetwork.h"
+#include "routequery.h"
+#include "journey.h"
+#include "routeupdate.h"
+#include "spanningtree.h"
+#include "storequery.h"
+#include "seatmap.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <time.h>
+#include <stdatomic.h>
+#include <pthread.h>
+#include <sched.h>
+#ifndef _WIN32
+#include <unistd.h>
+#include <sys/wait.h>
+#endif
+
+typedef void (*BenchFn)(long size);
+
+typedef struct {
+    const char* name;
+    const char* description;
+    BenchFn run;
+} BenchCase;
+
+/* ---------- Hash index lookup ---------- */
+
+#define BENCH_KEY_LEN 16
+
+static const char* benchKeyAt(void* ctx, int index) {
+    return (const char*)ctx + (size_t)index * BENCH_KEY_LEN;
+}
+
+static void benchHashIndex(long maxRecords) {
+    if (maxRecords <= 0) maxRecords = 10000000;
+    const int lookups = 1000000;
+    printf("%-12s %-14s %-14s %-14s\n", "Records", "Build (ms)", "Hit (ns/op)", "Miss (ns/op)");
+    for (long n = 1000; n <= maxRecords; n *= 10) {
+        char* keys = (char*)malloc((size_t)n * BENCH_KEY_LEN);
+        int* probes = (int*)malloc(sizeof(int) * lookups);
+        char* missKeys = (char*)malloc((size_t)lookups * BENCH_KEY_LEN);
+        if (!keys || !probes || !missKeys) {
+            printf("%-12ld allocation failed\n", n);
+            free(keys);
+            free(probes);
+            free(missKeys);
+            break;
+        }
+        for (long i = 0; i < n; ++i) {
+            snprintf(keys + (size_t)i * BENCH_KEY_LEN, BENCH_KEY_LEN, "P%09d", (int)i);
+        }
+        uint64_t rng = 0x9E3779B97F4A7C15ull;
+        for (int i = 0; i < lookups; ++i) {
+            probes[i] = (int)(benchRandom(&rng) % (uint64_t)n);
+            snprintf(missKeys + (size_t)i * BENCH_KEY_LEN, BENCH_KEY_LEN, "X%09d", probes[i]);
+        }
+
+        HashIndex index;
+        hashIndexInit(&index, benchKeyAt, keys);
+        uint64_t t0 = benchNowNs();
+        hashIndexReserve(&index, (size_t)n);
+        for (long i = 0; i < n; ++i) hashIndexInsert(&index, (int)i);
+        uint64_t t1 = benchNowNs();
+
+        long found = 0;
+        for (int i = 0; i < lookups; ++i) {
+            found += hashIndexFind(&index, keys + (size_t)probes[i] * BENCH_KEY_LEN) >= 0;
+        }
+        uint64_t t2 = benchNowNs();
+
+        for (int i = 0; i < lookups; ++i) {
+            found += hashIndexFind(&index, missKeys + (size_t)i * BENCH_KEY_LEN) >= 0;
+        }
+        uint64_t t3 = benchNowNs();
+
+        printf("%-12ld %-14.2f %-14.1f %-14.1f%s\n", n, (t1 - t0) / 1e6, (double)(t2 - t1) / lookups,
+               (double)(t3 - t2) / lookups, found == lookups ? "" : "  (lookup mismatch!)");
+        hashIndexFree(&index);
+        free(keys);
+        free(probes);
+        free(missKeys);
+    }
+}
+
+/* ---------- Passenger store growth ---------- */
+
+static void fillBenchPassenger(Passenger* p, const Passenger* tmpl, long i) {
+    *p = *tmpl;
+    // cheap unique id without snprintf on the hot path
+    for (int d = 9; d >= 1; --d) {
+        p->id[d] = (char)('0' + i % 10);
+        i /= 10;
+    }
+}
+
+static void benchArena(long records) {
+    if (records <= 0) records = 50000000;
+    Passenger tmpl;
+    memset(&tmpl, 0, sizeof(tmpl));
+    strcpy(tmpl.id, "P000000000");
+    strcpy(tmpl.firstName, "Bench");
+    strcpy(tmpl.lastName, "Passenger");
+    strcpy(tmpl.email, "bench@example.com");
+    strcpy(tmpl.phone, "5550000");
+    tmpl.flightIndex = 0;
+    tmpl.checkInStatus = CHECKIN_PENDING;
+    double mb = (double)records * sizeof(Passenger) / (1024.0 * 1024.0);
+
+    RecordArena arena = RECORD_ARENA_INIT(Passenger, 12);
+    uint64_t t0 = benchNowNs();
+    for (long i = 0; i < records; ++i) {
+        Passenger* p = (Passenger*)recordArenaSlot(&arena, (size_t)i);
+        if (!p) {
+            printf("Arena allocation failed at %ld records\n", i);
+            break;
+        }
+        fillBenchPassenger(p, &tmpl, i);
+    }
+    uint64_t t1 = benchNowNs();
+    recordArenaFree(&arena);
+
+    Passenger* array = NULL;
+    size_t capacity = 0;
+    uint64_t t2 = benchNowNs();
+    for (long i = 0; i < records; ++i) {
+        if ((size_t)i == capacity) {
+            size_t next = capacity ? capacity * 2 : 1024;
+            Passenger* grown = (Passenger*)realloc(array, sizeof(Passenger) * next);
+            if (!grown) {
+                printf("realloc failed at %ld records\n", i);
+                break;
+            }
+            array = grown;
+            capacity = next;
+        }
+        fillBenchPassenger(&array[i], &tmpl, i);
+    }
+    uint64_t t3 = benchNowNs();
+    free(array);
+
+    printf("%-22s %-14s %-12s %-12s\n", "Store", "Records", "Time (ms)", "MB/s");
+    printf("%-22s %-14ld %-12.1f %-12.0f\n", "chunked arena", records, (t1 - t0) / 1e6, mb / ((t1 - t0) / 1e9));
+    printf("%-22s %-14ld %-12.1f %-12.0f\n", "realloc doubling", records, (t3 - t2) / 1e6, mb / ((t3 - t2) / 1e9));
+}
+
+/* ---------- Check-in priority queue ---------- */
+
+static void benchCheckInQueue(long pairs) {
+    if (pairs <= 0) pairs = 1000000;
+    CheckInNode* nodes = (CheckInNode*)malloc(sizeof(CheckInNode) * (size_t)pairs);
+    if (!nodes) {
+        printf("allocation failed\n");
+        return;
+    }
+    uint64_t rng = 0xC0FFEEull;
+    for (long i = 0; i < pairs; ++i) {
+        nodes[i].passengerIndex = (int)i;
+        nodes[i].priority = 1 + (int)(benchRandom(&rng) % 8);
+        nodes[i].sequence = (uint64_t)i;
+        nodes[i].checkInTime = 0;
+    }
+
+    // Bulk: enqueue everything, then drain and verify (priority, FIFO) order
+    CheckInQueue queue = CHECKIN_QUEUE_INIT;
+    uint64_t t0 = benchNowNs();
+    for (long i = 0; i < pairs; ++i) checkInQueuePush(&queue, &nodes[i]);
+    uint64_t t1 = benchNowNs();
+    long misordered = 0;
+    const CheckInNode* prev = NULL;
+    for (long i = 0; i < pairs; ++i) {
+        const CheckInNode* n = checkInQueuePop(&queue);
+        if (prev && (n->priority < prev->priority ||
+                     (n->priority == prev->priority && n->passengerIndex < prev->passengerIndex))) {
+            ++misordered;
+        }
+        prev = n;
+    }
+    uint64_t t2 = benchNowNs();
+
+    // Steady state: a counter rush with ~1000 passengers waiting
+    const long depth = pairs < 1000 ? pairs : 1000;
+    for (long i = 0; i < depth; ++i) checkInQueuePush(&queue, &nodes[i]);
+    uint64_t t3 = benchNowNs();
+    for (long i = 0; i < pairs; ++i) {
+        checkInQueuePush(&queue, &nodes[i]);
+        checkInQueuePop(&queue);
+    }
+    uint64_t t4 = benchNowNs();
+    checkInQueueFree(&queue);
+
+    // Node lifecycle at the same depth: malloc/free per request vs the pooled slab
+    CheckInQueue mq = CHECKIN_QUEUE_INIT;
+    for (long i = 0; i < depth; ++i) {
+        CheckInNode* n = (CheckInNode*)malloc(sizeof(CheckInNode));
+        *n = nodes[i];
+        checkInQueuePush(&mq, n);
+    }
+    uint64_t t5 = benchNowNs();
+    for (long i = 0; i < pairs; ++i) {
+        CheckInNode* n = (CheckInNode*)malloc(sizeof(CheckInNode));
+        *n = nodes[i];
+        checkInQueuePush(&mq, n);
+        free(checkInQueuePop(&mq));
+    }
+    uint64_t t6 = benchNowNs();
+    CheckInNode* leftover;
+    while ((leftover = checkInQueuePop(&mq)) != NULL) free(leftover);
+    checkInQueueFree(&mq);
+
+    NodePool pool = NODE_POOL_INIT(CheckInNode, 10);
+    nodePoolReserve(&pool, 1024);
+    CheckInQueue pq = CHECKIN_QUEUE_INIT;
+    for (long i = 0; i < depth; ++i) {
+        CheckInNode* n = (CheckInNode*)nodePoolAlloc(&pool);
+        *n = nodes[i];
+        checkInQueuePush(&pq, n);
+    }
+    uint64_t t7 = benchNowNs();
+    for (long i = 0; i < pairs; ++i) {
+        CheckInNode* n = (CheckInNode*)nodePoolAlloc(&pool);
+        *n = nodes[i];
+        checkInQueuePush(&pq, n);
+        nodePoolRelease(&pool, checkInQueuePop(&pq));
+    }
+    uint64_t t8 = benchNowNs();
+    checkInQueueFree(&pq);
+    free(nodes);
+
+    printf("%-28s %-12s %-12s\n", "Phase", "Ops", "ns/op");
+    printf("%-28s %-12ld %-12.1f\n", "bulk enqueue", pairs, (double)(t1 - t0) / pairs);
+    printf("%-28s %-12ld %-12.1f\n", "bulk dequeue", pairs, (double)(t2 - t1) / pairs);
+    printf("%-28s %-12ld %-12.1f\n", "enqueue+dequeue @depth 1000", pairs, (double)(t4 - t3) / pairs);
+    printf("%-28s %-12ld %-12.1f\n", "  + malloc/free per node", pairs, (double)(t6 - t5) / pairs);
+    printf("%-28s %-12ld %-12.1f\n", "  + pooled node", pairs, (double)(t8 - t7) / pairs);
+    printf("Order check: %s\n", misordered ? "FAILED" : "priority/FIFO order preserved");
+    printf("Pool: hits %zu, misses %zu, peak in use %zu\n", pool.hits, pool.misses, pool.peakInUse);
+    nodePoolFree(&pool);
+}
+
+/* ---------- Concurrent check-in (pthreads stress) ---------- */
+
+typedef struct {
+    int useService;       // 0 = raw MPMC ring, 1 = enqueueCheckIn/dequeueCheckIn
+    long perProducer;
+    long total;
+    MpmcRing* ring;
+    atomic_long consumed;
+    atomic_ullong checksum;
+} CheckInStress;
+
+typedef struct {
+    CheckInStress* shared;
+    int id;
+} CheckInStressArg;
+
+static void* checkInProducer(void* raw) {
+    CheckInStressArg* arg = (CheckInStressArg*)raw;
+    CheckInStress* st = arg->shared;
+    long base = (long)arg->id * st->perProducer;
+    for (long i = 0; i < st->perProducer; ++i) {
+        long value = base + i;
+        if (st->useService) {
+            while (enqueueCheckIn((int)value, 1 + (int)(value & 3)) != 0) sched_yield();
+        } else {
+            while (mpmcRingPush(st->ring, (void*)(intptr_t)(value + 1)) != 0) sched_yield();
+        }
+    }
+    return NULL;
+}
+
+static void* checkInConsumer(void* raw) {
+    CheckInStress* st = ((CheckInStressArg*)raw)->shared;
+    unsigned long long sum = 0;
+    while (atomic_load_explicit(&st->consumed, memory_order_relaxed) < st->total) {
+        long value;
+        if (st->useService) {
+            CheckInNode node;
+            if (dequeueCheckIn(&node) != 0) {
+                sched_yield();
+                continue;
+            }
+            value = node.passengerIndex;
+        } else {
+            void* item = mpmcRingPop(st->ring);
+            if (!item) {
+                sched_yield();
+                continue;
+            }
+            value = (long)(intptr_t)item - 1;
+        }
+        sum += (unsigned long long)value;
+        atomic_fetch_add_explicit(&st->consumed, 1, memory_order_relaxed);
+    }
+    atomic_fetch_add(&st->checksum, sum);
+    return NULL;
+}
+
+static double runCheckInStress(int useService, int producers, int consumers, long total, int* ok) {
+    CheckInStress st;
+    MpmcRing ring;
+    st.useService = useService;
+    st.perProducer = total / producers;
+    st.total = st.perProducer * producers;
+    st.ring = &ring;
+    atomic_init(&st.consumed, 0);
+    atomic_init(&st.checksum, 0);
+    if (!useService && mpmcRingInit(&ring, 4096) != 0) {
+        *ok = 0;
+        return 0.0;
+    }
+    pthread_t threads[32];
+    CheckInStressArg args[32];
+    uint64_t t0 = benchNowNs();
+    for (int i = 0; i < consumers; ++i) {
+        args[i].shared = &st;
+        args[i].id = i;
+        pthread_create(&threads[i], NULL, checkInConsumer, &args[i]);
+    }
+    for (int i = 0; i < producers; ++i) {
+        args[consumers + i].shared = &st;
+        args[consumers + i].id = i;
+        pthread_create(&threads[consumers + i], NULL, checkInProducer, &args[consumers + i]);
+    }
+    for (int i = 0; i < producers + consumers; ++i) pthread_join(threads[i], NULL);
+    uint64_t t1 = benchNowNs();
+    if (!useService) mpmcRingFree(&ring);
+    unsigned long long n = (unsigned long long)st.total;
+    *ok = atomic_load(&st.checksum) == n * (n - 1) / 2;
+    return (double)st.total / ((t1 - t0) / 1e9) / 1e6;
+}
+
+static void benchCheckInThreads(long total) {
+    if (total <= 0) total = 4000000;
+    static const int mixes[][2] = {{1, 1}, {2, 1}, {4, 1}, {2, 2}, {4, 4}, {8, 8}, {16, 16}};
+    int mixCount = (int)(sizeof(mixes) / sizeof(mixes[0]));
+    printf("%-10s %-10s %-18s %-18s\n", "Producers", "Consumers", "Ring (Mops/s)", "Service (Mops/s)");
+    for (int m = 0; m < mixCount; ++m) {
+        int okRing = 0, okService = 0;
+        double ring = runCheckInStress(0, mixes[m][0], mixes[m][1], total, &okRing);
+        double service = runCheckInStress(1, mixes[m][0], mixes[m][1], total / 4, &okService);
+        printf("%-10d %-10d %-18.2f %-18.2f%s\n", mixes[m][0], mixes[m][1], ring, service,
+               okRing && okService ? "" : "  (checksum mismatch!)");
+    }
+}
+
+/* ---------- Concurrent seat inventory ---------- */
+
+#define BENCH_HOT_FLIGHTS 4
+
+typedef struct {
+    int flightIdx[BENCH_HOT_FLIGHTS];
+    long attempts;
+    int fullPath;          // 0 = reserveSeats only, 1 = bookPassenger with a new passenger each time
+    int useGlobalMutex;    // baseline: one lock around a plain counter
+    int run;
+    int mutexBooked[BENCH_HOT_FLIGHTS];
+    int capacity;
+    pthread_mutex_t lock;
+    atomic_long accepted;
+} BookingStress;
+
+typedef struct {
+    BookingStress* shared;
+    int id;
+} BookingStressArg;
+
+static void* bookingWorker(void* raw) {
+    BookingStressArg* arg = (BookingStressArg*)raw;
+    BookingStress* st = arg->shared;
+    uint64_t rng = 0x51ED27ull + (uint64_t)arg->id * 7919u;
+    long accepted = 0;
+    Passenger details;
+    memset(&details, 0, sizeof(details));
+    strcpy(details.firstName, "Load");
+    strcpy(details.lastName, "Test");
+    for (long i = 0; i < st->attempts; ++i) {
+        int k = (int)(benchRandom(&rng) % BENCH_HOT_FLIGHTS);
+        if (st->useGlobalMutex) {
+            pthread_mutex_lock(&st->lock);
+            if (st->mutexBooked[k] < st->capacity) {
+                st->mutexBooked[k]++;
+                ++accepted;
+            }
+            pthread_mutex_unlock(&st->lock);
+        } else if (st->fullPath) {
+            snprintf(details.id, sizeof(details.id), "B%d-%d-%ld", st->run, arg->id, i);
+            accepted += bookPassenger(&details, flightAt(st->flightIdx[k])->flightNumber, NULL) == BOOKING_OK;
+        } else {
+            accepted += reserveSeats(st->flightIdx[k], 1) == 0;
+        }
+    }
+    atomic_fetch_add(&st->accepted, accepted);
+    return NULL;
+}
+
+static int runBookingStress(BookingStress* st, int threads, double* ratePerSec) {
+    static int runCounter = 0;
+    st->run = ++runCounter;
+    atomic_init(&st->accepted, 0);
+    for (int k = 0; k < BENCH_HOT_FLIGHTS; ++k) {
+        Flight f;
+        memset(&f, 0, sizeof(f));
+        snprintf(f.flightNumber, sizeof(f.flightNumber), "HT%02d%02d", st->run % 100, k);
+        strcpy(f.origin, "DEL");
+        strcpy(f.destination, "BOM");
+        f.capacity = st->capacity;
+        if (createFlight(&f, &st->flightIdx[k]) != BOOKING_OK) return 0;
+        st->mutexBooked[k] = 0;
+    }
+    pthread_t tids[64];
+    BookingStressArg args[64];
+    uint64_t t0 = benchNowNs();
+    for (int t = 0; t < threads; ++t) {
+        args[t].shared = st;
+        args[t].id = t;
+        pthread_create(&tids[t], NULL, bookingWorker, &args[t]);
+    }
+    for (int t = 0; t < threads; ++t) pthread_join(tids[t], NULL);
+    uint64_t t1 = benchNowNs();
+    *ratePerSec = (double)st->attempts * threads / ((t1 - t0) / 1e9);
+
+    // Exactness: accepted bookings must equal seats taken, and no flight may exceed capacity
+    long booked = 0;
+    int oversold = 0;
+    for (int k = 0; k < BENCH_HOT_FLIGHTS; ++k) {
+        int seats = st->useGlobalMutex ? st->mutexBooked[k] : st->capacity - flightSeatsLeft(st->flightIdx[k]);
+        booked += seats;
+        oversold |= seats > st->capacity;
+    }
+    return !oversold && booked == atomic_load(&st->accepted);
+}
+
+static void benchBookingThreads(long attempts) {
+    if (attempts <= 0) attempts = 1000000;
+    static const int threadCounts[] = {1, 2, 4, 8, 16};
+    printf("%d hot flights; capacity sized so they sell out part-way through each run\n", BENCH_HOT_FLIGHTS);
+    printf("%-8s %-20s %-20s %-20s\n", "Threads", "CAS seats (M/s)", "Global mutex (M/s)", "Full booking (M/s)");
+    for (size_t i = 0; i < sizeof(threadCounts) / sizeof(threadCounts[0]); ++i) {
+        int threads = threadCounts[i];
+        BookingStress st;
+        pthread_mutex_init(&st.lock, NULL);
+        st.attempts = attempts / threads;
+        st.capacity = (int)(st.attempts * threads / BENCH_HOT_FLIGHTS * 3 / 4);
+        double cas = 0, mutex = 0, full = 0;
+        st.fullPath = 0;
+        st.useGlobalMutex = 0;
+        int ok = runBookingStress(&st, threads, &cas);
+        st.useGlobalMutex = 1;
+        ok &= runBookingStress(&st, threads, &mutex);
+        st.useGlobalMutex = 0;
+        st.fullPath = 1;
+        st.attempts /= 10; // every accepted booking also stores a passenger record
+        st.capacity = (int)(st.attempts * threads / BENCH_HOT_FLIGHTS * 3 / 4);
+        ok &= runBookingStress(&st, threads, &full);
+        pthread_mutex_destroy(&st.lock);
+        printf("%-8d %-20.2f %-20.2f %-20.2f%s\n", threads, cas / 1e6, mutex / 1e6, full / 1e6,
+               ok ? "" : "  (seat count mismatch!)");
+    }
+}
+
+/* ---------- Cancellation and waitlists ---------- */
+
+#define WAITLIST_BENCH_THREADS 8
+
+typedef struct {
+    int firstFlight;
+    int flights;
+    long opsPerThread;
+    int run;
+    atomic_long booked;
+    atomic_long waitlisted;
+    atomic_long cancelled;
+    atomic_long promoted;
+    atomic_long overbookChanges;
+} WaitlistStress;
+
+typedef struct {
+    WaitlistStress* shared;
+    int id;
+} WaitlistStressArg;
+
+// Each thread books, cancels its own earlier bookings and occasionally moves an overbooking limit.
+static void* waitlistWorker(void* raw) {
+    WaitlistStressArg* arg = (WaitlistStressArg*)raw;
+    WaitlistStress* st = arg->shared;
+    uint64_t rng = 0xCA9CE1ull + (uint64_t)arg->id * 104729u;
+    long booked = 0, waitlisted = 0, cancelled = 0, promoted = 0, overbook = 0;
+    long issued = 0;
+    Passenger details;
+    memset(&details, 0, sizeof(details));
+    strcpy(details.firstName, "Wait");
+    strcpy(details.lastName, "List");
+    char id[NAME_LEN];
+    for (long i = 0; i < st->opsPerThread; ++i) {
+        uint64_t r = benchRandom(&rng);
+        int flight = st->firstFlight + (int)(r % (uint64_t)st->flights);
+        int action = (int)((r >> 32) % 100);
+        if (action < 60 || issued == 0) {
+            snprintf(details.id, sizeof(details.id), "W%d-%d-%ld", st->run, arg->id, issued++);
+            int priority = (int)((r >> 40) % 4);
+            BookingStatus status = bookOrWaitlist(&details, flightAt(flight)->flightNumber, priority, NULL);
+            booked += status == BOOKING_OK;
+            waitlisted += status == BOOKING_WAITLISTED;
+        } else if (action < 98) {
+            snprintf(id, sizeof(id), "W%d-%d-%ld", st->run, arg->id, (long)((r >> 8) % (uint64_t)issued));
+            int next;
+            if (cancelBooking(id, &next) == BOOKING_OK) {
+                ++cancelled;
+                promoted += next != -1;
+            }
+        } else {
+            int moved = setOverbookLimit(flight, (int)((r >> 40) % 3));
+            if (moved >= 0) {
+                ++overbook;
+                promoted += moved;
+            }
+        }
+    }
+    atomic_fetch_add(&st->booked, booked);
+    atomic_fetch_add(&st->waitlisted, waitlisted);
+    atomic_fetch_add(&st->cancelled, cancelled);
+    atomic_fetch_add(&st->promoted, promoted);
+    atomic_fetch_add(&st->overbookChanges, overbook);
+    return NULL;
+}
+
+/*
+ * Recounts every ticket of the run's flights from the passenger records:
+ * confirmed tickets must match the booked-seat column, waitlisted ones the
+ * live waitlist length, and nobody may wait on a flight with a free seat.
+ */
+static int checkWaitlistInvariants(const WaitlistStress* st, int firstPassenger) {
+    int* confirmed = (int*)calloc((size_t)st->flights, sizeof(int));
+    int* waiting = (int*)calloc((size_t)st->flights, sizeof(int));
+    int bad = 0;
+    if (!confirmed || !waiting) {
+        free(confirmed);
+        free(waiting);
+        return -1;
+    }
+    for (int p = firstPassenger; p < passengerCount; ++p) {
+        const Passenger* passenger = passengerAt(p);
+        int f = passenger->flightIndex - st->firstFlight;
+        if (f < 0 || f >= st->flights) continue;
+        confirmed[f] += passenger->ticketStatus == TICKET_CONFIRMED;
+        waiting[f] += passenger->ticketStatus == TICKET_WAITLISTED;
+    }
+    for (int f = 0; f < st->flights; ++f) {
+        Flight row;
+        flightRow(st->firstFlight + f, &row);
+        int queued = waitlistLength(st->firstFlight + f);
+        if (confirmed[f] != row.bookedSeats || waiting[f] != queued || (queued > 0 && flightSeatsLeft(st->firstFlight + f) > 0)) {
+            ++bad;
+        }
+    }
+    free(confirmed);
+    free(waiting);
+    return bad;
+}
+
+static void benchWaitlist(long ops) {
+    if (ops <= 0) ops = 2000000;
+    static const int flightCounts[] = {1, 64, 4096};
+    static const int threadCounts[] = {1, 4, WAITLIST_BENCH_THREADS};
+    static int runCounter = 0;
+    printf("60%% book-or-waitlist, 38%% cancel own booking, 2%% overbooking change; capacity 4 per flight\n");
+    printf("%-8s %-8s %-14s %-10s %-10s %-10s %-10s %s\n", "Flights", "Threads", "Ops/s (M)", "Booked", "Waitlisted",
+           "Cancelled", "Promoted", "Invariants");
+    for (size_t fi = 0; fi < sizeof(flightCounts) / sizeof(flightCounts[0]); ++fi) {
+        for (size_t ti = 0; ti < sizeof(threadCounts) / sizeof(threadCounts[0]); ++ti) {
+            WaitlistStress st;
+            int threads = threadCounts[ti];
+            st.run = ++runCounter;
+            st.flights = flightCounts[fi];
+            st.opsPerThread = ops / threads;
+            st.firstFlight = flightCount;
+            atomic_init(&st.booked, 0);
+            atomic_init(&st.waitlisted, 0);
+            atomic_init(&st.cancelled, 0);
+            atomic_init(&st.promoted, 0);
+            atomic_init(&st.overbookChanges, 0);
+            for (int k = 0; k < st.flights; ++k) {
+                Flight f;
+                memset(&f, 0, sizeof(f));
+                snprintf(f.flightNumber, sizeof(f.flightNumber), "W%06u", (unsigned)(st.run * 10000 + k) % 1000000u);
+                strcpy(f.origin, "DEL");
+                strcpy(f.destination, "BOM");
+                f.capacity = 4;
+                if (createFlight(&f, NULL) != BOOKING_OK) {
+                    printf("Unable to create benchmark flights.\n");
+                    return;
+                }
+            }
+            int firstPassenger = passengerCount;
+            pthread_t tids[WAITLIST_BENCH_THREADS];
+            WaitlistStressArg args[WAITLIST_BENCH_THREADS];
+            uint64_t t0 = benchNowNs();
+            for (int t = 0; t < threads; ++t) {
+                args[t].shared = &st;
+                args[t].id = t;
+                pthread_create(&tids[t], NULL, waitlistWorker, &args[t]);
+            }
+            for (int t = 0; t < threads; ++t) pthread_join(tids[t], NULL);
+            uint64_t t1 = benchNowNs();
+            int bad = checkWaitlistInvariants(&st, firstPassenger);
+            printf("%-8d %-8d %-14.2f %-10ld %-10ld %-10ld %-10ld %s\n", st.flights, threads,
+                   (double)st.opsPerThread * threads / ((t1 - t0) / 1e9) / 1e6, atomic_load(&st.booked),
+                   atomic_load(&st.waitlisted), atomic_load(&st.cancelled), atomic_load(&st.promoted),
+                   bad == 0 ? "ok" : bad < 0 ? "out of memory" : "MISMATCH");
+        }
+    }
+}
+
+/* ---------- Seat maps ---------- */
+
+#define SEAT_BENCH_CAPACITY 853 // A380, all-economy layout
+#define SEAT_BENCH_HELD 64
+#define SEAT_BENCH_THREADS 8
+
+// Baseline: one byte per seat scanned front to back, over the same ten-abreast layout (ABC DEFG HJK)
+static int byteScanClaim(char* taken, int capacity, SeatPreference pref, int count) {
+    static const int blockStart[] = { 0, 3, 7 };
+    static const int blockEnd[] = { 3, 7, 10 };
+    for (int row = 0; row * 10 < capacity; ++row) {
+        for (int b = 0; b < 3; ++b) {
+            for (int letter = blockStart[b]; letter + count <= blockEnd[b]; ++letter) {
+                if (pref == SEAT_PREF_WINDOW && letter != 0 && letter != 9) continue;
+                if (pref == SEAT_PREF_AISLE && letter != blockStart[b] + (b == 0 ? 2 : 0) &&
+                    letter != blockEnd[b] - 1 - (b == 2 ? 2 : 0)) {
+                    continue;
+                }
+                int seat = row * 10 + letter;
+                int free = seat + count <= capacity;
+                for (int k = 0; k < count && free; ++k) free = !taken[seat + k];
+                if (!free) continue;
+                memset(taken + seat, 1, (size_t)count);
+                return seat;
+            }
+        }
+    }
+    return -1;
+}
+
+typedef struct {
+    SeatMap* map;
+    long ops;
+    int id;
+    int held[SEAT_BENCH_HELD];
+    int heldCount;
+    long claims;
+} SeatWorker;
+
+// Holds up to SEAT_BENCH_HELD seats, giving back the oldest to make room
+static void* seatChurnWorker(void* raw) {
+    SeatWorker* w = (SeatWorker*)raw;
+    uint64_t rng = 0x5EA7ull + (uint64_t)w->id * 6151u;
+    int head = 0;
+    for (long i = 0; i < w->ops; ++i) {
+        int seat = -1;
+        if (w->heldCount < SEAT_BENCH_HELD) seat = seatMapClaimFirst(w->map, SEAT_CABIN_ANY, (SeatPreference)(benchRandom(&rng) % 3));
+        if (seat != -1) {
+            w->held[(head + w->heldCount++) % SEAT_BENCH_HELD] = seat;
+            ++w->claims;
+        } else if (w->heldCount > 0) {
+            seatMapRelease(w->map, w->held[head]);
+            head = (head + 1) % SEAT_BENCH_HELD;
+            --w->heldCount;
+        }
+    }
+    // Compact the ring so the checker can read held[0..heldCount)
+    int ring[SEAT_BENCH_HELD];
+    for (int k = 0; k < w->heldCount; ++k) ring[k] = w->held[(head + k) % SEAT_BENCH_HELD];
+    memcpy(w->held, ring, sizeof(int) * (size_t)w->heldCount);
+    return NULL;
+}
+
+static void benchSeatMap(long claims) {
+    if (claims <= 0) claims = 2000000;
+    int refills = (int)(claims / SEAT_BENCH_CAPACITY) + 1;
+    static const char* const kinds[] = { "any seat", "window", "aisle", "3 adjacent" };
+    printf("%d-seat ten-abreast map, filled %d times per search; ns per claim until none is left\n", SEAT_BENCH_CAPACITY,
+           refills);
+    printf("%-12s %-16s %-16s %-8s %s\n", "Search", "Byte scan (ns)", "Bitmap (ns)", "Speedup", "Same seats");
+    char* taken = (char*)malloc(SEAT_BENCH_CAPACITY);
+    int* order = (int*)malloc(sizeof(int) * SEAT_BENCH_CAPACITY);
+    if (!taken || !order) {
+        free(taken);
+        free(order);
+        return;
+    }
+    for (int kind = 0; kind < 4; ++kind) {
+        SeatPreference pref = kind < 3 ? (SeatPreference)kind : SEAT_PREF_ANY;
+        int count = kind < 3 ? 1 : 3;
+        uint64_t scanNs = 0, mapNs = 0;
+        long scanClaims = 0, mapClaims = 0;
+        int mismatches = 0;
+        for (int r = 0; r < refills; ++r) {
+            memset(taken, 0, SEAT_BENCH_CAPACITY);
+            int n = 0, seat;
+            uint64_t t0 = benchNowNs();
+            while ((seat = byteScanClaim(taken, SEAT_BENCH_CAPACITY, pref, count)) != -1) order[n++] = seat;
+            scanNs += benchNowNs() - t0;
+            scanClaims += n;
+
+            SeatMap map;
+            if (seatMapInit(&map, SEAT_BENCH_CAPACITY) != 0) break;
+            int m = 0;
+            t0 = benchNowNs();
+            while ((seat = count > 1 ? seatMapClaimAdjacent(&map, SEAT_CABIN_ANY, count)
+                                     : seatMapClaimFirst(&map, SEAT_CABIN_ANY, pref)) != -1) {
+                mismatches += m >= n || order[m] != seat;
+                ++m;
+            }
+            mapNs += benchNowNs() - t0;
+            mapClaims += m;
+            mismatches += m != n;
+            seatMapFree(&map);
+        }
+        double scan = (double)scanNs / (scanClaims ? scanClaims : 1);
+        double bitmap = (double)mapNs / (mapClaims ? mapClaims : 1);
+        printf("%-12s %-16.1f %-16.1f %-8.1f %s\n", kinds[kind], scan, bitmap, scan / bitmap, mismatches ? "NO" : "yes");
+    }
+    free(taken);
+    free(order);
+
+    static const int threadCounts[] = { 1, 2, 4, SEAT_BENCH_THREADS };
+    printf("\nConcurrent churn on one map: each thread holds up to %d seats, releasing the oldest to claim more\n",
+           SEAT_BENCH_HELD);
+    printf("%-8s %-16s %s\n", "Threads", "Claims (M/s)", "Check");
+    for (size_t i = 0; i < sizeof(threadCounts) / sizeof(threadCounts[0]); ++i) {
+        int threads = threadCounts[i];
+        SeatMap map;
+        if (seatMapInit(&map, SEAT_BENCH_CAPACITY) != 0) return;
+        SeatWorker workers[SEAT_BENCH_THREADS];
+        pthread_t tids[SEAT_BENCH_THREADS];
+        uint64_t t0 = benchNowNs();
+        for (int t = 0; t < threads; ++t) {
+            memset(&workers[t], 0, sizeof(workers[t]));
+            workers[t].map = &map;
+            workers[t].ops = claims / threads;
+            workers[t].id = t;
+            pthread_create(&tids[t], NULL, seatChurnWorker, &workers[t]);
+        }
+        for (int t = 0; t < threads; ++t) pthread_join(tids[t], NULL);
+        uint64_t t1 = benchNowNs();
+        // Every held seat must be taken exactly once, and every other seat free
+        char owner[SEAT_BENCH_CAPACITY];
+        memset(owner, 0, sizeof(owner));
+        long total = 0;
+        int bad = 0;
+        for (int t = 0; t < threads; ++t) {
+            total += workers[t].claims;
+            for (int k = 0; k < workers[t].heldCount; ++k) bad += owner[workers[t].held[k]]++ != 0;
+        }
+        int held = 0;
+        for (int seat = 0; seat < SEAT_BENCH_CAPACITY; ++seat) held += owner[seat] != 0;
+        bad += seatMapFreeSeats(&map, SEAT_CABIN_ANY) != SEAT_BENCH_CAPACITY - held;
+        printf("%-8d %-16.2f %s\n", threads, total / ((t1 - t0) / 1e9) / 1e6, bad ? "MISMATCH" : "ok");
+        seatMapFree(&map);
+    }
+}
+
+/* ---------- Batch ingest ---------- */
+
+static void benchBatchIngest(long bookings) {
+    if (bookings <= 0) bookings = 2000000;
+    const int flightsInFile = 10000;
+    FILE* tmp = tmpfile();
+    if (!tmp) {
+        printf("Unable to create temporary batch file\n");
+        return;
+    }
+    static int runCounter = 0;
+    ++runCounter;
+    for (int i = 0; i < flightsInFile; ++i) {
+        fprintf(tmp, "F,Q%d%05d,DEL,BOM,06:%02d,08:%02d,A320,%d,%.2f,%d\n", runCounter % 10, i, i % 60, i % 60,
+                (int)(bookings / flightsInFile) + 1, 50.0 + i % 400, 1 + i % 10);
+    }
+    uint64_t rng = 0xBA7C4ull;
+    for (long i = 0; i < bookings; ++i) {
+        int f = (int)(benchRandom(&rng) % flightsInFile);
+        fprintf(tmp, "B,R%d-%ld,First%ld,Last,p%ld@example.com,555%04ld,Q%d%05d\n", runCounter, i, i % 1000, i,
+                i % 10000, runCounter % 10, f);
+    }
+    long bytes = ftell(tmp);
+    rewind(tmp);
+    BatchSummary summary;
+    runBatchStream(tmp, &summary);
+    fclose(tmp);
+    printBatchSummary(&summary);
+    printf("Throughput: %.2f M bookings/s, %.1f MB/s\n", summary.bookingsAccepted / summary.seconds / 1e6,
+           bytes / summary.seconds / (1024.0 * 1024.0));
+}
+
+/* ---------- Snapshot persistence ---------- */
+
+#define BENCH_SNAPSHOT_PATH "bench_snapshot.db"
+
+static void benchPersist(long passengers) {
+    if (passengers <= 0) passengers = 10000000;
+    const int flightsToCreate = 1000;
+    resetStores();
+    Flight f;
+    memset(&f, 0, sizeof(f));
+    strcpy(f.origin, "DEL");
+    strcpy(f.destination, "BOM");
+    f.capacity = (int)(passengers / flightsToCreate) + 1;
+    for (int i = 0; i < flightsToCreate; ++i) {
+        snprintf(f.flightNumber, sizeof(f.flightNumber), "S%05d", i);
+        createFlight(&f, NULL);
+    }
+    Passenger p;
+    char flightNumber[FLIGHT_ID_LEN];
+    memset(&p, 0, sizeof(p));
+    strcpy(p.firstName, "Snap");
+    strcpy(p.lastName, "Shot");
+    uint64_t t0 = benchNowNs();
+    for (long i = 0; i < passengers; ++i) {
+        snprintf(p.id, sizeof(p.id), "S%ld", i);
+        snprintf(flightNumber, sizeof(flightNumber), "S%05ld", i % flightsToCreate);
+        bookPassenger(&p, flightNumber, NULL);
+    }
+    uint64_t t1 = benchNowNs();
+    if (persistWriteSnapshot(BENCH_SNAPSHOT_PATH) != 0) {
+        printf("Unable to write %s\n", BENCH_SNAPSHOT_PATH);
+        resetStores();
+        return;
+    }
+    uint64_t t2 = benchNowNs();
+    FILE* snap = fopen(BENCH_SNAPSHOT_PATH, "rb");
+    long bytes = 0;
+    if (snap) {
+        fseek(snap, 0, SEEK_END);
+        bytes = ftell(snap);
+        fclose(snap);
+    }
+    resetStores();
+
+    uint64_t t3 = benchNowNs();
+    int loaded = persistLoadSnapshot(BENCH_SNAPSHOT_PATH);
+    uint64_t t4 = benchNowNs();
+    // First queries fault in only the pages they touch
+    uint64_t rng = 0x5EEDull;
+    char id[NAME_LEN];
+    int hits = 0;
+    const int probes = 100000;
+    for (int i = 0; i < probes; ++i) {
+        snprintf(id, sizeof(id), "S%ld", (long)(benchRandom(&rng) % (uint64_t)passengers));
+        hits += findPassengerIndex(id) != -1;
+    }
+    uint64_t t5 = benchNowNs();
+    int countOk = loaded == 0 && passengerCount == passengers && hits == probes;
+    resetStores();
+    remove(BENCH_SNAPSHOT_PATH);
+
+    printf("%-34s %.1f ms (%ld bookings)\n", "Populate via bookPassenger()", (t1 - t0) / 1e6, passengers);
+    printf("%-34s %.1f ms (%.1f MB)\n", "Write snapshot (fsync + rename)", (t2 - t1) / 1e6, bytes / (1024.0 * 1024.0));
+    printf("%-34s %.3f ms\n", "Warm start: mmap + adopt", (t4 - t3) / 1e6);
+    printf("%-34s %.1f ms (%.0f ns/lookup)\n", "First 100k random lookups", (t5 - t4) / 1e6, (double)(t5 - t4) / probes);
+    printf("Snapshot check: %s (page cache is warm; drop caches for a true cold read)\n", countOk ? "ok" : "FAILED");
+}
+
+/* ---------- Write-ahead log commits ---------- */
+
+#define BENCH_WAL_BASE "bench_wal"
+#define BENCH_WAL_FLIGHTS 1000
+#define BENCH_WAL_SAMPLES 4096 // latest commit latencies kept per thread
+
+#ifndef _WIN32
+
+typedef struct {
+    int flightIdx[BENCH_WAL_FLIGHTS];
+    int batch; // bookings per commit; 1 = every booking commits on its own
+    atomic_int stop;
+    atomic_long accepted;
+} WalStress;
+
+typedef struct {
+    WalStress* shared;
+    int id;
+    long commits;
+    double micros[BENCH_WAL_SAMPLES];
+} WalStressArg;
+
+typedef struct {
+    double bookingsPerSec;
+    long acknowledged;
+    uint64_t syncs;
+    double p50;
+    double p99;
+} WalRunResult;
+
+static void* walWorker(void* raw) {
+    WalStressArg* arg = (WalStressArg*)raw;
+    WalStress* st = arg->shared;
+    uint64_t rng = 0xDA7Aull + (uint64_t)arg->id * 7919u;
+    Passenger details;
+    memset(&details, 0, sizeof(details));
+    strcpy(details.firstName, "Wal");
+    strcpy(details.lastName, "Test");
+    long accepted = 0;
+    long serial = 0;
+    for (long c = 0; !atomic_load_explicit(&st->stop, memory_order_relaxed); ++c) {
+        uint64_t t0 = benchNowNs();
+        if (st->batch > 1) persistBeginBatch();
+        long booked = 0;
+        for (int b = 0; b < st->batch; ++b) {
+            int k = (int)(benchRandom(&rng) % BENCH_WAL_FLIGHTS);
+            snprintf(details.id, sizeof(details.id), "W%d-%ld", arg->id, serial++);
+            booked += bookPassenger(&details, flightAt(st->flightIdx[k])->flightNumber, NULL) == BOOKING_OK;
+        }
+        // A batch counts once it is acknowledged, the way a client would see it
+        if (st->batch <= 1 || persistEndBatch() == 0) accepted += booked;
+        arg->micros[c % BENCH_WAL_SAMPLES] = (benchNowNs() - t0) / 1e3;
+        arg->commits = c + 1;
+    }
+    atomic_fetch_add(&st->accepted, accepted);
+    return NULL;
+}
+
+static void removeWalFiles(void) {
+    remove(BENCH_WAL_BASE ".db");
+    remove(BENCH_WAL_BASE ".log");
+}
+
+// Runs in a forked child that exits without closing the log, as if it crashed
+static int walStressChild(const PersistDurability* d, int threads, int batch, long runMs, WalRunResult* out) {
+    persistSetDurability(d);
+    if (persistOpen(BENCH_WAL_BASE) != 0) return -1;
+    WalStress st;
+    st.batch = batch;
+    for (int k = 0; k < BENCH_WAL_FLIGHTS; ++k) {
+        Flight f;
+        memset(&f, 0, sizeof(f));
+        snprintf(f.flightNumber, sizeof(f.flightNumber), "W%04d", k);
+        strcpy(f.origin, "DEL");
+        strcpy(f.destination, "BOM");
+        f.capacity = 1 << 24;
+        if (createFlight(&f, &st.flightIdx[k]) != BOOKING_OK) return -1;
+    }
+    WalStressArg* args = (WalStressArg*)calloc((size_t)threads, sizeof(WalStressArg));
+    pthread_t* tids = (pthread_t*)malloc(sizeof(pthread_t) * (size_t)threads);
+    if (!args || !tids) return -1;
+    PersistLogStats before, after;
+    persistLogStats(&before);
+    atomic_init(&st.stop, 0);
+    atomic_init(&st.accepted, 0);
+    uint64_t t0 = benchNowNs();
+    for (int t = 0; t < threads; ++t) {
+        args[t].shared = &st;
+        args[t].id = t;
+        pthread_create(&tids[t], NULL, walWorker, &args[t]);
+    }
+    struct timespec pause = { runMs / 1000, (runMs % 1000) * 1000000 };
+    nanosleep(&pause, NULL);
+    atomic_store(&st.stop, 1);
+    for (int t = 0; t < threads; ++t) pthread_join(tids[t], NULL);
+    double seconds = (benchNowNs() - t0) / 1e9;
+    persistLogStats(&after);
+
+    BenchSamples samples;
+    benchSamplesInit(&samples);
+    for (int t = 0; t < threads; ++t) {
+        long kept = args[t].commits < BENCH_WAL_SAMPLES ? args[t].commits : BENCH_WAL_SAMPLES;
+        for (long i = 0; i < kept; ++i) benchSamplesAdd(&samples, args[t].micros[i]);
+    }
+    BenchStats stats = benchSamplesSummarize(&samples);
+    out->acknowledged = atomic_load(&st.accepted);
+    out->bookingsPerSec = out->acknowledged / seconds;
+    out->syncs = after.syncs - before.syncs;
+    out->p50 = stats.p50;
+    out->p99 = stats.p99;
+    return 0;
+}
+
+/*
+ * Books from `threads` threads for runMs in a child process that then
+ * exits abruptly, and replays the log it left behind: every acknowledged
+ * booking must come back in group mode; the other modes show what a crash
+ * costs them.
+ */
+static void runWalStress(const PersistDurability* d, int threads, int batch, long runMs) {
+    char mode[32];
+    if (batch > 1) snprintf(mode, sizeof(mode), "group x%d batch", batch);
+    else if (d->mode == PERSIST_SYNC_GROUP && d->groupDelayUs > 0) snprintf(mode, sizeof(mode), "group +%dus", d->groupDelayUs);
+    else if (d->mode == PERSIST_SYNC_INTERVAL) snprintf(mode, sizeof(mode), "interval %dms", d->intervalMs);
+    else snprintf(mode, sizeof(mode), "%s", persistSyncModeName(d->mode));
+    removeWalFiles();
+    resetStores();
+    fflush(stdout);
+    WalRunResult r;
+    int fds[2];
+    if (pipe(fds) != 0) return;
+    pid_t pid = fork();
+    if (pid == 0) {
+        close(fds[0]);
+        int ok = walStressChild(d, threads, batch, runMs, &r) == 0 && write(fds[1], &r, sizeof(r)) == (ssize_t)sizeof(r);
+        _exit(ok ? 0 : 1);
+    }
+    close(fds[1]);
+    int got = pid > 0 && read(fds[0], &r, sizeof(r)) == (ssize_t)sizeof(r);
+    close(fds[0]);
+    if (pid > 0) waitpid(pid, NULL, 0);
+    if (!got) {
+        printf("%-18s %-8d run failed (is ./%s.log writable?)\n", mode, threads, BENCH_WAL_BASE);
+        removeWalFiles();
+        return;
+    }
+    long replayed = persistReplayLog(BENCH_WAL_BASE ".log");
+    long lost = r.acknowledged - passengerCount;
+    const char* verdict = replayed == PERSIST_REPLAY_INCONSISTENT ? "BAD LOG" : replayed < 0 ? "torn log" : d->mode == PERSIST_SYNC_GROUP ? (lost <= 0 ? "ok" : "LOST ACKED") : "-";
+    printf("%-18s %-8d %-12.0f %-8llu %-10.1f %-10.1f %-10.1f %-10ld %s\n", mode, threads, r.bookingsPerSec,
+           (unsigned long long)r.syncs, r.syncs ? (double)r.acknowledged / r.syncs : 0.0, r.p50, r.p99,
+           lost > 0 ? lost : 0, verdict);
+    resetStores();
+    removeWalFiles();
+}
+#endif
+
+static void benchWal(long runMs) {
+#ifdef _WIN32
+    (void)runMs;
+    printf("Needs fork() to simulate the crash; not available on Windows.\n");
+#else
+    if (runMs <= 0) runMs = 1000;
+    static const struct {
+        PersistSyncMode mode;
+        int delayUs;
+        int threads;
+        int batch;
+    } runs[] = {
+        {PERSIST_SYNC_BUFFERED, 0, 1, 1}, {PERSIST_SYNC_BUFFERED, 0, 8, 1}, {PERSIST_SYNC_INTERVAL, 0, 1, 1},
+        {PERSIST_SYNC_INTERVAL, 0, 8, 1}, {PERSIST_SYNC_GROUP, 0, 1, 1},    {PERSIST_SYNC_GROUP, 0, 8, 1},
+        {PERSIST_SYNC_GROUP, 0, 64, 1},   {PERSIST_SYNC_GROUP, 0, 256, 1},  {PERSIST_SYNC_GROUP, 200, 64, 1},
+        {PERSIST_SYNC_GROUP, 200, 256, 1}, {PERSIST_SYNC_GROUP, 0, 1, 1024}, {PERSIST_SYNC_GROUP, 0, 8, 1024},
+    };
+    printf("Bookings on %d flights for %ld ms per run, then a simulated crash and log replay\n", BENCH_WAL_FLIGHTS,
+           runMs);
+    printf("Log: ./%s.log (run from the disk under test); latency is per commit\n", BENCH_WAL_BASE);
+    printf("%-18s %-8s %-12s %-8s %-10s %-10s %-10s %-10s %s\n", "Sync mode", "Threads", "Acked/s", "Syncs",
+           "Per sync", "p50 (us)", "p99 (us)", "Lost", "Durable");
+    for (size_t i = 0; i < sizeof(runs) / sizeof(runs[0]); ++i) {
+        PersistDurability d = PERSIST_DURABILITY_DEFAULT;
+        d.mode = runs[i].mode;
+        d.groupDelayUs = runs[i].delayUs;
+        d.intervalMs = 10;
+        runWalStress(&d, runs[i].threads, runs[i].batch, runMs);
+    }
+#endif
+}
+
+/* ---------- Route graph shortest paths ---------- */
+
+// Connected random network: a random spanning tree plus extra routes up to avgDegree per airport
+static void benchDijkstra(long maxVertices) {
+    if (maxVertices <= 0) maxVertices = 64000;
+    const int degree = 8;
+    const int sources = 20;
+    printf("Average degree %d, %d sources per size; matrix path only while V^2 fits comfortably\n", degree, sources);
+    printf("%-10s %-12s %-18s %-18s %-8s\n", "Airports", "Arcs", "Matrix (ms/src)", "CSR heap (ms/src)", "Match");
+    for (long v = 1000; v <= maxVertices; v *= 4) {
+        RouteEdge* edges;
+        int edgeCount = generateRouteEdges((int)v, degree, 0xD1D1ull + (uint64_t)v, &edges);
+        if (edgeCount < 0) break;
+        CsrGraph csr;
+        if (buildCsrGraph(&csr, (int)v, edges, edgeCount, 0) != 0) {
+            free(edges);
+            break;
+        }
+        double* distCsr = (double*)malloc(sizeof(double) * v);
+        double* distMatrix = (double*)malloc(sizeof(double) * v);
+        IndexedHeap heap;
+        indexedHeapInit(&heap, (int)v);
+        uint64_t t0 = benchNowNs();
+        for (int s = 0; s < sources; ++s) dijkstraCsrWithHeap(&csr, (int)(s * v / sources), distCsr, &heap);
+        uint64_t t1 = benchNowNs();
+
+        double matrixMs = -1.0;
+        int match = 1;
+        RouteGraph matrix = {0, 0, NULL};
+        if (v <= 4000) matrix = createRouteGraph((int)v, 0);
+        if (matrix.adjMatrix) {
+            for (int i = 0; i < edgeCount; ++i) {
+                double** m = matrix.adjMatrix;
+                if (edges[i].src == edges[i].dest) continue;
+                if (m[edges[i].src][edges[i].dest] > edges[i].weight) m[edges[i].src][edges[i].dest] = edges[i].weight;
+                if (m[edges[i].dest][edges[i].src] > edges[i].weight) m[edges[i].dest][edges[i].src] = edges[i].weight;
+            }
+            int matrixSources = v > 1000 ? 4 : sources;
+            uint64_t t2 = benchNowNs();
+            for (int s = 0; s < matrixSources; ++s) dijkstra(&matrix, (int)(s * v / sources), distMatrix);
+            uint64_t t3 = benchNowNs();
+            matrixMs = (t3 - t2) / 1e6 / matrixSources;
+            dijkstraCsrWithHeap(&csr, (int)((matrixSources - 1) * v / sources), distCsr, &heap);
+            for (long i = 0; i < v; ++i) match &= distCsr[i] == distMatrix[i];
+            freeRouteGraph(&matrix);
+        }
+        if (matrixMs >= 0) {
+            printf("%-10ld %-12d %-18.3f %-18.3f %-8s\n", v, csr.arcCount, matrixMs, (t1 - t0) / 1e6 / sources, match ? "yes" : "NO");
+        } else {
+            printf("%-10ld %-12d %-18s %-18.3f %-8s\n", v, csr.arcCount, "-", (t1 - t0) / 1e6 / sources, "-");
+        }
+        indexedHeapFree(&heap);
+        free(distCsr);
+        free(distMatrix);
+        freeCsrGraph(&csr);
+        free(edges);
+    }
+}
+
+static void benchApsp(long maxVertices) {
+    if (maxVertices <= 0) maxVertices = 4096;
+    ApspKernel best = apspDetectKernel();
+    printf("Best kernel on this CPU: %s\n", apspKernelName(best));
+    printf("%-8s %-10s %-14s %-10s %-8s\n", "V", "Kernel", "Time (ms)", "Speedup", "Match");
+    for (long v = 256; v <= maxVertices; v *= 4) {
+        RouteEdge* edges;
+        int edgeCount = generateRouteEdges((int)v, 8, 0xF10Dull + (uint64_t)v, &edges);
+        if (edgeCount < 0) break;
+        RouteGraph graph = createRouteGraph((int)v, 0);
+        double** reference = allocateMatrix((int)v, INF_WEIGHT);
+        if (!graph.adjMatrix || !reference) {
+            freeRouteGraph(&graph);
+            freeMatrix(reference, (int)v);
+            free(edges);
+            break;
+        }
+        for (int i = 0; i < edgeCount; ++i) {
+            double** m = graph.adjMatrix;
+            if (edges[i].src == edges[i].dest) continue;
+            if (m[edges[i].src][edges[i].dest] > edges[i].weight) m[edges[i].src][edges[i].dest] = edges[i].weight;
+            if (m[edges[i].dest][edges[i].src] > edges[i].weight) m[edges[i].dest][edges[i].src] = edges[i].weight;
+        }
+
+        uint64_t t0 = benchNowNs();
+        floydWarshallReference(&graph, reference);
+        double referenceMs = (benchNowNs() - t0) / 1e6;
+        printf("%-8ld %-10s %-14.1f %-10s %-8s\n", v, "reference", referenceMs, "1.0x", "-");
+
+        for (int k = APSP_KERNEL_SCALAR; k <= APSP_KERNEL_AVX512; ++k) {
+            if (!apspKernelSupported((ApspKernel)k)) continue;
+            DistanceMatrix dist;
+            if (distanceMatrixFromGraph(&dist, &graph) != 0) break;
+            uint64_t t1 = benchNowNs();
+            apspBlockedFloydWarshall(&dist, (ApspKernel)k);
+            double ms = (benchNowNs() - t1) / 1e6;
+            int match = 1;
+            for (long i = 0; i < v && match; ++i) {
+                match = memcmp(distanceMatrixRow(&dist, (int)i), reference[i], sizeof(double) * v) == 0;
+            }
+            char speedup[32];
+            snprintf(speedup, sizeof(speedup), "%.1fx", referenceMs / ms);
+            printf("%-8ld %-10s %-14.1f %-10s %-8s\n", v, apspKernelName((ApspKernel)k), ms, speedup, match ? "yes" : "NO");
+            distanceMatrixFree(&dist);
+        }
+        freeMatrix(reference, (int)v);
+        freeRouteGraph(&graph);
+        free(edges);
+    }
+}
+
+static void benchApspParallel(long maxVertices) {
+    if (maxVertices <= 0) maxVertices = 2048;
+    int cores = workPoolDefaultThreads();
+    printf("Online cores: %d (thread counts above this only measure overhead)\n", cores);
+    printf("%-8s %-8s %-10s %-22s %-12s %-10s %-8s %-10s\n", "V", "Degree", "Threads", "Strategy", "Time (ms)", "Speedup", "Match", "Model pick");
+    static const int degrees[] = { 8, 256 };
+    for (long v = 512; v <= maxVertices; v *= 2) {
+        for (size_t d = 0; d < sizeof(degrees) / sizeof(degrees[0]); ++d) {
+            if (degrees[d] >= v) continue;
+            RouteEdge* edges;
+            int edgeCount = generateRouteEdges((int)v, degrees[d], 0xA11Bull + (uint64_t)v, &edges);
+            if (edgeCount < 0) return;
+            RouteGraph graph = createRouteGraph((int)v, 0);
+            CsrGraph csr;
+            if (!graph.adjMatrix || buildCsrGraph(&csr, (int)v, edges, edgeCount, 0) != 0) {
+                freeRouteGraph(&graph);
+                free(edges);
+                return;
+            }
+            for (int i = 0; i < edgeCount; ++i) {
+                double** m = graph.adjMatrix;
+                if (edges[i].src == edges[i].dest) continue;
+                if (m[edges[i].src][edges[i].dest] > edges[i].weight) m[edges[i].src][edges[i].dest] = edges[i].weight;
+                if (m[edges[i].dest][edges[i].src] > edges[i].weight) m[edges[i].dest][edges[i].src] = edges[i].weight;
+            }
+
+            DistanceMatrix floyd;
+            distanceMatrixFromGraph(&floyd, &graph);
+            uint64_t t0 = benchNowNs();
+            apspBlockedFloydWarshall(&floyd, APSP_KERNEL_AUTO);
+            double floydMs = (benchNowNs() - t0) / 1e6;
+            const char* pick1 = apspStrategyName(apspChooseStrategy((int)v, csr.arcCount, 1, APSP_KERNEL_AUTO));
+            printf("%-8ld %-8d %-10d %-22s %-12.1f %-10s %-8s %-10s\n", v, degrees[d], 1, "blocked Floyd-Warshall", floydMs, "-", "-", pick1);
+
+            double singleMs = 0.0;
+            int maxThreads = cores < 2 ? 2 : cores;
+            for (int threads = 1; threads <= maxThreads; threads *= 2) {
+                WorkPool pool;
+                if (workPoolInit(&pool, threads) != 0) break;
+                DistanceMatrix dist;
+                distanceMatrixInit(&dist, (int)v);
+                uint64_t t1 = benchNowNs();
+                apspParallelDijkstra(&dist, &csr, &pool);
+                double ms = (benchNowNs() - t1) / 1e6;
+                if (threads == 1) singleMs = ms;
+                int match = 1;
+                for (long i = 0; i < v && match; ++i) {
+                    match = memcmp(distanceMatrixRow(&dist, (int)i), distanceMatrixRow(&floyd, (int)i), sizeof(double) * v) == 0;
+                }
+                char speedup[32];
+                snprintf(speedup, sizeof(speedup), "%.2fx", singleMs / ms);
+                const char* pick = apspStrategyName(apspChooseStrategy((int)v, csr.arcCount, threads, APSP_KERNEL_AUTO));
+                printf("%-8ld %-8d %-10d %-22s %-12.1f %-10s %-8s %-10s\n", v, degrees[d], threads, "parallel Dijkstra", ms, speedup, match ? "yes" : "NO", pick);
+                distanceMatrixFree(&dist);
+                workPoolDestroy(&pool);
+            }
+            distanceMatrixFree(&floyd);
+            freeCsrGraph(&csr);
+            freeRouteGraph(&graph);
+            free(edges);
+        }
+    }
+}
+
+#define BENCH_ROUTES_PATH "bench_routes.csv"
+
+static void benchRouteLoad(long routes) {
+    if (routes <= 0) routes = 1000000;
+    const int airports = 10000;
+    const char* path = BENCH_ROUTES_PATH;
+    FILE* out = fopen(path, "wb");
+    if (!out) {
+        printf("Unable to create %s\n", path);
+        return;
+    }
+    uint64_t rng = 0x5EEDull;
+    for (long i = 0; i < routes; ++i) {
+        int s = (int)(benchRandom(&rng) % airports);
+        int d = (int)(benchRandom(&rng) % airports);
+        fprintf(out, "A%04d,A%04d,%d\n", s, d, 100 + (int)(benchRandom(&rng) % 2900));
+    }
+    fclose(out);
+
+    RouteNetwork net;
+    routeNetworkInit(&net, 1);
+    uint64_t t0 = benchNowNs();
+    int loaded = routeNetworkLoadFile(&net, path);
+    uint64_t t1 = benchNowNs();
+    CsrGraph csr;
+    int csrStatus = routeNetworkBuildCsr(&net, &csr);
+    uint64_t t2 = benchNowNs();
+    remove(path);
+    if (loaded < 0 || csrStatus != 0) {
+        printf("Route load failed\n");
+        routeNetworkFree(&net);
+        return;
+    }
+    printf("Routes: %d  Airports: %d  Skipped lines: %ld\n", loaded, net.airportCount, net.skippedLines);
+    printf("Parse + intern: %.1f ms (%.2f M routes/s)\n", (t1 - t0) / 1e6, loaded / ((t1 - t0) / 1e9) / 1e6);
+    printf("CSR build:      %.1f ms\n", (t2 - t1) / 1e6);
+    printf("Total:          %.1f ms\n", (t2 - t0) / 1e6);
+    freeCsrGraph(&csr);
+    routeNetworkFree(&net);
+}
+
+/*
+ * Airports on a jittered lat/lon grid, each linked to its grid neighbours
+ * plus a few long-haul routes from every 50th airport. Weights are
+ * great-circle km inflated by 0-30%, so the A* bound is informative
+ * but never exact.
+ */
+static void buildGeoNetwork(RouteNetwork* net, int rows, int cols, uint64_t seed) {
+    uint64_t rng = seed;
+    char code[AIRPORT_CODE_LEN];
+    for (int r = 0; r < rows; ++r) {
+        for (int c = 0; c < cols; ++c) {
+            snprintf(code, sizeof(code), "G%d", r * cols + c);
+            int v = routeNetworkIntern(net, code);
+            double lat = -60.0 + 120.0 * (r + (benchRandom(&rng) % 1000) / 1000.0) / rows;
+            double lon = -170.0 + 340.0 * (c + (benchRandom(&rng) % 1000) / 1000.0) / cols;
+            routeNetworkSetCoordinates(net, v, lat, lon);
+        }
+    }
+    int n = rows * cols;
+    for (int v = 0; v < n; ++v) {
+        int r = v / cols, c = v % cols;
+        int neighbours[4] = { -1, -1, -1, -1 };
+        if (c + 1 < cols) neighbours[0] = v + 1;
+        if (r + 1 < rows) neighbours[1] = v + cols;
+        if (r + 1 < rows && c + 1 < cols) neighbours[2] = v + cols + 1;
+        if (v % 50 == 0) neighbours[3] = (int)(benchRandom(&rng) % (uint64_t)n);
+        const Airport* a = routeNetworkAirport(net, v);
+        for (int k = 0; k < 4; ++k) {
+            if (neighbours[k] < 0 || neighbours[k] == v) continue;
+            const Airport* b = routeNetworkAirport(net, neighbours[k]);
+            double km = greatCircleKm(a->latitude, a->longitude, b->latitude, b->longitude);
+            double weight = km * (1.0 + (benchRandom(&rng) % 300) / 1000.0);
+            routeNetworkAddRoute(net, v, neighbours[k], weight);
+        }
+    }
+}
+
+static void reportLatencies(const char* label, double* micros, int count, long settled, int mismatches) {
+    qsort(micros, (size_t)count, sizeof(double), compareDoubles);
+    printf("%-24s %-10.1f %-10.1f %-10.1f %-14.0f %-8s\n", label, micros[count / 2], micros[(int)(count * 0.99)],
+           micros[count - 1], (double)settled / count, mismatches ? "NO" : "yes");
+}
+
+static void benchRouteQuery(long airports) {
+    if (airports <= 0) airports = 40000;
+    int cols = 1;
+    while ((long)cols * cols * 2 < airports) ++cols;
+    int rows = (int)((airports + cols - 1) / cols);
+    RouteNetwork net;
+    routeNetworkInit(&net, 0);
+    buildGeoNetwork(&net, rows, cols, 0xA57A5ull);
+    CsrGraph csr;
+    RouteQuery query;
+    if (routeNetworkBuildCsr(&net, &csr) != 0 || routeQueryInit(&query, &net, &csr) != 0) {
+        printf("Unable to build the routing network\n");
+        routeNetworkFree(&net);
+        return;
+    }
+    const int queries = 1000;
+    printf("Airports: %d  Routes: %d  Heuristic scale: %.3f per km  Queries: %d\n", net.airportCount, net.routeCount,
+           query.heuristicScale, queries);
+
+    int* pairs = (int*)malloc(sizeof(int) * 2 * queries);
+    double* expected = (double*)malloc(sizeof(double) * queries);
+    double* micros = (double*)malloc(sizeof(double) * queries);
+    double* dist = (double*)malloc(sizeof(double) * net.airportCount);
+    IndexedHeap heap;
+    indexedHeapInit(&heap, net.airportCount);
+    uint64_t rng = 0x9E3779B9ull;
+    for (int i = 0; i < queries; ++i) {
+        pairs[2 * i] = (int)(benchRandom(&rng) % (uint64_t)net.airportCount);
+        pairs[2 * i + 1] = (int)(benchRandom(&rng) % (uint64_t)net.airportCount);
+    }
+
+    printf("%-24s %-10s %-10s %-10s %-14s %-8s\n", "Method", "p50 (us)", "p99 (us)", "max (us)", "Avg settled", "Exact");
+    for (int i = 0; i < queries; ++i) {
+        uint64_t t0 = benchNowNs();
+        dijkstraCsrWithHeap(&csr, pairs[2 * i], dist, &heap);
+        micros[i] = (benchNowNs() - t0) / 1e3;
+        expected[i] = dist[pairs[2 * i + 1]];
+    }
+    reportLatencies("one-to-all Dijkstra", micros, queries, (long)net.airportCount * queries, 0);
+
+    RouteItinerary it;
+    routeItineraryInit(&it);
+    double scale = query.heuristicScale;
+    for (int pass = 0; pass < 2; ++pass) {
+        query.heuristicScale = pass == 0 ? 0.0 : scale;
+        long settled = 0;
+        int mismatches = 0;
+        for (int i = 0; i < queries; ++i) {
+            uint64_t t0 = benchNowNs();
+            routeQueryBest(&query, pairs[2 * i], pairs[2 * i + 1], &it);
+            micros[i] = (benchNowNs() - t0) / 1e3;
+            settled += it.settled;
+            double diff = it.cost - expected[i];
+            if (diff > 1e-6 * expected[i] || diff < -1e-6 * expected[i]) mismatches++;
+        }
+        reportLatencies(pass == 0 ? "bidirectional Dijkstra" : "bidirectional A*", micros, queries, settled, mismatches);
+    }
+
+    routeItineraryFree(&it);
+    indexedHeapFree(&heap);
+    free(pairs);
+    free(expected);
+    free(micros);
+    free(dist);
+    routeQueryFree(&query);
+    freeCsrGraph(&csr);
+    routeNetworkFree(&net);
+}
+
+// Daily schedule over 2000 airports; a third of the flights touch one of 20 hubs
+static void benchJourney(long departures) {
+    if (departures <= 0) departures = 300000;
+    const int airports = 2000;
+    const int hubs = 20;
+    resetStores();
+    generateFlightSchedule(departures, airports, hubs, 0xC5Aull);
+    uint64_t rng = 0x9C5Aull;
+
+    Timetable tt;
+    timetableInit(&tt, JOURNEY_MIN_CONNECTION_MINUTES);
+    uint64_t t0 = benchNowNs();
+    int built = timetableBuildFromFlights(&tt);
+    uint64_t t1 = benchNowNs();
+    if (built != 0) {
+        printf("Unable to build the timetable\n");
+        timetableFree(&tt);
+        resetStores();
+        return;
+    }
+    printf("Departures: %d  Airports: %d  Timetable build: %.1f ms\n", tt.connectionCount, tt.airports.airportCount,
+           (t1 - t0) / 1e6);
+
+    const int queries = 2000;
+    double* micros = (double*)malloc(sizeof(double) * queries);
+    Journey journey;
+    journeyInit(&journey);
+    long scanned = 0;
+    int reached = 0;
+    long legs = 0;
+    for (int i = 0; i < queries; ++i) {
+        int from = (int)(benchRandom(&rng) % tt.airports.airportCount);
+        int to = (int)(benchRandom(&rng) % tt.airports.airportCount);
+        int after = (int)(benchRandom(&rng) % MINUTES_PER_DAY);
+        uint64_t q0 = benchNowNs();
+        int status = timetableEarliestArrival(&tt, from, to, after, &journey);
+        micros[i] = (benchNowNs() - q0) / 1e3;
+        scanned += journey.scanned;
+        if (status == 0) {
+            reached++;
+            legs += journey.legCount;
+        }
+    }
+    qsort(micros, (size_t)queries, sizeof(double), compareDoubles);
+    printf("Queries: %d  reached: %d  avg flights per journey: %.2f  avg connections scanned: %.0f\n", queries, reached,
+           reached ? (double)legs / reached : 0.0, (double)scanned / queries);
+    printf("Latency p50 %.1f us  p99 %.1f us  max %.1f us\n", micros[queries / 2], micros[(int)(queries * 0.99)],
+           micros[queries - 1]);
+    journeyFree(&journey);
+    free(micros);
+    timetableFree(&tt);
+    resetStores();
+}
+
+/* ---------- Flight availability scan ---------- */
+
+// The flight record as it was before the hot fields moved into columns
+typedef struct {
+    char flightNumber[10];
+    char origin[50];
+    char destination[50];
+    char departureTime[20];
+    char arrivalTime[20];
+    char aircraft[20];
+    int capacity;
+    atomic_int bookedSeats;
+    float price;
+    char status[20];
+    int priority;
+} BenchFlightRecord;
+
+static int scanRecords(const BenchFlightRecord* rows, int count, float maxPrice, int minSeats, int* out) {
+    int found = 0;
+    for (int i = 0; i < count; ++i) {
+        int left = rows[i].capacity - atomic_load_explicit(&rows[i].bookedSeats, memory_order_relaxed);
+        if (rows[i].price <= maxPrice && left >= minSeats) out[found++] = i;
+    }
+    return found;
+}
+
+static void benchFlightScan(long flights) {
+    if (flights <= 0) flights = 1000000;
+    const int rounds = 20;
+    resetStores();
+    generateFlightSchedule(flights, 2000, 20, 0xF1A7ull);
+    int count = flightCount;
+    BenchFlightRecord* rows = (BenchFlightRecord*)calloc((size_t)count, sizeof(BenchFlightRecord));
+    int* expected = (int*)malloc(sizeof(int) * (size_t)(count > 0 ? count : 1));
+    int* matches = (int*)malloc(sizeof(int) * (size_t)(count > 0 ? count : 1));
+    if (!rows || !expected || !matches) {
+        printf("Unable to allocate %d flight rows\n", count);
+        free(rows);
+        free(expected);
+        free(matches);
+        resetStores();
+        return;
+    }
+    // Sell a random share of each flight so seat availability varies
+    uint64_t rng = 0x5EA7ull;
+    for (int i = 0; i < count; ++i) {
+        reserveSeats(i, (int)(benchRandom(&rng) % 181));
+        Flight row;
+        flightRow(i, &row);
+        memcpy(rows[i].flightNumber, row.flightNumber, sizeof(row.flightNumber));
+        rows[i].capacity = row.capacity;
+        atomic_init(&rows[i].bookedSeats, row.bookedSeats);
+        rows[i].price = row.price;
+        rows[i].priority = row.priority;
+    }
+    const float maxPrice = 250.0f;
+    const int minSeats = 20;
+    printf("Flights: %d  filter: price <= $%.0f and >= %d seats left  best of %d scans\n", count, maxPrice, minSeats,
+           rounds);
+    printf("%-16s %-12s %-12s %-10s %-10s %-8s\n", "Layout", "Time (ms)", "Rows/ns", "Speedup", "Matches", "Match");
+
+    double baselineMs = 0.0;
+    int expectedCount = 0;
+    for (int r = 0; r < rounds; ++r) {
+        uint64_t t0 = benchNowNs();
+        expectedCount = scanRecords(rows, count, maxPrice, minSeats, expected);
+        double ms = (benchNowNs() - t0) / 1e6;
+        if (r == 0 || ms < baselineMs) baselineMs = ms;
+    }
+    printf("%-16s %-12.3f %-12.2f %-10s %-10d %-8s\n", "AoS records", baselineMs, count / (baselineMs * 1e6), "1.0x",
+           expectedCount, "-");
+
+    for (int k = FLIGHT_SCAN_SCALAR; k <= FLIGHT_SCAN_AVX512; ++k) {
+        if (!flightScanKernelSupported((FlightScanKernel)k)) continue;
+        double bestMs = 0.0;
+        int found = 0;
+        for (int r = 0; r < rounds; ++r) {
+            uint64_t t0 = benchNowNs();
+            found = flightColumnsFindAvailable(&flightColumns, count, maxPrice, minSeats, matches, (FlightScanKernel)k);
+            double ms = (benchNowNs() - t0) / 1e6;
+            if (r == 0 || ms < bestMs) bestMs = ms;
+        }
+        int match = found == expectedCount && memcmp(matches, expected, sizeof(int) * (size_t)found) == 0;
+        char label[32], speedup[32];
+        snprintf(label, sizeof(label), "SoA %s", flightScanKernelName((FlightScanKernel)k));
+        snprintf(speedup, sizeof(speedup), "%.1fx", baselineMs / bestMs);
+        printf("%-16s %-12.3f %-12.2f %-10s %-10d %-8s\n", label, bestMs, count / (bestMs * 1e6), speedup, found,
+               match ? "yes" : "NO");
+    }
+    free(rows);
+    free(expected);
+    free(matches);
+    resetStores();
+}
+
+/* ---------- Store queries ---------- */
+
+static int compareFlightPrices(const void* a, const void* b) {
+    int x = *(const int*)a, y = *(const int*)b;
+    float px = flightPrice(x), py = flightPrice(y);
+    return px != py ? (px > py) - (px < py) : (x > y) - (x < y);
+}
+
+static void benchQuery(long passengers) {
+    if (passengers <= 0) passengers = 1000000;
+    enum { PAGE = 20 };
+    const int queries = 1000;
+    resetStores();
+    generateFlightSchedule(passengers / 100 + 1, 2000, 20, 0x9E71ull);
+    uint64_t rng = 0x9E72ull;
+    Passenger p;
+    char flightNumber[FLIGHT_ID_LEN];
+    for (long i = 0; passengerCount < passengers && i < passengers * 4; ++i) {
+        generateBookingRequest(&p, flightNumber, i, flightCount, &rng);
+        bookPassenger(&p, flightNumber, NULL);
+    }
+    int* targets = (int*)malloc(sizeof(int) * queries);
+    double* micros = (double*)malloc(sizeof(double) * queries);
+    int* expected = (int*)malloc(sizeof(int) * (size_t)queries * PAGE);
+    int* matches = (int*)malloc(sizeof(int) * (size_t)(flightCount > PAGE ? flightCount : PAGE));
+    if (!targets || !micros || !expected || !matches) {
+        printf("Unable to allocate the query buffers\n");
+        free(targets);
+        free(micros);
+        free(expected);
+        free(matches);
+        resetStores();
+        return;
+    }
+    printf("Passengers: %d  Flights: %d  Airports: %d  Queries: %d  Page: %d rows\n", passengerCount, flightCount,
+           airportCount, queries, PAGE);
+    printf("%-24s %-10s %-10s %-10s %-14s %-8s\n", "Method", "p50 (us)", "p99 (us)", "max (us)", "Avg examined", "Match");
+
+    // First page of one flight's manifest, in booking order
+    for (int i = 0; i < queries; ++i) targets[i] = (int)(benchRandom(&rng) % (uint64_t)flightCount);
+    long examined = 0;
+    for (int i = 0; i < queries; ++i) {
+        uint64_t t0 = benchNowNs();
+        int found = 0;
+        for (int k = 0; k < passengerCount; ++k) {
+            if (passengerAt(k)->flightIndex != targets[i]) continue;
+            if (found < PAGE) expected[i * PAGE + found] = k;
+            found++;
+        }
+        micros[i] = (benchNowNs() - t0) / 1e3;
+        for (int k = found; k < PAGE; ++k) expected[i * PAGE + k] = -1;
+        examined += passengerCount;
+    }
+    reportLatencies("passengers: full scan", micros, queries, examined, 0);
+
+    syncSecondaryIndexes();
+    examined = 0;
+    int mismatches = 0;
+    PassengerQuery pq;
+    passengerQueryInit(&pq);
+    for (int i = 0; i < queries; ++i) {
+        pq.flightNumber = flightAt(targets[i])->flightNumber;
+        QueryPage page;
+        page.records = matches;
+        uint64_t t0 = benchNowNs();
+        queryPassengers(&pq, (QueryCursor)QUERY_CURSOR_START, PAGE, &page);
+        micros[i] = (benchNowNs() - t0) / 1e3;
+        examined += page.total;
+        for (int k = 0; k < PAGE; ++k) {
+            if ((k < page.count ? matches[k] : -1) != expected[i * PAGE + k]) {
+                mismatches++;
+                break;
+            }
+        }
+    }
+    reportLatencies("passengers: by-flight", micros, queries, examined, mismatches);
+
+    // Cheapest departures from one airport
+    for (int i = 0; i < queries; ++i) targets[i] = (int)(benchRandom(&rng) % (uint64_t)airportCount);
+    examined = 0;
+    for (int i = 0; i < queries; ++i) {
+        uint64_t t0 = benchNowNs();
+        int found = 0;
+        for (int f = 0; f < flightCount; ++f) {
+            if (flightAt(f)->origin == targets[i]) matches[found++] = f;
+        }
+        qsort(matches, (size_t)found, sizeof(int), compareFlightPrices);
+        micros[i] = (benchNowNs() - t0) / 1e3;
+        for (int k = 0; k < PAGE; ++k) expected[i * PAGE + k] = k < found ? matches[k] : -1;
+        examined += flightCount;
+    }
+    reportLatencies("flights: scan + sort", micros, queries, examined, 0);
+
+    examined = 0;
+    mismatches = 0;
+    FlightQuery fq;
+    flightQueryInit(&fq);
+    fq.sort = FLIGHT_SORT_PRICE;
+    for (int i = 0; i < queries; ++i) {
+        fq.origin = airportCode(targets[i]);
+        QueryPage page;
+        page.records = matches;
+        uint64_t t0 = benchNowNs();
+        queryFlights(&fq, (QueryCursor)QUERY_CURSOR_START, PAGE, &page);
+        micros[i] = (benchNowNs() - t0) / 1e3;
+        examined += page.total;
+        for (int k = 0; k < PAGE; ++k) {
+            if ((k < page.count ? matches[k] : -1) != expected[i * PAGE + k]) {
+                mismatches++;
+                break;
+            }
+        }
+    }
+    reportLatencies("flights: by-origin", micros, queries, examined, mismatches);
+
+    free(targets);
+    free(micros);
+    free(expected);
+    free(matches);
+    resetStores();
+}
+
+/* ---------- Reports ---------- */
+
+#ifdef _WIN32
+#define BENCH_NULL_DEVICE "NUL"
+#else
+#define BENCH_NULL_DEVICE "/dev/null"
+#endif
+
+// The passenger listing as it was printed before the report writer: one fprintf per row
+static void printfPassengerReport(FILE* out) {
+    fprintf(out, "%-8s %-15s %-20s %-12s %-15s\n", "ID", "Name", "Email", "Flight", "Status");
+    for (int i = 0; i < passengerCount; i++) {
+        Passenger* p = passengerAt(i);
+        fprintf(out, "%-8s %-15s %-20s %-12s %-15s\n", p->id, strcat(strcpy((char[32]){}, p->firstName), strcat(strcpy((char[32]){}, " "), p->lastName)), p->email, flightAt(p->flightIndex)->flightNumber, checkInStatusName((CheckInStatus)p->checkInStatus));
+    }
+}
+
+static int sameFileContents(FILE* a, FILE* b) {
+    char bufA[65536], bufB[65536];
+    rewind(a);
+    rewind(b);
+    for (;;) {
+        size_t na = fread(bufA, 1, sizeof(bufA), a);
+        size_t nb = fread(bufB, 1, sizeof(bufB), b);
+        if (na != nb || memcmp(bufA, bufB, na) != 0) return 0;
+        if (na == 0) return 1;
+    }
+}
+
+static void benchReport(long passengers) {
+    if (passengers <= 0) passengers = 1000000;
+    resetStores();
+    generateFlightSchedule(passengers / 100 + 1, 2000, 20, 0x4E70ull);
+    uint64_t rng = 0x4E71ull;
+    Passenger p;
+    char flightNumber[FLIGHT_ID_LEN];
+    for (long i = 0; passengerCount < passengers && i < passengers * 4; ++i) {
+        generateBookingRequest(&p, flightNumber, i, flightCount, &rng);
+        bookPassenger(&p, flightNumber, NULL);
+    }
+    FILE* sink = fopen(BENCH_NULL_DEVICE, "wb");
+    FILE* reference = tmpfile();
+    FILE* rendered = tmpfile();
+    if (!sink || !reference || !rendered) {
+        printf("Unable to open the output files\n");
+        if (sink) fclose(sink);
+        if (reference) fclose(reference);
+        if (rendered) fclose(rendered);
+        resetStores();
+        return;
+    }
+    printfPassengerReport(reference);
+    fflush(reference);
+    long referenceBytes = ftell(reference);
+    printf("Passenger listing: %d rows\n", passengerCount);
+    printf("%-18s %-12s %-12s %-10s %-10s %-8s\n", "Renderer", "Bytes", "Time (ms)", "MB/s", "Speedup", "Match");
+
+    const int rounds = 3;
+    double baselineMs = 0.0;
+    for (int r = 0; r < rounds; ++r) {
+        uint64_t t0 = benchNowNs();
+        printfPassengerReport(sink);
+        fflush(sink);
+        double ms = (benchNowNs() - t0) / 1e6;
+        if (r == 0 || ms < baselineMs) baselineMs = ms;
+    }
+    printf("%-18s %-12ld %-12.1f %-10.0f %-10s %-8s\n", "fprintf per row", referenceBytes, baselineMs,
+           referenceBytes / (baselineMs * 1e3), "1.0x", "-");
+
+    for (int f = REPORT_TEXT; f <= REPORT_JSON; ++f) {
+        rewind(rendered);
+        int ok = writeReport(REPORT_PASSENGERS, rendered, (ReportFormat)f) == 0;
+        long bytes = ftell(rendered);
+        const char* match = "-";
+        if (f == REPORT_TEXT) {
+            fflush(rendered);
+            match = ok && bytes == referenceBytes && sameFileContents(reference, rendered) ? "yes" : "NO";
+        }
+        double bestMs = 0.0;
+        for (int r = 0; r < rounds; ++r) {
+            uint64_t t0 = benchNowNs();
+            writeReport(REPORT_PASSENGERS, sink, (ReportFormat)f);
+            double ms = (benchNowNs() - t0) / 1e6;
+            if (r == 0 || ms < bestMs) bestMs = ms;
+        }
+        char label[32], speedup[32];
+        snprintf(label, sizeof(label), "writer %s", reportFormatName((ReportFormat)f));
+        snprintf(speedup, sizeof(speedup), "%.1fx", baselineMs / bestMs);
+        printf("%-18s %-12ld %-12.1f %-10.0f %-10s %-8s\n", label, bytes, bestMs, bytes / (bestMs * 1e3), speedup, match);
+    }
+    fclose(sink);
+    fclose(reference);
+    fclose(rendered);
+    resetStores();
+}
+
+/* ---------- Kruskal ---------- */
+
+static int compareEdgeWeights(const void* a, const void* b) {
+    double x = ((const RouteEdge*)a)->weight, y = ((const RouteEdge*)b)->weight;
+    return (x > y) - (x < y);
+}
+
+// qsort with the same union-find, so the comparison isolates the edge sort.
+// (The old unranked, uncompressed find grows O(V) root chains here and never finishes.)
+static double qsortKruskal(int vertices, RouteEdge* edges, int edgeCount, int* forestEdges) {
+    int* parent = (int*)malloc(sizeof(int) * (size_t)vertices);
+    int* rank = (int*)calloc((size_t)vertices, sizeof(int));
+    if (!parent || !rank) {
+        free(parent);
+        free(rank);
+        return -1.0;
+    }
+    for (int v = 0; v < vertices; ++v) parent[v] = v;
+    qsort(edges, (size_t)edgeCount, sizeof(RouteEdge), compareEdgeWeights);
+    double weight = 0.0;
+    int count = 0;
+    for (int i = 0; i < edgeCount && count < vertices - 1; ++i) {
+        if (!disjointSetUnion(parent, rank, edges[i].src, edges[i].dest)) continue;
+        weight += edges[i].weight;
+        count++;
+    }
+    free(parent);
+    free(rank);
+    *forestEdges = count;
+    return weight;
+}
+
+static void benchKruskal(long maxEdges) {
+    if (maxEdges <= 0) maxEdges = 16L << 20;
+    WorkPool pool;
+    if (workPoolInit(&pool, 0) != 0) return;
+    printf("Average degree 16, fractional weights (all radix passes needed), %d worker thread(s)\n", pool.threadCount);
+    printf("%-10s %-10s %-22s %-12s %-10s %-8s\n", "Edges", "Airports", "Method", "Time (ms)", "Speedup", "Match");
+    for (long e = 1L << 20; e <= maxEdges; e *= 4) {
+        int vertices = (int)(e / 8);
+        RouteEdge* edges;
+        int edgeCount = generateRouteEdges(vertices, 16, 0x4B505Eull + (uint64_t)e, &edges);
+        if (edgeCount < 0) break;
+        uint64_t rng = 0xF12Aull;
+        for (int i = 0; i < edgeCount; ++i) edges[i].weight += (double)(benchRandom(&rng) % 1000000) / 1e6;
+        RouteEdge* work = (RouteEdge*)malloc(sizeof(RouteEdge) * (size_t)edgeCount);
+        MSTResultEdge* forest = (MSTResultEdge*)malloc(sizeof(MSTResultEdge) * (size_t)vertices);
+        if (!work || !forest) {
+            free(work);
+            free(forest);
+            free(edges);
+            break;
+        }
+        double baseMs = 0.0, baseWeight = 0.0;
+        for (int method = 0; method < 4; ++method) {
+            static const char* const names[] = { "qsort", "radix, 1 thread", "radix, pool", "Filter-Kruskal, pool" };
+            memcpy(work, edges, sizeof(RouteEdge) * (size_t)edgeCount);
+            int forestEdges = 0;
+            double weight;
+            uint64_t t0 = benchNowNs();
+            if (method == 0) {
+                weight = qsortKruskal(vertices, work, edgeCount, &forestEdges);
+            } else if (method == 3) {
+                weight = filterKruskalForest(vertices, work, edgeCount, forest, &forestEdges, &pool);
+            } else {
+                weight = kruskalForest(vertices, work, edgeCount, forest, &forestEdges, method == 2 ? &pool : NULL);
+            }
+            double ms = (benchNowNs() - t0) / 1e6;
+            if (method == 0) {
+                baseMs = ms;
+                baseWeight = weight;
+            }
+            double diff = weight - baseWeight;
+            int match = forestEdges == vertices - 1 && diff < 1e-9 * baseWeight && -diff < 1e-9 * baseWeight;
+            char speedup[32];
+            snprintf(speedup, sizeof(speedup), "%.1fx", baseMs / ms);
+            printf("%-10d %-10d %-22s %-12.1f %-10s %-8s\n", edgeCount, vertices, names[method], ms, speedup,
+                   match ? "yes" : "NO");
+        }
+        free(work);
+        free(forest);
+        free(edges);
+    }
+    workPoolDestroy(&pool);
+}
+
+static void benchMst(long maxVertices) {
+    if (maxVertices <= 0) maxVertices = 1L << 20;
+    WorkPool pool;
+    if (workPoolInit(&pool, 0) != 0) return;
+    printf("Minimum spanning forest per engine; matrix Prim up to 4096 airports, CSR/matrix builds not timed.\n");
+    printf("Filter-Kruskal and Boruvka use %d worker thread(s)\n", pool.threadCount);
+    printf("%-10s %-10s %-24s %-12s %-12s %-8s\n", "Airports", "Routes", "Engine", "Time (ms)", "ns/route", "Match");
+    for (long v = 1024; v <= maxVertices; v *= 4) {
+        for (int degree = 4; degree <= 32; degree *= 8) {
+            RouteEdge* edges;
+            int edgeCount = generateRouteEdges((int)v, degree, 0x3D57ull + (uint64_t)v * degree, &edges);
+            if (edgeCount < 0) break;
+            RouteEdge* work = (RouteEdge*)malloc(sizeof(RouteEdge) * (size_t)edgeCount);
+            MSTResultEdge* forest = (MSTResultEdge*)malloc(sizeof(MSTResultEdge) * (size_t)v);
+            CsrGraph csr;
+            int haveCsr = buildCsrGraph(&csr, (int)v, edges, edgeCount, 0) == 0;
+            RouteGraph matrix = { 0, 0, NULL };
+            if (v <= 4096) {
+                matrix = createRouteGraph((int)v, 0);
+                for (int i = 0; matrix.adjMatrix && i < edgeCount; ++i) {
+                    int a = edges[i].src, b = edges[i].dest;
+                    if (a != b && edges[i].weight < matrix.adjMatrix[a][b]) {
+                        matrix.adjMatrix[a][b] = matrix.adjMatrix[b][a] = edges[i].weight;
+                    }
+                }
+            }
+            if (!work || !forest || !haveCsr) {
+                free(work);
+                free(forest);
+                if (haveCsr) freeCsrGraph(&csr);
+                if (matrix.adjMatrix) freeRouteGraph(&matrix);
+                free(edges);
+                break;
+            }
+            double baseWeight = 0.0;
+            int baseEdges = 0;
+            for (int engine = 0; engine < 4; ++engine) {
+                static const char* const names[] = { "Filter-Kruskal, pool", "Prim, matrix scan", "Prim, indexed heap",
+                                                     "Boruvka, pool" };
+                if (engine == 1 && !matrix.adjMatrix) continue;
+                int forestEdges = 0;
+                double weight;
+                uint64_t t0 = benchNowNs();
+                if (engine == 0) {
+                    memcpy(work, edges, sizeof(RouteEdge) * (size_t)edgeCount);
+                    t0 = benchNowNs();
+                    weight = filterKruskalForest((int)v, work, edgeCount, forest, &forestEdges, &pool);
+                } else if (engine == 1) {
+                    weight = primMST(&matrix, forest, &forestEdges);
+                } else if (engine == 2) {
+                    weight = primForestCsr(&csr, forest, &forestEdges);
+                } else {
+                    weight = boruvkaForest((int)v, edges, edgeCount, forest, &forestEdges, &pool);
+                }
+                double ms = (benchNowNs() - t0) / 1e6;
+                if (engine == 0) {
+                    baseWeight = weight;
+                    baseEdges = forestEdges;
+                }
+                double diff = weight - baseWeight;
+                int match = forestEdges == baseEdges && diff < 1e-9 * baseWeight && -diff < 1e-9 * baseWeight;
+                printf("%-10ld %-10d %-24s %-12.2f %-12.1f %-8s\n", v, edgeCount, names[engine], ms, ms * 1e6 / edgeCount,
+                       match ? "yes" : "NO");
+            }
+            free(work);
+            free(forest);
+            freeCsrGraph(&csr);
+            if (matrix.adjMatrix) freeRouteGraph(&matrix);
+            free(edges);
+        }
+    }
+    workPoolDestroy(&pool);
+}
+
+/* ---------- Incremental route updates ---------- */
+
+enum { UPDATE_ADD, UPDATE_CANCEL, UPDATE_CHEAPER, UPDATE_DEARER, UPDATE_KINDS };
+static const char* const UPDATE_KIND_NAMES[UPDATE_KINDS] = { "add route", "cancel route", "reprice cheaper", "reprice dearer" };
+
+// Applies `count` updates cycling through the four kinds; micros[kind][i] gets each latency
+static void applyRouteUpdates(DynamicRoutes* g, int count, uint64_t* rng, double* micros[UPDATE_KINDS]) {
+    for (int i = 0; i < count; ++i) {
+        int kind = i % UPDATE_KINDS;
+        int route;
+        do {
+            route = (int)(benchRandom(rng) % (uint64_t)g->routeCount);
+        } while (g->routes[route].removed);
+        uint64_t t0 = benchNowNs();
+        if (kind == UPDATE_ADD) {
+            int src = (int)(benchRandom(rng) % (uint64_t)g->vertexCount);
+            int dest = (int)(benchRandom(rng) % (uint64_t)g->vertexCount);
+            t0 = benchNowNs();
+            dynamicRoutesAdd(g, src, dest, 100.0 + (double)(benchRandom(rng) % 2900));
+        } else if (kind == UPDATE_CANCEL) {
+            dynamicRoutesRemove(g, route);
+        } else if (kind == UPDATE_CHEAPER) {
+            dynamicRoutesReprice(g, route, g->routes[route].weight * 0.5);
+        } else {
+            dynamicRoutesReprice(g, route, g->routes[route].weight * 2.0);
+        }
+        micros[kind][i / UPDATE_KINDS] = (benchNowNs() - t0) / 1e3;
+    }
+}
+
+static void reportRouteUpdates(double* micros[UPDATE_KINDS], int perKind, double rebuildMs) {
+    printf("%-18s %-10s %-10s %-10s %-10s %-14s\n", "Update", "mean (us)", "p50 (us)", "p99 (us)", "max (us)",
+           "Rebuild/mean");
+    for (int k = 0; k < UPDATE_KINDS; ++k) {
+        double total = 0;
+        for (int i = 0; i < perKind; ++i) total += micros[k][i];
+        double mean = total / perKind;
+        qsort(micros[k], (size_t)perKind, sizeof(double), compareDoubles);
+        char speedup[32];
+        snprintf(speedup, sizeof(speedup), "%.0fx", mean > 0 ? rebuildMs * 1e3 / mean : 0.0);
+        printf("%-18s %-10.1f %-10.1f %-10.1f %-10.1f %-14s\n", UPDATE_KIND_NAMES[k], mean, micros[k][perKind / 2],
+               micros[k][(int)(perKind * 0.99)], micros[k][perKind - 1], speedup);
+    }
+}
+
+// Live routes of g as a plain edge list, for rebuilding from scratch
+static int liveRouteEdges(const DynamicRoutes* g, RouteEdge* out) {
+    int count = 0;
+    for (int i = 0; i < g->routeCount; ++i) {
+        if (g->routes[i].removed) continue;
+        out[count].src = g->routes[i].src;
+        out[count].dest = g->routes[i].dest;
+        out[count].weight = g->routes[i].weight;
+        count++;
+    }
+    return count;
+}
+
+static int fullDistanceRebuild(DistanceMatrix* dist, int vertices, const RouteEdge* edges, int edgeCount) {
+    RouteGraph graph = createRouteGraph(vertices, 0);
+    if (!graph.adjMatrix) return -1;
+    double** m = graph.adjMatrix;
+    for (int i = 0; i < edgeCount; ++i) {
+        const RouteEdge* e = &edges[i];
+        if (e->src == e->dest) continue;
+        if (m[e->src][e->dest] > e->weight) m[e->src][e->dest] = e->weight;
+        if (m[e->dest][e->src] > e->weight) m[e->dest][e->src] = e->weight;
+    }
+    int status = distanceMatrixFromGraph(dist, &graph);
+    freeRouteGraph(&graph);
+    if (status != 0) return -1;
+    if (apspBlockedFloydWarshall(dist, APSP_KERNEL_AUTO) < 0) {
+        distanceMatrixFree(dist);
+        return -1;
+    }
+    return 0;
+}
+
+static void benchRouteUpdate(long vertices) {
+    if (vertices <= 0) vertices = 100000;
+    const int degree = 8;
+    const int forestUpdates = 4000;
+    const int distanceUpdates = 400;
+    const int distanceVertices = vertices < 2000 ? (int)vertices : 2000;
+    double* micros[UPDATE_KINDS];
+    for (int k = 0; k < UPDATE_KINDS; ++k) micros[k] = (double*)malloc(sizeof(double) * forestUpdates);
+    uint64_t rng = 0x0DD5ull;
+
+    RouteEdge* edges;
+    int edgeCount = generateRouteEdges((int)vertices, degree, 0x5EEDull, &edges);
+    if (edgeCount < 0) return;
+    DynamicRoutes g;
+    uint64_t t0 = benchNowNs();
+    if (dynamicRoutesInit(&g, (int)vertices, edges, edgeCount, 0) != 0) {
+        printf("Unable to build the route network\n");
+        free(edges);
+        return;
+    }
+    double kruskalMs = (benchNowNs() - t0) / 1e6;
+    free(edges);
+    printf("Spanning forest: %ld airports, %d routes, Kruskal rebuild %.2f ms, %d updates\n", vertices, edgeCount,
+           kruskalMs, forestUpdates);
+    applyRouteUpdates(&g, forestUpdates, &rng, micros);
+    reportRouteUpdates(micros, forestUpdates / UPDATE_KINDS, kruskalMs);
+
+    RouteEdge* live = (RouteEdge*)malloc(sizeof(RouteEdge) * (size_t)g.liveRoutes);
+    int liveCount = liveRouteEdges(&g, live);
+    DynamicRoutes fresh;
+    if (dynamicRoutesInit(&fresh, g.vertexCount, live, liveCount, 0) == 0) {
+        double diff = fresh.forestWeight - g.forestWeight;
+        int match = fresh.forestEdges == g.forestEdges && diff < 1e-6 * fresh.forestWeight && -diff < 1e-6 * fresh.forestWeight;
+        printf("Forest after updates matches a fresh Kruskal: %s (weight %.1f, %d edges)\n", match ? "yes" : "NO",
+               g.forestWeight, g.forestEdges);
+        dynamicRoutesFree(&fresh);
+    }
+    free(live);
+    dynamicRoutesFree(&g);
+
+    edgeCount = generateRouteEdges(distanceVertices, degree, 0x5EEDull, &edges);
+    if (edgeCount < 0) return;
+    DistanceMatrix initial;
+    t0 = benchNowNs();
+    int rebuilt = fullDistanceRebuild(&initial, distanceVertices, edges, edgeCount);
+    double floydMs = (benchNowNs() - t0) / 1e6;
+    if (rebuilt != 0 || dynamicRoutesInit(&g, distanceVertices, edges, edgeCount, 0) != 0 ||
+        dynamicRoutesTrackDistances(&g, &initial) != 0) {
+        printf("Unable to allocate the distance table\n");
+        free(edges);
+        return;
+    }
+    free(edges);
+    printf("\nAll-pairs distances: %d airports, %d routes, Floyd-Warshall rebuild %.1f ms (%s), %d updates\n",
+           distanceVertices, edgeCount, floydMs, apspKernelName(apspDetectKernel()), distanceUpdates);
+    applyRouteUpdates(&g, distanceUpdates, &rng, micros);
+    reportRouteUpdates(micros, distanceUpdates / UPDATE_KINDS, floydMs);
+    printf("Per dearer/cancel update: %.1f sources repaired, %.1f targets re-settled\n",
+           (double)g.rowsRepaired / (distanceUpdates / 2), (double)g.targetsRepaired / (distanceUpdates / 2));
+
+    live = (RouteEdge*)malloc(sizeof(RouteEdge) * (size_t)g.liveRoutes);
+    liveCount = liveRouteEdges(&g, live);
+    DistanceMatrix expected;
+    if (fullDistanceRebuild(&expected, distanceVertices, live, liveCount) == 0) {
+        long mismatches = 0;
+        for (int i = 0; i < distanceVertices; ++i) {
+            const double* want = distanceMatrixRow(&expected, i);
+            const double* got = distanceMatrixRow(&g.dist, i);
+            for (int j = 0; j < distanceVertices; ++j) {
+                double diff = got[j] - want[j];
+                if (diff > 1e-9 * want[j] || -diff > 1e-9 * want[j]) mismatches++;
+            }
+        }
+        printf("Distances after updates match a fresh Floyd-Warshall: %s\n", mismatches ? "NO" : "yes");
+        distanceMatrixFree(&expected);
+    }
+    free(live);
+    dynamicRoutesFree(&g);
+    for (int k = 0; k < UPDATE_KINDS; ++k) free(micros[k]);
+}
+
+static const BenchCase BENCH_CASES[] = {
+    {"hash", "Flight/passenger hash index lookup, 1k..10M records", benchHashIndex},
+    {"arena", "Passenger inserts into chunked arena vs realloc-doubling array (default 50M)", benchArena},
+    {"checkin", "Check-in heap: 1M enqueue/dequeue pairs with 8 priority tiers", benchCheckInQueue},
+    {"checkin-mt", "Multi-producer/consumer check-in stress: raw ring and full service", benchCheckInThreads},
+    {"booking-mt", "Concurrent bookings on a few hot flights: bookings/sec vs threads", benchBookingThreads},
+    {"waitlist", "Cancellations, priority waitlists and overbooking under concurrent load", benchWaitlist},
+    {"seatmap", "Seat searches on an A380-size map: byte scan vs bitmap ctz, and concurrent claims", benchSeatMap},
+    {"wal", "Durable bookings/sec per log sync mode and thread count, with group commit", benchWal},
+    {"batch", "Streaming batch ingest of synthetic flight and booking rows", benchBatchIngest},
+    {"persist", "Snapshot write and mmap warm start (default 10M passengers)", benchPersist},
+    {"dijkstra", "Single-source shortest paths: dense matrix scan vs CSR + indexed heap", benchDijkstra},
+    {"apsp", "All-pairs Floyd-Warshall: textbook row-pointer loop vs blocked SIMD kernels", benchApsp},
+    {"apsp-mt", "All-pairs: blocked Floyd-Warshall vs work-stealing parallel Dijkstra, with cost-model pick", benchApspParallel},
+    {"routeload", "Stream a 10k-airport route file, intern codes, build CSR", benchRouteLoad},
+    {"route-query", "Point-to-point itineraries: bidirectional Dijkstra vs bidirectional A*, p50/p99 latency", benchRouteQuery},
+    {"journey", "Connection Scan earliest-arrival queries over a daily schedule", benchJourney},
+    {"report", "Passenger listing (default 1M rows): fprintf per row vs buffered report writer, text/CSV/JSON", benchReport},
+    {"query", "Filtered first-page queries (default 1M passengers): full scans vs secondary indexes", benchQuery},
+    {"flight-scan", "Fare/seat availability filter: AoS flight records vs SoA columns, scalar and SIMD", benchFlightScan},
+    {"kruskal", "Kruskal on 1M..16M edges: qsort baseline vs parallel radix sort vs Filter-Kruskal", benchKruskal},
+    {"mst", "Spanning forest engines vs V and E: matrix Prim, heap Prim, Filter-Kruskal, parallel Boruvka", benchMst},
+    {"route-update", "Incremental spanning forest and all-pairs updates vs full rebuild", benchRouteUpdate},
+};
+
+int runBenchmarks(int argc, char* argv[]) {
+    int caseCount = (int)(sizeof(BENCH_CASES) / sizeof(BENCH_CASES[0]));
+    const char* only = argc > 0 ? argv[0] : NULL;
+    long size = argc > 1 ? atol(argv[1]) : 0;
+    int ran = 0;
+    for (int i = 0; i < caseCount; ++i) {
+        if (only && strcmp(only, BENCH_CASES[i].name) != 0) continue;
+        printf("\n=== BENCH: %s ===\n%s\n", BENCH_CASES[i].name, BENCH_CASES[i].description);
+        BENCH_CASES[i].run(size);
+        ++ran;
+    }
+    if (!ran) {
+        printf("Unknown benchmark '%s'. Available:\n", only);
+        for (int i = 0; i < caseCount; ++i) printf("  %-10s %s\n", BENCH_CASES[i].name, BENCH_CASES[i].description);
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,8 @@
+#ifndef BENCH_H
+#define BENCH_H
+
+// Microbenchmarks, run with: airline --bench [name [size]]
+// (airline --bench-suite runs the percentile suite in benchsuite.h)
+int runBenchmarks(int argc, char* argv[]);
+
+#endif // BENCH_H
@@ -0,0 +1,159 @@
+#include "benchkit.h"
+#include "journey.h"
+#include "stores.h"
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+uint64_t benchNowNs(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ull + (uint64_t)ts.tv_nsec;
+}
+
+uint64_t benchRandom(uint64_t* state) {
+    uint64_t x = *state;
+    x ^= x >> 12;
+    x ^= x << 25;
+    x ^= x >> 27;
+    *state = x;
+    return x * 0x2545F4914F6CDD1Dull;
+}
+
+int compareDoubles(const void* a, const void* b) {
+    double x = *(const double*)a, y = *(const double*)b;
+    return (x > y) - (x < y);
+}
+
+void benchSamplesInit(BenchSamples* s) {
+    s->ns = NULL;
+    s->count = 0;
+    s->capacity = 0;
+}
+
+void benchSamplesFree(BenchSamples* s) {
+    free(s->ns);
+    benchSamplesInit(s);
+}
+
+void benchSamplesClear(BenchSamples* s) {
+    s->count = 0;
+}
+
+int benchSamplesAdd(BenchSamples* s, double ns) {
+    if (s->count == s->capacity) {
+        int capacity = s->capacity ? s->capacity * 2 : 256;
+        double* grown = (double*)realloc(s->ns, sizeof(double) * (size_t)capacity);
+        if (!grown) return -1;
+        s->ns = grown;
+        s->capacity = capacity;
+    }
+    s->ns[s->count++] = ns;
+    return 0;
+}
+
+static double nearestRank(const BenchSamples* s, double fraction) {
+    int rank = (int)ceil(fraction * s->count);
+    if (rank < 1) rank = 1;
+    return s->ns[rank - 1];
+}
+
+BenchStats benchSamplesSummarize(BenchSamples* s) {
+    BenchStats st;
+    memset(&st, 0, sizeof(st));
+    if (s->count == 0) return st;
+    qsort(s->ns, (size_t)s->count, sizeof(double), compareDoubles);
+    double sum = 0.0;
+    for (int i = 0; i < s->count; ++i) sum += s->ns[i];
+    st.count = s->count;
+    st.mean = sum / s->count;
+    double squares = 0.0;
+    for (int i = 0; i < s->count; ++i) squares += (s->ns[i] - st.mean) * (s->ns[i] - st.mean);
+    st.stddev = s->count > 1 ? sqrt(squares / (s->count - 1)) : 0.0;
+    st.min = s->ns[0];
+    st.p50 = nearestRank(s, 0.50);
+    st.p90 = nearestRank(s, 0.90);
+    st.p99 = nearestRank(s, 0.99);
+    st.max = s->ns[s->count - 1];
+    return st;
+}
+
+int generateRouteEdges(int vertices, int avgDegree, uint64_t seed, RouteEdge** out) {
+    long count = (long)vertices * avgDegree / 2;
+    if (count < vertices - 1) count = vertices - 1;
+    RouteEdge* edges = (RouteEdge*)malloc(sizeof(RouteEdge) * (size_t)(count > 0 ? count : 1));
+    if (!edges) return -1;
+    uint64_t rng = seed;
+    for (int v = 1; v < vertices; ++v) {
+        edges[v - 1].src = (int)(benchRandom(&rng) % (uint64_t)v);
+        edges[v - 1].dest = v;
+        edges[v - 1].weight = 100.0 + (double)(benchRandom(&rng) % 2900);
+    }
+    for (long i = vertices - 1; i < count; ++i) {
+        edges[i].src = (int)(benchRandom(&rng) % (uint64_t)vertices);
+        edges[i].dest = (int)(benchRandom(&rng) % (uint64_t)vertices);
+        edges[i].weight = 100.0 + (double)(benchRandom(&rng) % 2900);
+    }
+    *out = edges;
+    return (int)count;
+}
+
+void generateFlight(Flight* out, long serial, int airports, int hubs, uint64_t* rng) {
+    memset(out, 0, sizeof(*out));
+    int from = (int)(benchRandom(rng) % (uint64_t)airports);
+    int to = (int)(benchRandom(rng) % (uint64_t)airports);
+    if (serial % 3 == 0 && hubs > 0) to = (int)(benchRandom(rng) % (uint64_t)hubs);
+    if (to == from) to = (to + 1) % airports;
+    int dep = (int)(benchRandom(rng) % MINUTES_PER_DAY);
+    int arr = (dep + 45 + (int)(benchRandom(rng) % 540)) % MINUTES_PER_DAY;
+    snprintf(out->flightNumber, sizeof(out->flightNumber), "J%06u", (unsigned)serial % 1000000u);
+    snprintf(out->origin, sizeof(out->origin), "P%d", from);
+    snprintf(out->destination, sizeof(out->destination), "P%d", to);
+    snprintf(out->departureTime, sizeof(out->departureTime), "%02d:%02d", dep / 60, dep % 60);
+    snprintf(out->arrivalTime, sizeof(out->arrivalTime), "%02d:%02d", arr / 60, arr % 60);
+    strcpy(out->aircraft, "A320");
+    out->capacity = 180;
+    out->price = 99.0f + (float)(benchRandom(rng) % 400);
+    out->priority = 1 + (int)(benchRandom(rng) % 5);
+}
+
+long generateFlightSchedule(long flights, int airports, int hubs, uint64_t seed) {
+    uint64_t rng = seed;
+    long accepted = 0;
+    Flight f;
+    for (long i = 0; i < flights; ++i) {
+        generateFlight(&f, i, airports, hubs, &rng);
+        if (createFlight(&f, NULL) == BOOKING_OK) accepted++;
+    }
+    return accepted;
+}
+
+void generateBookingRequest(Passenger* out, char flightNumber[FLIGHT_ID_LEN], long serial, int knownFlights,
+                            uint64_t* rng) {
+    static const char* const FIRST[] = { "Ana", "Ben", "Chen", "Dara", "Eli", "Fatima", "Goran", "Hana" };
+    static const char* const LAST[] = { "Ito", "Jones", "Kumar", "Lopez", "Muller", "Novak", "Okafor", "Park" };
+    memset(out, 0, sizeof(*out));
+    snprintf(out->id, sizeof(out->id), "S%09ld", serial);
+    strcpy(out->firstName, FIRST[benchRandom(rng) % 8]);
+    strcpy(out->lastName, LAST[benchRandom(rng) % 8]);
+    snprintf(out->email, sizeof(out->email), "s%ld@example.com", serial);
+    snprintf(out->phone, sizeof(out->phone), "555%07ld", serial % 10000000);
+    if (knownFlights <= 0 || benchRandom(rng) % 50 == 0) {
+        snprintf(flightNumber, FLIGHT_ID_LEN, "ZZ%04d", (int)(serial % 10000));
+        return;
+    }
+    // Squaring a uniform draw piles demand onto the low indexes
+    double u = (double)(benchRandom(rng) >> 11) / 9007199254740992.0;
+    int flight = (int)(u * u * knownFlights);
+    strcpy(flightNumber, flightAt(flight)->flightNumber);
+}
+
+void generateCheckInBurst(int* passengerIndex, int* priority, int count, int passengers, uint64_t* rng) {
+    for (int i = 0; i < count; ++i) {
+        passengerIndex[i] = passengers > 0 ? (int)(benchRandom(rng) % (uint64_t)passengers) : 0;
+        int tier = (int)(benchRandom(rng) % 10);
+        priority[i] = tier == 0 ? 1 : tier <= 3 ? 2 : 3;
+    }
+}
@@ -0,0 +1,69 @@
+#ifndef BENCHKIT_H
+#define BENCHKIT_H
+
+#include "airline.h"
+#include "routegraph.h"
+#include <stdint.h>
+
+// Pieces shared by the microbenchmarks and the benchmark suite
+
+// CLOCK_MONOTONIC in nanoseconds
+uint64_t benchNowNs(void);
+// xorshift64*: fixed seeds keep every run reproducible
+uint64_t benchRandom(uint64_t* state);
+int compareDoubles(const void* a, const void* b);
+
+/*
+ * Latency samples in nanoseconds. Percentiles use the nearest rank, so
+ * p99 of 100 samples is the 99th smallest and always a measured value.
+ */
+typedef struct {
+    double* ns;
+    int count;
+    int capacity;
+} BenchSamples;
+
+typedef struct {
+    int count;
+    double min;
+    double mean;
+    double stddev;
+    double p50;
+    double p90;
+    double p99;
+    double max;
+} BenchStats;
+
+void benchSamplesInit(BenchSamples* s);
+void benchSamplesFree(BenchSamples* s);
+void benchSamplesClear(BenchSamples* s);
+// Returns 0 or -1 on allocation failure.
+int benchSamplesAdd(BenchSamples* s, double ns);
+// Sorts the samples in place; all zero when there are none.
+BenchStats benchSamplesSummarize(BenchSamples* s);
+
+/*
+ * Seeded synthetic workloads
+ */
+
+// Connected random network: a random spanning tree plus extra routes up to
+// avgDegree per airport, integer weights 100..2999. Returns the edge count or -1.
+int generateRouteEdges(int vertices, int avgDegree, uint64_t seed, RouteEdge** out);
+
+// Departure number `serial`: flight "J<serial>" between airports "P0".."P<airports-1>",
+// every third one into the first `hubs` airports, 180 seats, at a random time of day.
+void generateFlight(Flight* out, long serial, int airports, int hubs, uint64_t* rng);
+// Adds departures 0..flights-1 to the flight store; returns how many were accepted.
+long generateFlightSchedule(long flights, int airports, int hubs, uint64_t seed);
+
+// Booking request number `serial` against the first `knownFlights` flights in
+// the store. Demand is skewed towards low flight indexes so popular flights
+// sell out; about 2% of requests name a flight that does not exist.
+void generateBookingRequest(Passenger* out, char flightNumber[FLIGHT_ID_LEN], long serial, int knownFlights,
+                            uint64_t* rng);
+
+// A check-in rush: count passengers drawn from the first `passengers` records,
+// about 10% VIP (1), 30% regular (2), the rest tier 3.
+void generateCheckInBurst(int* passengerIndex, int* priority, int count, int passengers, uint64_t* rng);
+
+#endif // BENCHKIT_H
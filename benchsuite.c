@@ -0,0 +1,642 @@
+#include "benchsuite.h"
+#include "benchkit.h"
+#include "airline.h"
+#include "stores.h"
+#include "journey.h"
+#include "routenetwork.h"
+#include "routequery.h"
+#include "routeupdate.h"
+#include "spanningtree.h"
+#include "workpool.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#define SUITE_HUBS 20
+#define SUITE_NOTE_LEN 160
+
+typedef struct {
+    int airports;
+    int degree;
+    long flights;
+    long bookings;
+    int burst;
+    int queries;
+    int repetitions;
+    int warmup;
+    unsigned long long seed;
+    const char* only;
+    const char* label;
+    const char* jsonPath;
+} SuiteConfig;
+
+typedef struct {
+    const SuiteConfig* cfg;
+    uint64_t rng;
+    long flightSerial; // next departure handed to the generator
+    long bookingSerial;
+    long bookingOutcome[BOOKING_NO_MEMORY + 1];
+    int* burstPassenger;
+    int* burstPriority;
+    int* scanMatches;
+    long scanFound;
+    Timetable timetable;
+    int haveTimetable;
+    Journey journey;
+    RouteNetwork net;
+    int haveNetwork;
+    CsrGraph csr;
+    RouteEdge* work;
+    MSTResultEdge* forest;
+    WorkPool pool;
+    double* dist;
+    IndexedHeap heap;
+    RouteQuery query;
+    int haveQuery;
+    RouteItinerary itinerary;
+    DynamicRoutes routes;
+    int haveRoutes;
+    char note[SUITE_NOTE_LEN]; // extra detail for the current operation's report
+} SuiteState;
+
+enum { PER_FLIGHT, PER_BOOKING, PER_CHECKIN, PER_QUERY, PER_REPETITION };
+
+typedef struct {
+    const char* name;
+    const char* measures; // what one sample covers
+    int samples;          // which configured count sets the number of samples
+    int (*setup)(SuiteState* st);           // 0, or -1 to skip the operation
+    double (*run)(SuiteState* st, long i);  // one call; its latency in ns, or -1 on failure
+    void (*teardown)(SuiteState* st);
+} SuiteOp;
+
+typedef struct {
+    const SuiteOp* op;
+    int warmup;
+    int failures;
+    BenchStats stats;
+    char note[SUITE_NOTE_LEN];
+} SuiteResult;
+
+/* ---------- Shared fixtures, built on first use so any subset can run alone ---------- */
+
+static void addFlights(SuiteState* st, long count) {
+    Flight f;
+    for (long i = 0; i < count; ++i) {
+        generateFlight(&f, st->flightSerial++, st->cfg->airports, SUITE_HUBS, &st->rng);
+        createFlight(&f, NULL);
+    }
+}
+
+static int ensureFlights(SuiteState* st) {
+    if (flightCount == 0) addFlights(st, st->cfg->flights);
+    return flightCount > 0 ? 0 : -1;
+}
+
+static int ensurePassengers(SuiteState* st) {
+    if (ensureFlights(st) != 0) return -1;
+    Passenger p;
+    char flightNumber[FLIGHT_ID_LEN];
+    for (long i = 0; passengerCount == 0 && i < st->cfg->bookings; ++i) {
+        generateBookingRequest(&p, flightNumber, st->bookingSerial++, flightCount, &st->rng);
+        bookPassenger(&p, flightNumber, NULL);
+    }
+    return passengerCount > 0 ? 0 : -1;
+}
+
+static int ensureNetwork(SuiteState* st) {
+    if (st->haveNetwork) return 0;
+    const SuiteConfig* cfg = st->cfg;
+    char code[AIRPORT_CODE_LEN];
+    for (int v = 0; v < cfg->airports; ++v) {
+        snprintf(code, sizeof(code), "N%d", v);
+        if (routeNetworkIntern(&st->net, code) != v) return -1;
+    }
+    RouteEdge* edges;
+    int edgeCount = generateRouteEdges(cfg->airports, cfg->degree, cfg->seed ^ 0x5EEDull, &edges);
+    if (edgeCount < 0) return -1;
+    for (int i = 0; i < edgeCount; ++i) {
+        if (routeNetworkAddRoute(&st->net, edges[i].src, edges[i].dest, edges[i].weight) != 0) {
+            free(edges);
+            return -1;
+        }
+    }
+    free(edges);
+    size_t routes = (size_t)(st->net.routeCount > 0 ? st->net.routeCount : 1);
+    st->work = (RouteEdge*)malloc(sizeof(RouteEdge) * routes);
+    st->forest = (MSTResultEdge*)malloc(sizeof(MSTResultEdge) * (size_t)cfg->airports);
+    st->dist = (double*)malloc(sizeof(double) * (size_t)cfg->airports);
+    if (!st->work || !st->forest || !st->dist || routeNetworkBuildCsr(&st->net, &st->csr) != 0) return -1;
+    if (indexedHeapInit(&st->heap, cfg->airports) != 0) {
+        freeCsrGraph(&st->csr);
+        return -1;
+    }
+    st->haveNetwork = 1;
+    return 0;
+}
+
+static long randomBelow(SuiteState* st, long n) {
+    return n > 0 ? (long)(benchRandom(&st->rng) % (uint64_t)n) : 0;
+}
+
+static void drainCheckIns(void) {
+    CheckInNode node;
+    while (dequeueCheckIn(&node) == 0) {
+    }
+}
+
+static int prepareBurst(SuiteState* st) {
+    int count = st->cfg->warmup + st->cfg->burst;
+    free(st->burstPassenger);
+    free(st->burstPriority);
+    st->burstPassenger = (int*)malloc(sizeof(int) * (size_t)count);
+    st->burstPriority = (int*)malloc(sizeof(int) * (size_t)count);
+    if (!st->burstPassenger || !st->burstPriority) return -1;
+    generateCheckInBurst(st->burstPassenger, st->burstPriority, count, passengerCount, &st->rng);
+    return 0;
+}
+
+/* ---------- Flight and passenger store ---------- */
+
+static int setupFlightCreate(SuiteState* st) {
+    resetStores();
+    st->flightSerial = 0;
+    st->bookingSerial = 0;
+    return 0;
+}
+
+static double runFlightCreate(SuiteState* st, long i) {
+    (void)i;
+    Flight f;
+    generateFlight(&f, st->flightSerial++, st->cfg->airports, SUITE_HUBS, &st->rng);
+    uint64_t t0 = benchNowNs();
+    BookingStatus status = createFlight(&f, NULL);
+    double ns = (double)(benchNowNs() - t0);
+    return status == BOOKING_OK ? ns : -1.0;
+}
+
+static double runFlightLookup(SuiteState* st, long i) {
+    (void)i;
+    char number[FLIGHT_ID_LEN];
+    strcpy(number, flightAt((int)randomBelow(st, flightCount))->flightNumber);
+    uint64_t t0 = benchNowNs();
+    int found = findFlightIndex(number);
+    double ns = (double)(benchNowNs() - t0);
+    return found >= 0 ? ns : -1.0;
+}
+
+static int setupBooking(SuiteState* st) {
+    memset(st->bookingOutcome, 0, sizeof(st->bookingOutcome));
+    return ensureFlights(st);
+}
+
+static double runBooking(SuiteState* st, long i) {
+    (void)i;
+    Passenger p;
+    char flightNumber[FLIGHT_ID_LEN];
+    generateBookingRequest(&p, flightNumber, st->bookingSerial++, flightCount, &st->rng);
+    uint64_t t0 = benchNowNs();
+    BookingStatus status = bookPassenger(&p, flightNumber, NULL);
+    double ns = (double)(benchNowNs() - t0);
+    st->bookingOutcome[status]++;
+    // Full flights and unknown flight numbers are part of the stream; only real errors count as failures
+    return status == BOOKING_NO_MEMORY ? -1.0 : ns;
+}
+
+static void teardownBooking(SuiteState* st) {
+    snprintf(st->note, sizeof(st->note), "booked %ld, flight full %ld, unknown flight %ld, duplicate %ld",
+             st->bookingOutcome[BOOKING_OK], st->bookingOutcome[BOOKING_FLIGHT_FULL],
+             st->bookingOutcome[BOOKING_FLIGHT_NOT_FOUND], st->bookingOutcome[BOOKING_DUPLICATE_ID]);
+}
+
+static double runPassengerLookup(SuiteState* st, long i) {
+    (void)i;
+    char id[NAME_LEN];
+    strcpy(id, passengerAt((int)randomBelow(st, passengerCount))->id);
+    uint64_t t0 = benchNowNs();
+    int found = findPassengerIndex(id);
+    double ns = (double)(benchNowNs() - t0);
+    return found >= 0 ? ns : -1.0;
+}
+
+static int setupFlightScan(SuiteState* st) {
+    if (ensureFlights(st) != 0) return -1;
+    free(st->scanMatches);
+    st->scanMatches = (int*)malloc(sizeof(int) * (size_t)flightCount);
+    st->scanFound = 0;
+    return st->scanMatches ? 0 : -1;
+}
+
+static double runFlightScan(SuiteState* st, long i) {
+    (void)i;
+    float maxPrice = 99.0f + (float)randomBelow(st, 400);
+    int minSeats = 1 + (int)randomBelow(st, 4);
+    uint64_t t0 = benchNowNs();
+    int found = flightColumnsFindAvailable(&flightColumns, flightCount, maxPrice, minSeats, st->scanMatches, FLIGHT_SCAN_AUTO);
+    double ns = (double)(benchNowNs() - t0);
+    st->scanFound += found;
+    return found >= 0 ? ns : -1.0;
+}
+
+static void teardownFlightScan(SuiteState* st) {
+    snprintf(st->note, sizeof(st->note), "%s kernel, %ld matches in all", flightScanKernelName(flightScanDetectKernel()),
+             st->scanFound);
+}
+
+/* ---------- Check-in rush ---------- */
+
+static int setupCheckInEnqueue(SuiteState* st) {
+    if (ensurePassengers(st) != 0) return -1;
+    drainCheckIns();
+    return prepareBurst(st);
+}
+
+static double runCheckInEnqueue(SuiteState* st, long i) {
+    uint64_t t0 = benchNowNs();
+    int status = enqueueCheckIn(st->burstPassenger[i], st->burstPriority[i]);
+    double ns = (double)(benchNowNs() - t0);
+    return status == 0 ? ns : -1.0;
+}
+
+static int setupCheckInDequeue(SuiteState* st) {
+    if (setupCheckInEnqueue(st) != 0) return -1;
+    for (int i = 0; i < st->cfg->warmup + st->cfg->burst; ++i) {
+        if (enqueueCheckIn(st->burstPassenger[i], st->burstPriority[i]) != 0) return -1;
+    }
+    return 0;
+}
+
+static double runCheckInDequeue(SuiteState* st, long i) {
+    (void)st;
+    (void)i;
+    CheckInNode node;
+    uint64_t t0 = benchNowNs();
+    int status = dequeueCheckIn(&node);
+    double ns = (double)(benchNowNs() - t0);
+    return status == 0 ? ns : -1.0;
+}
+
+static void teardownCheckIn(SuiteState* st) {
+    (void)st;
+    drainCheckIns();
+}
+
+/* ---------- Schedule ---------- */
+
+static double runTimetableBuild(SuiteState* st, long i) {
+    (void)i;
+    if (st->haveTimetable) timetableFree(&st->timetable);
+    timetableInit(&st->timetable, JOURNEY_MIN_CONNECTION_MINUTES);
+    uint64_t t0 = benchNowNs();
+    int status = timetableBuildFromFlights(&st->timetable);
+    double ns = (double)(benchNowNs() - t0);
+    st->haveTimetable = status == 0;
+    return status == 0 ? ns : -1.0;
+}
+
+static int setupJourney(SuiteState* st) {
+    if (ensureFlights(st) != 0) return -1;
+    if (!st->haveTimetable && runTimetableBuild(st, 0) < 0) return -1;
+    return 0;
+}
+
+static double runJourney(SuiteState* st, long i) {
+    (void)i;
+    int airports = st->timetable.airports.airportCount;
+    int from = (int)randomBelow(st, airports);
+    int to = (int)randomBelow(st, airports);
+    int after = (int)randomBelow(st, MINUTES_PER_DAY);
+    uint64_t t0 = benchNowNs();
+    int status = timetableEarliestArrival(&st->timetable, from, to, after, &st->journey);
+    double ns = (double)(benchNowNs() - t0);
+    return status >= 0 ? ns : -1.0;
+}
+
+/* ---------- Route network ---------- */
+
+static double runCsrBuild(SuiteState* st, long i) {
+    (void)i;
+    CsrGraph csr;
+    uint64_t t0 = benchNowNs();
+    int status = routeNetworkBuildCsr(&st->net, &csr);
+    double ns = (double)(benchNowNs() - t0);
+    if (status != 0) return -1.0;
+    freeCsrGraph(&csr);
+    return ns;
+}
+
+static double runFilterKruskal(SuiteState* st, long i) {
+    (void)i;
+    int edges;
+    memcpy(st->work, st->net.routes, sizeof(RouteEdge) * (size_t)st->net.routeCount);
+    uint64_t t0 = benchNowNs();
+    double weight = filterKruskalForest(st->net.airportCount, st->work, st->net.routeCount, st->forest, &edges, &st->pool);
+    double ns = (double)(benchNowNs() - t0);
+    return weight >= 0 ? ns : -1.0;
+}
+
+static double runBoruvka(SuiteState* st, long i) {
+    (void)i;
+    int edges;
+    uint64_t t0 = benchNowNs();
+    double weight = boruvkaForest(st->net.airportCount, st->net.routes, st->net.routeCount, st->forest, &edges, &st->pool);
+    double ns = (double)(benchNowNs() - t0);
+    return weight >= 0 ? ns : -1.0;
+}
+
+static double runPrimHeap(SuiteState* st, long i) {
+    (void)i;
+    int edges;
+    uint64_t t0 = benchNowNs();
+    double weight = primForestCsr(&st->csr, st->forest, &edges);
+    double ns = (double)(benchNowNs() - t0);
+    return weight >= 0 ? ns : -1.0;
+}
+
+static double runDijkstra(SuiteState* st, long i) {
+    (void)i;
+    int src = (int)randomBelow(st, st->net.airportCount);
+    uint64_t t0 = benchNowNs();
+    dijkstraCsrWithHeap(&st->csr, src, st->dist, &st->heap);
+    return (double)(benchNowNs() - t0);
+}
+
+static int setupItinerary(SuiteState* st) {
+    if (ensureNetwork(st) != 0) return -1;
+    if (!st->haveQuery && routeQueryInit(&st->query, &st->net, &st->csr) != 0) return -1;
+    st->haveQuery = 1;
+    return 0;
+}
+
+static double runItinerary(SuiteState* st, long i) {
+    (void)i;
+    int src = (int)randomBelow(st, st->net.airportCount);
+    int dest = (int)randomBelow(st, st->net.airportCount);
+    uint64_t t0 = benchNowNs();
+    int status = routeQueryBest(&st->query, src, dest, &st->itinerary);
+    double ns = (double)(benchNowNs() - t0);
+    return status >= 0 ? ns : -1.0;
+}
+
+static int setupRouteUpdate(SuiteState* st) {
+    if (ensureNetwork(st) != 0) return -1;
+    if (st->haveRoutes) return 0;
+    if (dynamicRoutesInit(&st->routes, st->net.airportCount, st->net.routes, st->net.routeCount, 0) != 0) return -1;
+    st->haveRoutes = 1;
+    return 0;
+}
+
+static double runRouteAdd(SuiteState* st, long i) {
+    (void)i;
+    int src = (int)randomBelow(st, st->net.airportCount);
+    int dest = (int)randomBelow(st, st->net.airportCount);
+    double weight = 100.0 + (double)randomBelow(st, 2900);
+    uint64_t t0 = benchNowNs();
+    int route = dynamicRoutesAdd(&st->routes, src, dest, weight);
+    double ns = (double)(benchNowNs() - t0);
+    return route >= 0 ? ns : -1.0;
+}
+
+static const SuiteOp SUITE_OPS[] = {
+    { "flight.create", "createFlight() of one generated departure", PER_FLIGHT, setupFlightCreate, runFlightCreate, NULL },
+    { "flight.lookup", "findFlightIndex() of a random existing flight", PER_QUERY, ensureFlights, runFlightLookup, NULL },
+    { "flight.scan", "flightColumnsFindAvailable() with a random fare cap and party size", PER_REPETITION,
+      setupFlightScan, runFlightScan, teardownFlightScan },
+    { "booking.create", "bookPassenger() of one request from the booking stream", PER_BOOKING, setupBooking, runBooking,
+      teardownBooking },
+    { "passenger.lookup", "findPassengerIndex() of a random booked passenger", PER_QUERY, ensurePassengers,
+      runPassengerLookup, NULL },
+    { "checkin.enqueue", "enqueueCheckIn() during a check-in rush", PER_CHECKIN, setupCheckInEnqueue, runCheckInEnqueue,
+      teardownCheckIn },
+    { "checkin.dequeue", "dequeueCheckIn() draining a full rush", PER_CHECKIN, setupCheckInDequeue, runCheckInDequeue,
+      teardownCheckIn },
+    { "timetable.build", "timetableBuildFromFlights() over the whole schedule", PER_REPETITION, ensureFlights,
+      runTimetableBuild, NULL },
+    { "journey.query", "timetableEarliestArrival() between random airports", PER_QUERY, setupJourney, runJourney, NULL },
+    { "network.csr", "routeNetworkBuildCsr() of the generated network", PER_REPETITION, ensureNetwork, runCsrBuild, NULL },
+    { "mst.filter-kruskal", "filterKruskalForest() on the worker pool", PER_REPETITION, ensureNetwork, runFilterKruskal,
+      NULL },
+    { "mst.boruvka", "boruvkaForest() on the worker pool", PER_REPETITION, ensureNetwork, runBoruvka, NULL },
+    { "mst.prim-heap", "primForestCsr()", PER_REPETITION, ensureNetwork, runPrimHeap, NULL },
+    { "sssp.dijkstra", "dijkstraCsrWithHeap() from a random airport", PER_REPETITION, ensureNetwork, runDijkstra, NULL },
+    { "route.itinerary", "routeQueryBest() between random airports", PER_QUERY, setupItinerary, runItinerary, NULL },
+    { "route.add", "dynamicRoutesAdd() keeping the spanning forest current", PER_QUERY, setupRouteUpdate, runRouteAdd,
+      NULL },
+};
+
+/* ---------- Reporting ---------- */
+
+static void printJsonString(FILE* out, const char* s) {
+    fputc('"', out);
+    for (; *s; ++s) {
+        unsigned char c = (unsigned char)*s;
+        if (c == '"' || c == '\\') {
+            fprintf(out, "\\%c", c);
+        } else if (c < 0x20) {
+            fprintf(out, "\\u%04x", c);
+        } else {
+            fputc(c, out);
+        }
+    }
+    fputc('"', out);
+}
+
+static int writeJsonReport(const char* path, const SuiteConfig* cfg, const SuiteResult* results, int count, int threads) {
+    FILE* out = strcmp(path, "-") == 0 ? stdout : fopen(path, "w");
+    if (!out) return -1;
+    char stamp[32];
+    time_t now = time(NULL);
+    strftime(stamp, sizeof(stamp), "%Y-%m-%dT%H:%M:%SZ", gmtime(&now));
+    fprintf(out, "{\n  \"schema\": \"airline-bench-suite/1\",\n  \"label\": ");
+    printJsonString(out, cfg->label);
+    fprintf(out, ",\n  \"timestamp\": \"%s\",\n  \"threads\": %d,\n", stamp, threads);
+    fprintf(out,
+            "  \"config\": {\"airports\": %d, \"degree\": %d, \"flights\": %ld, \"bookings\": %ld, \"burst\": %d, "
+            "\"queries\": %d, \"repetitions\": %d, \"warmup\": %d, \"seed\": %llu},\n",
+            cfg->airports, cfg->degree, cfg->flights, cfg->bookings, cfg->burst, cfg->queries, cfg->repetitions,
+            cfg->warmup, cfg->seed);
+    fprintf(out, "  \"results\": [");
+    for (int i = 0; i < count; ++i) {
+        const SuiteResult* r = &results[i];
+        const BenchStats* s = &r->stats;
+        fprintf(out, "%s\n    {\"name\": ", i ? "," : "");
+        printJsonString(out, r->op->name);
+        fprintf(out, ", \"measures\": ");
+        printJsonString(out, r->op->measures);
+        fprintf(out,
+                ", \"unit\": \"ns\", \"warmup\": %d, \"samples\": %d, \"failures\": %d, \"min\": %.1f, \"mean\": %.1f, "
+                "\"stddev\": %.1f, \"p50\": %.1f, \"p90\": %.1f, \"p99\": %.1f, \"max\": %.1f, \"opsPerSec\": %.1f",
+                r->warmup, s->count, r->failures, s->min, s->mean, s->stddev, s->p50, s->p90, s->p99, s->max,
+                s->mean > 0 ? 1e9 / s->mean : 0.0);
+        if (r->note[0]) {
+            fprintf(out, ", \"note\": ");
+            printJsonString(out, r->note);
+        }
+        fprintf(out, "}");
+    }
+    fprintf(out, "\n  ]\n}\n");
+    if (out == stdout) return fflush(out) == 0 ? 0 : -1;
+    return fclose(out) == 0 ? 0 : -1;
+}
+
+static void printSuiteUsage(void) {
+    printf("Usage: airline --bench-suite [--airports N] [--degree N] [--flights N] [--bookings N] [--burst N]\n"
+           "                             [--queries N] [--reps N] [--warmup N] [--seed N]\n"
+           "                             [--only PREFIX] [--label TEXT] [--json PATH|-]\n");
+    printf("Operations:\n");
+    for (size_t i = 0; i < sizeof(SUITE_OPS) / sizeof(SUITE_OPS[0]); ++i) {
+        printf("  %-20s %s\n", SUITE_OPS[i].name, SUITE_OPS[i].measures);
+    }
+}
+
+// Parses "--name value" pairs; returns 0, or -1 on an unknown option or bad number
+static int parseSuiteOptions(int argc, char* argv[], SuiteConfig* cfg) {
+    for (int i = 0; i < argc; i += 2) {
+        const char* opt = argv[i];
+        if (i + 1 >= argc) return -1;
+        const char* value = argv[i + 1];
+        char* end;
+        long long n = strtoll(value, &end, 10);
+        int numeric = *value && *end == '\0' && n > 0 && n <= 1000000000LL;
+        if (strcmp(opt, "--only") == 0) {
+            cfg->only = value;
+        } else if (strcmp(opt, "--label") == 0) {
+            cfg->label = value;
+        } else if (strcmp(opt, "--json") == 0) {
+            cfg->jsonPath = value;
+        } else if (strcmp(opt, "--seed") == 0) {
+            cfg->seed = strtoull(value, &end, 0);
+            if (!*value || *end) return -1;
+        } else if (strcmp(opt, "--warmup") == 0 && *value && *end == '\0' && n >= 0 && n <= 1000000) {
+            cfg->warmup = (int)n;
+        } else if (!numeric) {
+            return -1;
+        } else if (strcmp(opt, "--airports") == 0 && n >= 2) {
+            cfg->airports = (int)n;
+        } else if (strcmp(opt, "--degree") == 0) {
+            cfg->degree = (int)n;
+        } else if (strcmp(opt, "--flights") == 0 && n < 1000000) {
+            cfg->flights = (long)n;
+        } else if (strcmp(opt, "--bookings") == 0) {
+            cfg->bookings = (long)n;
+        } else if (strcmp(opt, "--burst") == 0) {
+            cfg->burst = (int)n;
+        } else if (strcmp(opt, "--queries") == 0) {
+            cfg->queries = (int)n;
+        } else if (strcmp(opt, "--reps") == 0) {
+            cfg->repetitions = (int)n;
+        } else {
+            return -1;
+        }
+    }
+    return 0;
+}
+
+static long sampleCount(const SuiteConfig* cfg, int kind) {
+    switch (kind) {
+    case PER_FLIGHT: return cfg->flights;
+    case PER_BOOKING: return cfg->bookings;
+    case PER_CHECKIN: return cfg->burst;
+    case PER_QUERY: return cfg->queries;
+    default: return cfg->repetitions;
+    }
+}
+
+static void freeSuiteState(SuiteState* st) {
+    free(st->burstPassenger);
+    free(st->burstPriority);
+    free(st->scanMatches);
+    if (st->haveTimetable) timetableFree(&st->timetable);
+    journeyFree(&st->journey);
+    routeItineraryFree(&st->itinerary);
+    if (st->haveQuery) routeQueryFree(&st->query);
+    if (st->haveRoutes) dynamicRoutesFree(&st->routes);
+    if (st->haveNetwork) {
+        freeCsrGraph(&st->csr);
+        indexedHeapFree(&st->heap);
+    }
+    routeNetworkFree(&st->net);
+    free(st->work);
+    free(st->forest);
+    free(st->dist);
+}
+
+int runBenchSuite(int argc, char* argv[]) {
+    SuiteConfig cfg = { 20000, 8, 100000, 200000, 50000, 2000, 20, 3, 42, NULL, "", NULL };
+    if (parseSuiteOptions(argc, argv, &cfg) != 0) {
+        printSuiteUsage();
+        return 1;
+    }
+    SuiteState st;
+    memset(&st, 0, sizeof(st));
+    st.cfg = &cfg;
+    st.rng = cfg.seed ? cfg.seed : 1;
+    journeyInit(&st.journey);
+    routeItineraryInit(&st.itinerary);
+    routeNetworkInit(&st.net, 0);
+    if (workPoolInit(&st.pool, 0) != 0) {
+        printf("Unable to start the worker pool\n");
+        return 1;
+    }
+    resetStores();
+
+    // With JSON on stdout the human-readable table moves to stderr
+    FILE* table = cfg.jsonPath && strcmp(cfg.jsonPath, "-") == 0 ? stderr : stdout;
+    int opCount = (int)(sizeof(SUITE_OPS) / sizeof(SUITE_OPS[0]));
+    SuiteResult* results = (SuiteResult*)calloc((size_t)opCount, sizeof(SuiteResult));
+    BenchSamples samples;
+    benchSamplesInit(&samples);
+    fprintf(table, "Seed %llu  airports %d  degree %d  flights %ld  bookings %ld  burst %d  warmup %d  threads %d\n",
+            cfg.seed, cfg.airports, cfg.degree, cfg.flights, cfg.bookings, cfg.burst, cfg.warmup, st.pool.threadCount);
+    fprintf(table, "%-20s %-9s %-11s %-11s %-11s %-11s %-11s %-12s\n", "Operation", "Samples", "mean (us)", "p50 (us)",
+            "p90 (us)", "p99 (us)", "max (us)", "ops/s");
+    int ran = 0;
+    int status = 0;
+    for (int k = 0; results && k < opCount; ++k) {
+        const SuiteOp* op = &SUITE_OPS[k];
+        if (cfg.only && strncmp(op->name, cfg.only, strlen(cfg.only)) != 0) continue;
+        st.note[0] = '\0';
+        if (op->setup && op->setup(&st) != 0) {
+            fprintf(table, "%-20s skipped (setup failed)\n", op->name);
+            status = 1;
+            continue;
+        }
+        long count = sampleCount(&cfg, op->samples);
+        SuiteResult* r = &results[ran++];
+        r->op = op;
+        r->warmup = cfg.warmup;
+        benchSamplesClear(&samples);
+        for (long i = 0; i < cfg.warmup + count; ++i) {
+            double ns = op->run(&st, i);
+            if (i < cfg.warmup) continue;
+            if (ns < 0 || benchSamplesAdd(&samples, ns) != 0) r->failures++;
+        }
+        if (op->teardown) op->teardown(&st);
+        r->stats = benchSamplesSummarize(&samples);
+        memcpy(r->note, st.note, sizeof(r->note));
+        const BenchStats* s = &r->stats;
+        fprintf(table, "%-20s %-9d %-11.3f %-11.3f %-11.3f %-11.3f %-11.3f %-12.0f\n", op->name, s->count, s->mean / 1e3,
+                s->p50 / 1e3, s->p90 / 1e3, s->p99 / 1e3, s->max / 1e3, s->mean > 0 ? 1e9 / s->mean : 0.0);
+        if (r->failures) fprintf(table, "%-20s %d call(s) failed\n", "", r->failures);
+        if (r->note[0]) fprintf(table, "%-20s %s\n", "", r->note);
+    }
+    if (!results) {
+        printf("Unable to allocate the result table\n");
+        status = 1;
+    } else if (cfg.only && ran == 0) {
+        printSuiteUsage();
+        status = 1;
+    } else if (cfg.jsonPath && writeJsonReport(cfg.jsonPath, &cfg, results, ran, st.pool.threadCount) != 0) {
+        fprintf(table, "Unable to write %s\n", cfg.jsonPath);
+        status = 1;
+    } else if (cfg.jsonPath && table == stdout) {
+        printf("Wrote %d results to %s\n", ran, cfg.jsonPath);
+    }
+    benchSamplesFree(&samples);
+    free(results);
+    freeSuiteState(&st);
+    workPoolDestroy(&st.pool);
+    resetStores();
+    return status;
+}
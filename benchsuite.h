@@ -0,0 +1,22 @@
+#ifndef BENCHSUITE_H
+#define BENCHSUITE_H
+
+/*
+ * Benchmark suite over every core operation, on seeded synthetic data:
+ *
+ *   airline --bench-suite [--airports N] [--degree N] [--flights N]
+ *                         [--bookings N] [--burst N] [--queries N]
+ *                         [--reps N] [--warmup N] [--seed N]
+ *                         [--only PREFIX] [--label TEXT] [--json PATH|-]
+ *
+ * Each operation first runs --warmup untimed iterations, then collects
+ * one monotonic-clock sample per call: --flights, --bookings or --burst
+ * samples for the store operations, --queries for point queries and
+ * --reps for whole-network runs. Results are min/mean/stddev and
+ * p50/p90/p99/max, printed as a table and, with --json, written as one
+ * JSON document ("-" for stdout; the table then goes to stderr).
+ * The same seed and sizes always produce the same workload.
+ */
+int runBenchSuite(int argc, char* argv[]);
+
+#endif // BENCHSUITE_H
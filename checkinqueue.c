@@ -0,0 +1,91 @@
+#include "checkinqueue.h"
+#include <stdlib.h>
+#include <string.h>
+
+#define CHECKIN_HEAP_ARITY 4
+
+static int entryBefore(const CheckInHeapEntry* a, const CheckInHeapEntry* b) {
+    if (a->priority != b->priority) return a->priority < b->priority;
+    return a->sequence < b->sequence;
+}
+
+static void siftUp(CheckInHeapEntry* heap, size_t pos) {
+    CheckInHeapEntry moving = heap[pos];
+    while (pos > 0) {
+        size_t parent = (pos - 1) / CHECKIN_HEAP_ARITY;
+        if (!entryBefore(&moving, &heap[parent])) break;
+        heap[pos] = heap[parent];
+        pos = parent;
+    }
+    heap[pos] = moving;
+}
+
+static void siftDown(CheckInHeapEntry* heap, size_t count, size_t pos) {
+    CheckInHeapEntry moving = heap[pos];
+    for (;;) {
+        size_t first = pos * CHECKIN_HEAP_ARITY + 1;
+        if (first >= count) break;
+        size_t last = first + CHECKIN_HEAP_ARITY;
+        if (last > count) last = count;
+        size_t best = first;
+        for (size_t c = first + 1; c < last; ++c) {
+            if (entryBefore(&heap[c], &heap[best])) best = c;
+        }
+        if (!entryBefore(&heap[best], &moving)) break;
+        heap[pos] = heap[best];
+        pos = best;
+    }
+    heap[pos] = moving;
+}
+
+int checkInQueueReserve(CheckInQueue* queue, size_t entries) {
+    if (entries <= queue->capacity) return 0;
+    size_t capacity = queue->capacity ? queue->capacity : 64;
+    while (capacity < entries) capacity *= 2;
+    CheckInHeapEntry* grown = (CheckInHeapEntry*)realloc(queue->entries, sizeof(CheckInHeapEntry) * capacity);
+    if (!grown) return -1;
+    queue->entries = grown;
+    queue->capacity = capacity;
+    return 0;
+}
+
+int checkInQueuePush(CheckInQueue* queue, CheckInNode* node) {
+    if (checkInQueueReserve(queue, queue->count + 1) != 0) return -1;
+    CheckInHeapEntry* slot = &queue->entries[queue->count];
+    slot->priority = node->priority;
+    slot->sequence = node->sequence;
+    slot->node = node;
+    siftUp(queue->entries, queue->count++);
+    return 0;
+}
+
+CheckInNode* checkInQueuePop(CheckInQueue* queue) {
+    if (queue->count == 0) return NULL;
+    CheckInNode* top = queue->entries[0].node;
+    if (--queue->count > 0) {
+        queue->entries[0] = queue->entries[queue->count];
+        siftDown(queue->entries, queue->count, 0);
+    }
+    return top;
+}
+
+static int compareHeapEntries(const void* a, const void* b) {
+    const CheckInHeapEntry* ea = (const CheckInHeapEntry*)a;
+    const CheckInHeapEntry* eb = (const CheckInHeapEntry*)b;
+    if (entryBefore(ea, eb)) return -1;
+    if (entryBefore(eb, ea)) return 1;
+    return 0;
+}
+
+void checkInQueueSnapshot(const CheckInQueue* queue, CheckInHeapEntry* out) {
+    if (queue->count == 0) return;
+    memcpy(out, queue->entries, sizeof(CheckInHeapEntry) * queue->count);
+    qsort(out, queue->count, sizeof(CheckInHeapEntry), compareHeapEntries);
+}
+
+void checkInQueueFree(CheckInQueue* queue) {
+    free(queue->entries);
+    queue->entries = NULL;
+    queue->count = 0;
+    queue->capacity = 0;
+}
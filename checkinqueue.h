@@ -0,0 +1,43 @@
+#ifndef CHECKINQUEUE_H
+#define CHECKINQUEUE_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <time.h>
+
+// Check-in request; refers to the passenger store by index instead of copying the record
+typedef struct CheckInNode {
+    int passengerIndex;
+    int priority;       // 1 is served first; any positive tier is allowed
+    uint64_t sequence;  // enqueue order, FIFO tie-break inside a priority tier
+    time_t checkInTime;
+} CheckInNode;
+
+typedef struct {
+    int priority;
+    uint64_t sequence;
+    CheckInNode* node;
+} CheckInHeapEntry;
+
+/*
+ * Min-ordered d-ary heap on (priority, sequence) in one contiguous array.
+ * A 4-ary heap halves the tree depth of a binary heap and keeps all
+ * children of a node in the same cache line.
+ */
+typedef struct {
+    CheckInHeapEntry* entries;
+    size_t count;
+    size_t capacity;
+} CheckInQueue;
+
+#define CHECKIN_QUEUE_INIT { NULL, 0, 0 }
+
+// Makes room for entries in total; 0, or -1 on allocation failure. A push into reserved room cannot fail.
+int checkInQueueReserve(CheckInQueue* queue, size_t entries);
+int checkInQueuePush(CheckInQueue* queue, CheckInNode* node);
+CheckInNode* checkInQueuePop(CheckInQueue* queue);
+// Copies entries into out[] in service order; out must hold queue->count entries.
+void checkInQueueSnapshot(const CheckInQueue* queue, CheckInHeapEntry* out);
+void checkInQueueFree(CheckInQueue* queue);
+
+#endif // CHECKINQUEUE_H
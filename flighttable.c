@@ -0,0 +1,178 @@
+#include "flighttable.h"
+#include <stdlib.h>
+#include <string.h>
+#ifdef _WIN32
+#include <malloc.h>
+#endif
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define FLIGHT_X86_DISPATCH 1
+#include <immintrin.h>
+#endif
+
+static FlightColumnBlock* allocateBlock(void) {
+#ifdef _WIN32
+    FlightColumnBlock* block = (FlightColumnBlock*)_aligned_malloc(sizeof(FlightColumnBlock), 64);
+#else
+    FlightColumnBlock* block = (FlightColumnBlock*)aligned_alloc(64, sizeof(FlightColumnBlock));
+#endif
+    if (block) memset(block, 0, sizeof(*block));
+    return block;
+}
+
+static void freeBlock(FlightColumnBlock* block) {
+#ifdef _WIN32
+    _aligned_free(block);
+#else
+    free(block);
+#endif
+}
+
+int flightColumnsReserve(FlightColumns* cols, size_t rows) {
+    size_t needed = (rows + FLIGHT_BLOCK_ROWS - 1) >> FLIGHT_BLOCK_SHIFT;
+    if (needed > cols->directorySize) {
+        size_t size = cols->directorySize ? cols->directorySize : 16;
+        while (size < needed) size *= 2;
+        FlightColumnBlock** grown = (FlightColumnBlock**)realloc(cols->blocks, sizeof(FlightColumnBlock*) * size);
+        if (!grown) return -1;
+        cols->blocks = grown;
+        cols->directorySize = size;
+    }
+    while (cols->blockCount < needed) {
+        FlightColumnBlock* block = allocateBlock();
+        if (!block) return -1;
+        cols->blocks[cols->blockCount++] = block;
+    }
+    return 0;
+}
+
+void flightColumnsFree(FlightColumns* cols) {
+    for (size_t b = 0; b < cols->blockCount; ++b) freeBlock(cols->blocks[b]);
+    free(cols->blocks);
+    cols->blocks = NULL;
+    cols->blockCount = 0;
+    cols->directorySize = 0;
+}
+
+/*
+ * Kernels scan rows [0, n) of one block and append base + slot for each
+ * match. The scalar one adds the comparison result to the output cursor
+ * instead of branching, since matches are unpredictable; the vector
+ * ones hand it their leftover rows.
+ */
+typedef int (*FlightScanFn)(const FlightColumnBlock* block, int n, int base, float maxPrice, int minSeats, int* out);
+
+static int scanRowsScalar(const FlightColumnBlock* block, int from, int n, int base, float maxPrice, int minSeats,
+                          int* out) {
+    int found = 0;
+    for (int i = from; i < n; ++i) {
+        int left = block->capacity[i] + block->overbook[i] - atomic_load_explicit(&block->bookedSeats[i], memory_order_relaxed);
+        out[found] = base + i;
+        found += (block->price[i] <= maxPrice) & (left >= minSeats);
+    }
+    return found;
+}
+
+static int scanBlockScalar(const FlightColumnBlock* block, int n, int base, float maxPrice, int minSeats, int* out) {
+    return scanRowsScalar(block, 0, n, base, maxPrice, minSeats, out);
+}
+
+#ifdef FLIGHT_X86_DISPATCH
+// The vector kernels load bookedSeats as plain ints: aligned vector loads never tear a 4-byte lane
+__attribute__((target("avx2,bmi")))
+static int scanBlockAvx2(const FlightColumnBlock* block, int n, int base, float maxPrice, int minSeats, int* out) {
+    const int32_t* booked = (const int32_t*)(const void*)block->bookedSeats;
+    __m256 price = _mm256_set1_ps(maxPrice);
+    __m256i need = _mm256_set1_epi32(minSeats - 1);
+    int found = 0;
+    int i = 0;
+    for (; i + 8 <= n; i += 8) {
+        __m256 cheap = _mm256_cmp_ps(_mm256_load_ps(block->price + i), price, _CMP_LE_OQ);
+        __m256i sellable = _mm256_add_epi32(_mm256_load_si256((const __m256i*)(block->capacity + i)),
+                                            _mm256_load_si256((const __m256i*)(block->overbook + i)));
+        __m256i left = _mm256_sub_epi32(sellable, _mm256_load_si256((const __m256i*)(booked + i)));
+        __m256 roomy = _mm256_castsi256_ps(_mm256_cmpgt_epi32(left, need));
+        unsigned mask = (unsigned)_mm256_movemask_ps(_mm256_and_ps(cheap, roomy));
+        while (mask) {
+            out[found++] = base + i + (int)_tzcnt_u32(mask);
+            mask &= mask - 1;
+        }
+    }
+    return found + scanRowsScalar(block, i, n, base, maxPrice, minSeats, out + found);
+}
+
+// Compress-store writes the matching row numbers of 16 lanes in one instruction
+__attribute__((target("avx512f")))
+static int scanBlockAvx512(const FlightColumnBlock* block, int n, int base, float maxPrice, int minSeats, int* out) {
+    const int32_t* booked = (const int32_t*)(const void*)block->bookedSeats;
+    __m512 price = _mm512_set1_ps(maxPrice);
+    __m512i need = _mm512_set1_epi32(minSeats);
+    __m512i rows = _mm512_add_epi32(_mm512_set1_epi32(base),
+                                    _mm512_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15));
+    __m512i step = _mm512_set1_epi32(16);
+    int found = 0;
+    int i = 0;
+    for (; i + 16 <= n; i += 16) {
+        __mmask16 cheap = _mm512_cmp_ps_mask(_mm512_load_ps(block->price + i), price, _CMP_LE_OQ);
+        __m512i sellable = _mm512_add_epi32(_mm512_load_si512(block->capacity + i), _mm512_load_si512(block->overbook + i));
+        __m512i left = _mm512_sub_epi32(sellable, _mm512_load_si512(booked + i));
+        __mmask16 match = _mm512_mask_cmpge_epi32_mask(cheap, left, need);
+        _mm512_mask_compressstoreu_epi32(out + found, match, rows);
+        found += __builtin_popcount((unsigned)match);
+        rows = _mm512_add_epi32(rows, step);
+    }
+    return found + scanRowsScalar(block, i, n, base, maxPrice, minSeats, out + found);
+}
+#endif
+
+FlightScanKernel flightScanDetectKernel(void) {
+#ifdef FLIGHT_X86_DISPATCH
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx512f")) return FLIGHT_SCAN_AVX512;
+    if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("bmi")) return FLIGHT_SCAN_AVX2;
+#endif
+    return FLIGHT_SCAN_SCALAR;
+}
+
+int flightScanKernelSupported(FlightScanKernel kernel) {
+    switch (kernel) {
+        case FLIGHT_SCAN_AUTO:
+        case FLIGHT_SCAN_SCALAR:
+            return 1;
+        case FLIGHT_SCAN_AVX2:
+            return flightScanDetectKernel() >= FLIGHT_SCAN_AVX2;
+        case FLIGHT_SCAN_AVX512:
+            return flightScanDetectKernel() >= FLIGHT_SCAN_AVX512;
+    }
+    return 0;
+}
+
+const char* flightScanKernelName(FlightScanKernel kernel) {
+    switch (kernel) {
+        case FLIGHT_SCAN_AUTO: return "auto";
+        case FLIGHT_SCAN_SCALAR: return "scalar";
+        case FLIGHT_SCAN_AVX2: return "avx2";
+        case FLIGHT_SCAN_AVX512: return "avx512";
+    }
+    return "unknown";
+}
+
+int flightColumnsFindAvailable(const FlightColumns* cols, int rowCount, float maxPrice, int minSeats, int* out,
+                               FlightScanKernel kernel) {
+    if (kernel == FLIGHT_SCAN_AUTO) kernel = flightScanDetectKernel();
+    if (!flightScanKernelSupported(kernel)) return -1;
+    FlightScanFn scan = scanBlockScalar;
+#ifdef FLIGHT_X86_DISPATCH
+    if (kernel == FLIGHT_SCAN_AVX512) {
+        scan = scanBlockAvx512;
+    } else if (kernel == FLIGHT_SCAN_AVX2) {
+        scan = scanBlockAvx2;
+    }
+#endif
+    int found = 0;
+    for (int base = 0; base < rowCount; base += FLIGHT_BLOCK_ROWS) {
+        int n = rowCount - base < FLIGHT_BLOCK_ROWS ? rowCount - base : FLIGHT_BLOCK_ROWS;
+        found += scan(cols->blocks[base >> FLIGHT_BLOCK_SHIFT], n, base, maxPrice, minSeats, out + found);
+    }
+    return found;
+}
@@ -0,0 +1,67 @@
+#ifndef FLIGHTTABLE_H
+#define FLIGHTTABLE_H
+
+#include <stdatomic.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#define FLIGHT_BLOCK_SHIFT 10
+#define FLIGHT_BLOCK_ROWS (1 << FLIGHT_BLOCK_SHIFT)
+#define FLIGHT_ROW_SLOT(row) ((size_t)(row) & (FLIGHT_BLOCK_ROWS - 1))
+
+/*
+ * Hot numeric flight fields, stored column-wise. Rows are grouped in
+ * blocks of FLIGHT_BLOCK_ROWS; within a block each column is one
+ * contiguous, 64-byte aligned array. Availability and fare scans then
+ * stream 4 bytes per field per flight, never the strings. Like records
+ * in a RecordArena, blocks never move once allocated, so seat counters
+ * stay valid for concurrent bookers while the table grows. The strings
+ * live in the flight store (FlightInfo) under the same row index.
+ */
+typedef struct {
+    float price[FLIGHT_BLOCK_ROWS];
+    int32_t capacity[FLIGHT_BLOCK_ROWS];
+    atomic_int bookedSeats[FLIGHT_BLOCK_ROWS];
+    int32_t priority[FLIGHT_BLOCK_ROWS];
+    int32_t overbook[FLIGHT_BLOCK_ROWS]; // seats sold past capacity; sellable = capacity + overbook
+} FlightColumnBlock;
+
+typedef struct {
+    FlightColumnBlock** blocks;
+    size_t blockCount;
+    size_t directorySize; // allocated entries in blocks[]
+} FlightColumns;
+
+#define FLIGHT_COLUMNS_INIT { NULL, 0, 0 }
+
+// Makes rows [0, rows) addressable; new blocks are zeroed. Returns 0 or -1.
+int flightColumnsReserve(FlightColumns* cols, size_t rows);
+void flightColumnsFree(FlightColumns* cols);
+
+// Block holding a row below the reserved size; index it with FLIGHT_ROW_SLOT(row).
+static inline FlightColumnBlock* flightColumnsBlock(const FlightColumns* cols, size_t row) {
+    return cols->blocks[row >> FLIGHT_BLOCK_SHIFT];
+}
+
+typedef enum {
+    FLIGHT_SCAN_AUTO = 0,
+    FLIGHT_SCAN_SCALAR,
+    FLIGHT_SCAN_AVX2,
+    FLIGHT_SCAN_AVX512
+} FlightScanKernel;
+
+FlightScanKernel flightScanDetectKernel(void);
+int flightScanKernelSupported(FlightScanKernel kernel);
+const char* flightScanKernelName(FlightScanKernel kernel);
+
+/*
+ * Writes, in row order, the rows below rowCount priced at or under
+ * maxPrice with at least minSeats sellable seats left; out needs room for
+ * rowCount. Seat counts are read without synchronisation, so the result
+ * is a snapshot and booking still claims seats through reserveSeats().
+ * Returns the number of matches, or -1 if the kernel is not supported here.
+ */
+int flightColumnsFindAvailable(const FlightColumns* cols, int rowCount, float maxPrice, int minSeats, int* out,
+                               FlightScanKernel kernel);
+
+#endif // FLIGHTTABLE_H
@@ -0,0 +1,113 @@
+#include "hashindex.h"
+#include <stdlib.h>
+#include <string.h>
+
+#define HASH_INDEX_MIN_CAPACITY 16
+
+/* FNV-1a, followed by a murmur-style finalizer so short sequential IDs spread well. */
+uint32_t hashIndexHashString(const char* key) {
+    uint32_t h = 2166136261u;
+    while (*key) {
+        h ^= (unsigned char)*key++;
+        h *= 16777619u;
+    }
+    h ^= h >> 16;
+    h *= 0x85ebca6bu;
+    h ^= h >> 13;
+    return h;
+}
+
+void hashIndexInit(HashIndex* index, HashIndexKeyFn keyOf, void* ctx) {
+    index->slots = NULL;
+    index->capacity = 0;
+    index->count = 0;
+    index->keyOf = keyOf;
+    index->ctx = ctx;
+    index->borrowed = 0;
+}
+
+void hashIndexAdopt(HashIndex* index, HashIndexSlot* slots, size_t capacity, size_t count) {
+    hashIndexFree(index);
+    index->slots = slots;
+    index->capacity = capacity;
+    index->count = count;
+    index->borrowed = 1;
+}
+
+void hashIndexFree(HashIndex* index) {
+    if (!index->borrowed) free(index->slots);
+    index->borrowed = 0;
+    index->slots = NULL;
+    index->capacity = 0;
+    index->count = 0;
+}
+
+static void placeSlot(HashIndexSlot* slots, size_t mask, HashIndexSlot entry) {
+    size_t pos = entry.hash & mask;
+    while (slots[pos].recordIndex != -1) {
+        pos = (pos + 1) & mask;
+    }
+    slots[pos] = entry;
+}
+
+static int rehash(HashIndex* index, size_t newCapacity) {
+    HashIndexSlot* slots = (HashIndexSlot*)malloc(sizeof(HashIndexSlot) * newCapacity);
+    if (!slots) return -1;
+    for (size_t i = 0; i < newCapacity; ++i) {
+        slots[i].hash = 0;
+        slots[i].recordIndex = -1;
+    }
+    for (size_t i = 0; i < index->capacity; ++i) {
+        if (index->slots[i].recordIndex != -1) {
+            placeSlot(slots, newCapacity - 1, index->slots[i]);
+        }
+    }
+    if (!index->borrowed) free(index->slots);
+    index->borrowed = 0;
+    index->slots = slots;
+    index->capacity = newCapacity;
+    return 0;
+}
+
+/* Keep the load factor at or below 0.7 so probe sequences stay short. */
+int hashIndexReserve(HashIndex* index, size_t expected) {
+    size_t needed = index->capacity ? index->capacity : HASH_INDEX_MIN_CAPACITY;
+    while (expected * 10 > needed * 7) needed <<= 1;
+    if (needed == index->capacity) return 0;
+    return rehash(index, needed);
+}
+
+int hashIndexInsert(HashIndex* index, int recordIndex) {
+    if (hashIndexReserve(index, index->count + 1) != 0) return -1;
+    const char* key = index->keyOf(index->ctx, recordIndex);
+    HashIndexSlot entry;
+    entry.hash = hashIndexHashString(key);
+    entry.recordIndex = recordIndex;
+    size_t mask = index->capacity - 1;
+    size_t pos = entry.hash & mask;
+    while (index->slots[pos].recordIndex != -1) {
+        const HashIndexSlot* slot = &index->slots[pos];
+        if (slot->hash == entry.hash && strcmp(index->keyOf(index->ctx, slot->recordIndex), key) == 0) {
+            return 1;
+        }
+        pos = (pos + 1) & mask;
+    }
+    index->slots[pos] = entry;
+    index->count++;
+    return 0;
+}
+
+int hashIndexFind(const HashIndex* index, const char* key) {
+    if (index->capacity == 0) return -1;
+    uint32_t hash = hashIndexHashString(key);
+    size_t mask = index->capacity - 1;
+    size_t pos = hash & mask;
+    while (index->slots[pos].recordIndex != -1) {
+        const HashIndexSlot* slot = &index->slots[pos];
+        if (slot->hash == hash && strcmp(index->keyOf(index->ctx, slot->recordIndex), key) == 0) {
+            return slot->recordIndex;
+        }
+        pos = (pos + 1) & mask;
+    }
+    return -1;
+}
@@ -0,0 +1,42 @@
+#ifndef HASHINDEX_H
+#define HASHINDEX_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+/*
+ * Open-addressing (linear probing) hash index over records that live
+ * elsewhere. The index stores only record positions plus a cached hash;
+ * the key itself is read back from the record through keyOf(), so the
+ * index never duplicates key strings and stays in sync with the arrays.
+ */
+typedef const char* (*HashIndexKeyFn)(void* ctx, int recordIndex);
+
+typedef struct {
+    uint32_t hash;
+    int32_t recordIndex; // -1 = empty slot
+} HashIndexSlot;
+
+typedef struct {
+    HashIndexSlot* slots;
+    size_t capacity; // always a power of two (or 0 before first insert)
+    size_t count;
+    HashIndexKeyFn keyOf;
+    void* ctx;
+    int borrowed; // slots point into memory the index does not own (mapped snapshot)
+} HashIndex;
+
+#define HASH_INDEX_INIT(keyOf) { NULL, 0, 0, (keyOf), NULL, 0 }
+
+void hashIndexInit(HashIndex* index, HashIndexKeyFn keyOf, void* ctx);
+void hashIndexFree(HashIndex* index);
+int hashIndexReserve(HashIndex* index, size_t expected);
+// Returns 0 on success, 1 if the key is already present, -1 on allocation failure.
+int hashIndexInsert(HashIndex* index, int recordIndex);
+// Returns the record index for key, or -1 if absent.
+int hashIndexFind(const HashIndex* index, const char* key);
+uint32_t hashIndexHashString(const char* key);
+// Uses a previously saved slot table in place; it is copied on the first growth.
+void hashIndexAdopt(HashIndex* index, HashIndexSlot* slots, size_t capacity, size_t count);
+
+#endif // HASHINDEX_H
@@ -0,0 +1,101 @@
+#include "indexedheap.h"
+#include <stdlib.h>
+
+#define INDEXED_HEAP_ARITY 4
+
+int indexedHeapInit(IndexedHeap* h, int capacity) {
+    h->heap = (int*)malloc(sizeof(int) * (capacity > 0 ? capacity : 1));
+    h->pos = (int*)malloc(sizeof(int) * (capacity > 0 ? capacity : 1));
+    h->key = (double*)malloc(sizeof(double) * (capacity > 0 ? capacity : 1));
+    h->size = 0;
+    h->capacity = capacity;
+    if (!h->heap || !h->pos || !h->key) {
+        indexedHeapFree(h);
+        return -1;
+    }
+    for (int i = 0; i < capacity; ++i) h->pos[i] = -1;
+    return 0;
+}
+
+void indexedHeapFree(IndexedHeap* h) {
+    free(h->heap);
+    free(h->pos);
+    free(h->key);
+    h->heap = NULL;
+    h->pos = NULL;
+    h->key = NULL;
+    h->size = 0;
+    h->capacity = 0;
+}
+
+static void siftUp(IndexedHeap* h, int slot) {
+    int v = h->heap[slot];
+    double k = h->key[v];
+    while (slot > 0) {
+        int parent = (slot - 1) / INDEXED_HEAP_ARITY;
+        int pv = h->heap[parent];
+        if (h->key[pv] <= k) break;
+        h->heap[slot] = pv;
+        h->pos[pv] = slot;
+        slot = parent;
+    }
+    h->heap[slot] = v;
+    h->pos[v] = slot;
+}
+
+static void siftDown(IndexedHeap* h, int slot) {
+    int v = h->heap[slot];
+    double k = h->key[v];
+    for (;;) {
+        int first = slot * INDEXED_HEAP_ARITY + 1;
+        if (first >= h->size) break;
+        int last = first + INDEXED_HEAP_ARITY;
+        if (last > h->size) last = h->size;
+        int best = first;
+        double bestKey = h->key[h->heap[first]];
+        for (int c = first + 1; c < last; ++c) {
+            double ck = h->key[h->heap[c]];
+            if (ck < bestKey) {
+                best = c;
+                bestKey = ck;
+            }
+        }
+        if (bestKey >= k) break;
+        h->heap[slot] = h->heap[best];
+        h->pos[h->heap[slot]] = slot;
+        slot = best;
+    }
+    h->heap[slot] = v;
+    h->pos[v] = slot;
+}
+
+int indexedHeapPushOrDecrease(IndexedHeap* h, int v, double key) {
+    int slot = h->pos[v];
+    if (slot == -1) {
+        h->key[v] = key;
+        h->heap[h->size] = v;
+        siftUp(h, h->size++);
+        return 1;
+    }
+    if (key >= h->key[v]) return 0;
+    h->key[v] = key;
+    siftUp(h, slot);
+    return 1;
+}
+
+int indexedHeapPop(IndexedHeap* h, double* keyOut) {
+    if (h->size == 0) return -1;
+    int top = h->heap[0];
+    if (keyOut) *keyOut = h->key[top];
+    h->pos[top] = -1;
+    if (--h->size > 0) {
+        h->heap[0] = h->heap[h->size];
+        siftDown(h, 0);
+    }
+    return top;
+}
+
+void indexedHeapClear(IndexedHeap* h) {
+    for (int i = 0; i < h->size; ++i) h->pos[h->heap[i]] = -1;
+    h->size = 0;
+}
@@ -0,0 +1,35 @@
+#ifndef INDEXEDHEAP_H
+#define INDEXEDHEAP_H
+
+/*
+ * Indexed 4-ary min-heap over vertex ids 0..capacity-1 with decrease-key.
+ * pos[] maps a vertex to its heap slot (-1 when absent), so a vertex is
+ * in the heap at most once and relaxations update it in place.
+ */
+typedef struct {
+    int* heap;
+    int* pos;
+    double* key;
+    int size;
+    int capacity;
+} IndexedHeap;
+
+int indexedHeapInit(IndexedHeap* h, int capacity);
+void indexedHeapFree(IndexedHeap* h);
+// Inserts v, or lowers its key if already present. Returns 1 if the heap changed.
+int indexedHeapPushOrDecrease(IndexedHeap* h, int v, double key);
+// Removes and returns the minimum vertex (its key in *keyOut), or -1 if empty.
+int indexedHeapPop(IndexedHeap* h, double* keyOut);
+// Empties the heap, leaving it ready for the next search.
+void indexedHeapClear(IndexedHeap* h);
+
+static inline int indexedHeapEmpty(const IndexedHeap* h) {
+    return h->size == 0;
+}
+
+// Smallest key; the heap must not be empty.
+static inline double indexedHeapMinKey(const IndexedHeap* h) {
+    return h->key[h->heap[0]];
+}
+
+#endif // INDEXEDHEAP_H
@@ -0,0 +1,172 @@
+#include "journey.h"
+#include "airline.h"
+#include "stores.h"
+#include <stdlib.h>
+#include <string.h>
+
+// memset() byte pattern, so clearing the labels for a query is one call
+#define NO_ARRIVAL_BYTE 0x7f
+#define NO_ARRIVAL 0x7f7f7f7f
+
+void journeyInit(Journey* j) {
+    j->legs = NULL;
+    j->legCount = 0;
+    j->legCapacity = 0;
+    j->scanned = 0;
+}
+
+void journeyFree(Journey* j) {
+    free(j->legs);
+    journeyInit(j);
+}
+
+static int journeyPush(Journey* j, JourneyLeg leg) {
+    if (j->legCount == j->legCapacity) {
+        int capacity = j->legCapacity ? j->legCapacity * 2 : 8;
+        JourneyLeg* grown = (JourneyLeg*)realloc(j->legs, sizeof(JourneyLeg) * (size_t)capacity);
+        if (!grown) return -1;
+        j->legs = grown;
+        j->legCapacity = capacity;
+    }
+    j->legs[j->legCount++] = leg;
+    return 0;
+}
+
+void timetableInit(Timetable* tt, int minConnectionMinutes) {
+    routeNetworkInit(&tt->airports, 1);
+    tt->connections = NULL;
+    tt->flightOf = NULL;
+    tt->connectionCount = 0;
+    memset(tt->firstAtMinute, 0, sizeof(tt->firstAtMinute));
+    tt->minConnectionMinutes = minConnectionMinutes;
+    tt->ready = NULL;
+    tt->arrivedBy = NULL;
+    tt->arrivedDay = NULL;
+}
+
+void timetableFree(Timetable* tt) {
+    routeNetworkFree(&tt->airports);
+    free(tt->connections);
+    free(tt->flightOf);
+    free(tt->ready);
+    free(tt->arrivedBy);
+    free(tt->arrivedDay);
+    timetableInit(tt, tt->minConnectionMinutes);
+}
+
+int timetableBuildFromFlights(Timetable* tt) {
+    size_t capacity = (size_t)(flightCount > 0 ? flightCount : 1);
+    Connection* unsorted = (Connection*)malloc(sizeof(Connection) * capacity);
+    int* unsortedFlight = (int*)malloc(sizeof(int) * capacity);
+    tt->connections = (Connection*)malloc(sizeof(Connection) * capacity);
+    tt->flightOf = (int*)malloc(sizeof(int) * capacity);
+    if (!unsorted || !unsortedFlight || !tt->connections || !tt->flightOf) {
+        free(unsorted);
+        free(unsortedFlight);
+        return -1;
+    }
+
+    // Stored flights already carry dense airport ids; copying the codes in id order keeps them
+    for (int a = 0; a < airportCount; ++a) {
+        if (routeNetworkIntern(&tt->airports, airportCode(a)) != a) {
+            free(unsorted);
+            free(unsortedFlight);
+            return -1;
+        }
+    }
+
+    // Parse every schedule string exactly once; flights with unreadable times are left out
+    int count = 0;
+    int perMinute[MINUTES_PER_DAY + 1] = { 0 };
+    for (int i = 0; i < flightCount; ++i) {
+        const FlightInfo* f = flightAt(i);
+        int dep = flightClockMinutes(f->departureTime);
+        int arr = flightClockMinutes(f->arrivalTime);
+        if (dep < 0 || arr < 0) continue;
+        if (arr <= dep) arr += MINUTES_PER_DAY;
+        int from = f->origin;
+        int to = f->destination;
+        if (from == to) continue;
+        unsorted[count].departure = dep;
+        unsorted[count].arrival = arr;
+        unsorted[count].from = from;
+        unsorted[count].to = to;
+        unsortedFlight[count] = i;
+        perMinute[dep + 1]++;
+        count++;
+    }
+
+    // Counting sort on the departure minute; stable, so equal departures keep flight order
+    for (int m = 0; m < MINUTES_PER_DAY; ++m) perMinute[m + 1] += perMinute[m];
+    memcpy(tt->firstAtMinute, perMinute, sizeof(tt->firstAtMinute));
+    for (int i = 0; i < count; ++i) {
+        int slot = perMinute[unsorted[i].departure]++;
+        tt->connections[slot] = unsorted[i];
+        tt->flightOf[slot] = unsortedFlight[i];
+    }
+    tt->connectionCount = count;
+    free(unsorted);
+    free(unsortedFlight);
+
+    size_t airports = (size_t)(tt->airports.airportCount > 0 ? tt->airports.airportCount : 1);
+    tt->ready = (int*)malloc(sizeof(int) * airports);
+    tt->arrivedBy = (int*)malloc(sizeof(int) * airports);
+    tt->arrivedDay = (int*)malloc(sizeof(int) * airports);
+    if (!tt->ready || !tt->arrivedBy || !tt->arrivedDay) return -1;
+    return 0;
+}
+
+int timetableEarliestArrival(Timetable* tt, int from, int to, int departAfter, Journey* out) {
+    out->legCount = 0;
+    out->scanned = 0;
+    if (from == to) return 0;
+    if (departAfter < 0) departAfter = 0;
+    if (departAfter >= MINUTES_PER_DAY) departAfter = MINUTES_PER_DAY - 1;
+    // Labels hold the time a passenger is ready to board at each airport: arrival
+    // plus the minimum connection time, or the requested start at the origin
+    memset(tt->ready, NO_ARRIVAL_BYTE, sizeof(int) * (size_t)tt->airports.airportCount);
+    tt->ready[from] = departAfter;
+    tt->arrivedBy[from] = -1;
+    const int mct = tt->minConnectionMinutes;
+
+    int best = NO_ARRIVAL;
+    int scanned = 0;
+    for (int day = 0; day < JOURNEY_HORIZON_DAYS; ++day) {
+        int offset = day * MINUTES_PER_DAY;
+        int first = day == 0 ? tt->firstAtMinute[departAfter] : 0;
+        int i = first;
+        for (; i < tt->connectionCount; ++i) {
+            const Connection* c = &tt->connections[i];
+            int dep = c->departure + offset;
+            if (dep >= best) break;
+            if (tt->ready[c->from] > dep) continue;
+            int arr = c->arrival + offset;
+            if (arr + mct < tt->ready[c->to] && c->to != from) {
+                tt->ready[c->to] = arr + mct;
+                tt->arrivedBy[c->to] = i;
+                tt->arrivedDay[c->to] = day;
+                if (c->to == to && arr < best) best = arr;
+            }
+        }
+        scanned += i - first;
+        if (i < tt->connectionCount) break;
+    }
+    out->scanned = scanned;
+    if (best == NO_ARRIVAL) return 1;
+
+    // Walk back from the destination, then put the legs in travel order
+    for (int airport = to; tt->arrivedBy[airport] != -1;) {
+        int i = tt->arrivedBy[airport];
+        int offset = tt->arrivedDay[airport] * MINUTES_PER_DAY;
+        const Connection* c = &tt->connections[i];
+        JourneyLeg leg = { tt->flightOf[i], c->from, c->to, c->departure + offset, c->arrival + offset };
+        if (journeyPush(out, leg) != 0) return -1;
+        airport = c->from;
+    }
+    for (int a = 0, b = out->legCount - 1; a < b; ++a, --b) {
+        JourneyLeg t = out->legs[a];
+        out->legs[a] = out->legs[b];
+        out->legs[b] = t;
+    }
+    return 0;
+}
@@ -0,0 +1,70 @@
+#ifndef JOURNEY_H
+#define JOURNEY_H
+
+#include "routenetwork.h"
+
+#define MINUTES_PER_DAY (24 * 60)
+#define JOURNEY_MIN_CONNECTION_MINUTES 45
+// Journeys may run into the following day, never beyond it
+#define JOURNEY_HORIZON_DAYS 2
+
+// One scheduled departure; times are minutes after midnight of the service day.
+typedef struct {
+    int departure;
+    int arrival; // may exceed MINUTES_PER_DAY for overnight flights
+    int from;
+    int to;
+} Connection;
+
+typedef struct {
+    int flightIndex;
+    int from;
+    int to;
+    int departure; // minutes from midnight of the query day
+    int arrival;
+} JourneyLeg;
+
+typedef struct {
+    JourneyLeg* legs;
+    int legCount;
+    int legCapacity;
+    int scanned; // connections looked at by the query
+} Journey;
+
+/*
+ * Daily timetable for the Connection Scan Algorithm. Times are parsed
+ * from the flight strings once, here, and connections are kept sorted
+ * by departure, so a query is a single forward scan that stops as soon
+ * as nothing departing later can beat the best arrival found.
+ * The airport table must not be moved after timetableInit().
+ */
+typedef struct {
+    RouteNetwork airports;   // code interning only
+    Connection* connections; // sorted by departure
+    int* flightOf;           // flight index for each connection
+    int connectionCount;
+    int firstAtMinute[MINUTES_PER_DAY + 1]; // first connection departing at or after each minute
+    int minConnectionMinutes;
+    // per-query state
+    int* ready;     // earliest time a passenger can board at each airport
+    int* arrivedBy; // connection used to reach each airport, or -1 at the origin
+    int* arrivedDay;
+} Timetable;
+
+void timetableInit(Timetable* tt, int minConnectionMinutes);
+void timetableFree(Timetable* tt);
+// Every stored flight becomes one daily connection. Returns 0 or -1 on allocation failure.
+int timetableBuildFromFlights(Timetable* tt);
+
+/*
+ * Earliest arrival at `to` leaving `from` no earlier than departAfter
+ * (minutes after midnight). Connections need minConnectionMinutes on the
+ * ground between flights. Returns 0 with the journey filled in, 1 if
+ * `to` cannot be reached within JOURNEY_HORIZON_DAYS, -1 on allocation failure.
+ */
+int timetableEarliestArrival(Timetable* tt, int from, int to, int departAfter, Journey* out);
+
+void journeyInit(Journey* j);
+void journeyFree(Journey* j);
+
+#endif // JOURNEY_H
@@ -0,0 +1,45 @@
+#include "linereader.h"
+#include <stdlib.h>
+#include <string.h>
+
+int lineReaderRun(FILE* in, LineReaderFn fn, void* ctx) {
+    char* buffer = (char*)malloc(LINE_READER_BUFFER_SIZE + 1);
+    if (!buffer) return -1;
+    size_t filled = 0;
+    int skipping = 0; // discarding the rest of an over-long line
+    for (;;) {
+        size_t got = fread(buffer + filled, 1, LINE_READER_BUFFER_SIZE - filled, in);
+        filled += got;
+        int eof = got == 0;
+        char* cursor = buffer;
+        char* limit = buffer + filled;
+        for (;;) {
+            char* nl = (char*)memchr(cursor, '\n', (size_t)(limit - cursor));
+            if (!nl) break;
+            *nl = '\0';
+            if (skipping) {
+                skipping = 0;
+            } else {
+                fn(ctx, cursor, (size_t)(nl - cursor));
+            }
+            cursor = nl + 1;
+        }
+        size_t rest = (size_t)(limit - cursor);
+        if (eof) {
+            if (rest > 0 && !skipping) {
+                cursor[rest] = '\0';
+                fn(ctx, cursor, rest);
+            }
+            break;
+        }
+        if (rest == LINE_READER_BUFFER_SIZE) {
+            if (!skipping) fn(ctx, NULL, 0);
+            skipping = 1;
+            rest = 0;
+        }
+        memmove(buffer, cursor, rest);
+        filled = rest;
+    }
+    free(buffer);
+    return ferror(in) ? -1 : 0;
+}
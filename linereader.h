@@ -0,0 +1,23 @@
+#ifndef LINEREADER_H
+#define LINEREADER_H
+
+#include <stdio.h>
+#include <stddef.h>
+
+#define LINE_READER_BUFFER_SIZE (1 << 20)
+
+/*
+ * Called once per line with the '\n' replaced by '\0' (a trailing '\r'
+ * is left for the caller). A line longer than the buffer is reported
+ * once as line == NULL, len == 0, and the rest of it is skipped.
+ */
+typedef void (*LineReaderFn)(void* ctx, char* line, size_t len);
+
+/*
+ * Reads the stream in large blocks and cuts lines out of the buffer with
+ * memchr; only a trailing partial line is moved to the front between
+ * reads. Returns 0, or -1 on allocation or read error.
+ */
+int lineReaderRun(FILE* in, LineReaderFn fn, void* ctx);
+
+#endif // LINEREADER_H
@@ -1,6 +1,42 @@
 #include "airline.h"
+#include "bench.h"
+#include "benchsuite.h"
+#include "batch.h"
+#include "persist.h"
 
-int main() {
+int main(int argc, char* argv[]) {
+    if (argc > 1 && strcmp(argv[1], "--bench") == 0) {
+        return runBenchmarks(argc - 2, argv + 2);
+    }
+    if (argc > 1 && strcmp(argv[1], "--bench-suite") == 0) {
+        return runBenchSuite(argc - 2, argv + 2);
+    }
+    const char* dataPath = "airline";
+    const char* batchPath = NULL;
+    PersistDurability durability = PERSIST_DURABILITY_DEFAULT;
+    for (int i = 1; i + 1 < argc; i += 2) {
+        if (strcmp(argv[i], "--data") == 0) {
+            dataPath = argv[i + 1];
+        } else if (strcmp(argv[i], "--batch") == 0) {
+            batchPath = argv[i + 1];
+        } else if (strcmp(argv[i], "--sync") == 0) {
+            if (persistParseSyncMode(argv[i + 1], &durability.mode) != 0) {
+                printf("Unknown sync mode %s (use group, interval or buffered)\n", argv[i + 1]);
+                return 1;
+            }
+        } else if (strcmp(argv[i], "--commit-delay-us") == 0) {
+            durability.groupDelayUs = atoi(argv[i + 1]);
+        } else if (strcmp(argv[i], "--sync-interval-ms") == 0) {
+            durability.intervalMs = atoi(argv[i + 1]);
+        }
+    }
+    persistSetDurability(&durability);
+    if (persistOpen(dataPath) == PERSIST_OPEN_REFUSED) return 1;
+    if (batchPath) {
+        int status = runBatchFile(batchPath);
+        persistClose();
+        return status;
+    }
     printf("Welcome to Airline Management System!\n");
     // printf("=====================================\n\n");
     // printf("Data Structures Implemented:\n");
@@ -0,0 +1,70 @@
+#include "mpmcring.h"
+#include <stdint.h>
+#include <stdlib.h>
+
+int mpmcRingInit(MpmcRing* ring, size_t capacity) {
+    size_t size = 2;
+    while (size < capacity) size <<= 1;
+    ring->cells = (MpmcCell*)malloc(sizeof(MpmcCell) * size);
+    if (!ring->cells) return -1;
+    for (size_t i = 0; i < size; ++i) {
+        atomic_init(&ring->cells[i].sequence, i);
+        ring->cells[i].data = NULL;
+    }
+    ring->mask = size - 1;
+    atomic_init(&ring->enqueuePos, 0);
+    atomic_init(&ring->dequeuePos, 0);
+    return 0;
+}
+
+void mpmcRingFree(MpmcRing* ring) {
+    free(ring->cells);
+    ring->cells = NULL;
+    ring->mask = 0;
+}
+
+int mpmcRingPush(MpmcRing* ring, void* data) {
+    MpmcCell* cell;
+    size_t pos = atomic_load_explicit(&ring->enqueuePos, memory_order_relaxed);
+    for (;;) {
+        cell = &ring->cells[pos & ring->mask];
+        size_t seq = atomic_load_explicit(&cell->sequence, memory_order_acquire);
+        intptr_t diff = (intptr_t)seq - (intptr_t)pos;
+        if (diff == 0) {
+            if (atomic_compare_exchange_weak_explicit(&ring->enqueuePos, &pos, pos + 1,
+                                                      memory_order_relaxed, memory_order_relaxed)) {
+                break;
+            }
+        } else if (diff < 0) {
+            return -1; // consumers have not freed this cell yet: full
+        } else {
+            pos = atomic_load_explicit(&ring->enqueuePos, memory_order_relaxed);
+        }
+    }
+    cell->data = data;
+    atomic_store_explicit(&cell->sequence, pos + 1, memory_order_release);
+    return 0;
+}
+
+void* mpmcRingPop(MpmcRing* ring) {
+    MpmcCell* cell;
+    size_t pos = atomic_load_explicit(&ring->dequeuePos, memory_order_relaxed);
+    for (;;) {
+        cell = &ring->cells[pos & ring->mask];
+        size_t seq = atomic_load_explicit(&cell->sequence, memory_order_acquire);
+        intptr_t diff = (intptr_t)seq - (intptr_t)(pos + 1);
+        if (diff == 0) {
+            if (atomic_compare_exchange_weak_explicit(&ring->dequeuePos, &pos, pos + 1,
+                                                      memory_order_relaxed, memory_order_relaxed)) {
+                break;
+            }
+        } else if (diff < 0) {
+            return NULL; // producer has not filled this cell yet: empty
+        } else {
+            pos = atomic_load_explicit(&ring->dequeuePos, memory_order_relaxed);
+        }
+    }
+    void* data = cell->data;
+    atomic_store_explicit(&cell->sequence, pos + ring->mask + 1, memory_order_release);
+    return data;
+}
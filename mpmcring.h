@@ -0,0 +1,36 @@
+#ifndef MPMCRING_H
+#define MPMCRING_H
+
+#include <stdatomic.h>
+#include <stddef.h>
+
+#define MPMC_CACHE_LINE 64
+
+typedef struct {
+    atomic_size_t sequence;
+    void* data;
+} MpmcCell;
+
+/*
+ * Bounded multi-producer/multi-consumer ring (Vyukov's algorithm).
+ * Each cell carries a sequence number that tells producers and consumers
+ * whose turn it is, so push/pop need one CAS on a shared cursor and no
+ * locks. Cells are reused in place and never freed while the ring is
+ * live, which sidesteps the reclamation problem of linked lock-free queues.
+ */
+typedef struct {
+    MpmcCell* cells;
+    size_t mask;
+    _Alignas(MPMC_CACHE_LINE) atomic_size_t enqueuePos;
+    _Alignas(MPMC_CACHE_LINE) atomic_size_t dequeuePos;
+} MpmcRing;
+
+// capacity is rounded up to a power of two
+int mpmcRingInit(MpmcRing* ring, size_t capacity);
+void mpmcRingFree(MpmcRing* ring);
+// Returns 0 on success, -1 if the ring is full.
+int mpmcRingPush(MpmcRing* ring, void* data);
+// Returns NULL if the ring is empty.
+void* mpmcRingPop(MpmcRing* ring);
+
+#endif // MPMCRING_H
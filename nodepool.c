@@ -0,0 +1,38 @@
+#include "nodepool.h"
+
+int nodePoolReserve(NodePool* pool, size_t nodes) {
+    return recordArenaReserve(&pool->slabs, pool->carved + nodes);
+}
+
+void* nodePoolAlloc(NodePool* pool) {
+    void* node = pool->freeList;
+    if (node) {
+        pool->freeList = *(void**)node;
+        pool->hits++;
+    } else {
+        if (pool->carved < recordArenaCapacity(&pool->slabs)) {
+            pool->hits++;
+        } else {
+            pool->misses++;
+        }
+        node = recordArenaSlot(&pool->slabs, pool->carved);
+        if (!node) return NULL;
+        pool->carved++;
+    }
+    if (++pool->inUse > pool->peakInUse) pool->peakInUse = pool->inUse;
+    return node;
+}
+
+void nodePoolRelease(NodePool* pool, void* node) {
+    if (!node) return;
+    *(void**)node = pool->freeList;
+    pool->freeList = node;
+    pool->inUse--;
+}
+
+void nodePoolFree(NodePool* pool) {
+    recordArenaFree(&pool->slabs);
+    pool->freeList = NULL;
+    pool->carved = 0;
+    pool->inUse = 0;
+}
@@ -0,0 +1,32 @@
+#ifndef NODEPOOL_H
+#define NODEPOOL_H
+
+#include <stddef.h>
+#include "arena.h"
+
+/*
+ * Fixed-size node pool. Nodes are carved from RecordArena slabs and
+ * recycled through an intrusive free list, so steady-state alloc/free
+ * never touches malloc. A "hit" is a request served from the free list
+ * or from already-reserved slab space; a "miss" had to grow a new slab.
+ */
+typedef struct {
+    RecordArena slabs;
+    void* freeList;
+    size_t carved;  // nodes handed out from slab space so far
+    size_t inUse;
+    size_t peakInUse;
+    size_t hits;
+    size_t misses;
+} NodePool;
+
+// Node size is padded so a free node can hold the free-list link.
+#define NODE_POOL_INIT(type, slabShift) \
+    { { sizeof(type) < sizeof(void*) ? sizeof(void*) : sizeof(type), (slabShift), NULL, 0, 0, 0 }, NULL, 0, 0, 0, 0, 0 }
+
+int nodePoolReserve(NodePool* pool, size_t nodes);
+void* nodePoolAlloc(NodePool* pool);
+void nodePoolRelease(NodePool* pool, void* node);
+void nodePoolFree(NodePool* pool);
+
+#endif // NODEPOOL_H
@@ -0,0 +1,927 @@
+#include "persist.h"
+#include "stores.h"
+#include <errno.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <pthread.h>
+#ifdef _WIN32
+#include <fcntl.h>
+#include <io.h>
+#include <sys/stat.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#define PERSIST_PATH_LEN 512
+#define PERSIST_ALIGN 64
+
+static int persistEnabled = 0;
+static char snapshotPath[PERSIST_PATH_LEN];
+static char logPath[PERSIST_PATH_LEN];
+static long logEntries = 0; // since the last compaction
+static pthread_mutex_t logLock = PTHREAD_MUTEX_INITIALIZER;
+static PersistDurability durability = PERSIST_DURABILITY_DEFAULT;
+
+// Current snapshot mapping; the stores may point into it
+static char* mappedBase = NULL;
+static size_t mappedSize = 0;
+static uint32_t loadedVersion = 0; // of the snapshot last loaded, 0 if none
+
+static uint32_t checksumBytes(uint32_t h, const void* data, size_t len) {
+    const unsigned char* p = (const unsigned char*)data;
+    for (size_t i = 0; i < len; ++i) {
+        h ^= p[i];
+        h *= 16777619u;
+    }
+    return h;
+}
+
+static uint64_t alignUp(uint64_t value) {
+    return (value + PERSIST_ALIGN - 1) & ~(uint64_t)(PERSIST_ALIGN - 1);
+}
+
+static int syncFile(FILE* f) {
+    if (fflush(f) != 0) return -1;
+#ifdef _WIN32
+    return _commit(_fileno(f));
+#else
+    return fsync(fileno(f));
+#endif
+}
+
+/* ---------- Snapshot ---------- */
+
+static int writePadding(FILE* out, uint64_t from, uint64_t to) {
+    static const char zeros[PERSIST_ALIGN];
+    return to > from ? (fwrite(zeros, 1, (size_t)(to - from), out) == to - from ? 0 : -1) : 0;
+}
+
+// Writes records chunk by chunk so each chunk is a single fwrite.
+static int writeArena(FILE* out, const RecordArena* arena, size_t count) {
+    size_t chunkRecords = (size_t)1 << arena->chunkShift;
+    for (size_t c = 0; c * chunkRecords < count; ++c) {
+        size_t n = count - c * chunkRecords;
+        if (n > chunkRecords) n = chunkRecords;
+        if (fwrite(arena->chunks[c], arena->recordSize, n, out) != n) return -1;
+    }
+    return 0;
+}
+
+// The flight columns are written as whole arrays, one column after another.
+enum {
+    FLIGHT_COLUMN_PRICE,
+    FLIGHT_COLUMN_CAPACITY,
+    FLIGHT_COLUMN_BOOKED,
+    FLIGHT_COLUMN_PRIORITY,
+    FLIGHT_COLUMN_OVERBOOK,
+    FLIGHT_COLUMN_COUNT
+};
+
+static uint64_t columnBytes(uint64_t flights) {
+    return alignUp(flights * sizeof(int32_t));
+}
+
+static void* columnSlice(FlightColumnBlock* block, int column) {
+    switch (column) {
+        case FLIGHT_COLUMN_PRICE: return block->price;
+        case FLIGHT_COLUMN_CAPACITY: return block->capacity;
+        case FLIGHT_COLUMN_BOOKED: return block->bookedSeats;
+        case FLIGHT_COLUMN_PRIORITY: return block->priority;
+        default: return block->overbook;
+    }
+}
+
+/*
+ * Passengers are written through a copy of each chunk, and the seats their
+ * confirmed tickets hold are tallied from that copy, so the snapshot's
+ * booked-seat column matches the records it holds. The live counters can
+ * run ahead (a seat is reserved before its passenger is appended, and the
+ * passenger's log entry credits it on replay) and ticket status changes
+ * under the ticket locks rather than the registry lock.
+ */
+static int writePassengers(FILE* out, size_t count, int32_t* booked, size_t flights) {
+    size_t chunkRecords = (size_t)1 << passengerStore.chunkShift;
+    Passenger* copy = (Passenger*)malloc(chunkRecords * sizeof(Passenger));
+    if (!copy) return -1;
+    int status = 0;
+    for (size_t c = 0; !status && c * chunkRecords < count; ++c) {
+        size_t n = count - c * chunkRecords;
+        if (n > chunkRecords) n = chunkRecords;
+        memcpy(copy, passengerStore.chunks[c], n * sizeof(Passenger));
+        for (size_t i = 0; i < n; ++i) {
+            if (copy[i].ticketStatus == TICKET_CONFIRMED && copy[i].flightIndex >= 0 && (size_t)copy[i].flightIndex < flights) {
+                booked[copy[i].flightIndex]++;
+            }
+        }
+        if (fwrite(copy, sizeof(Passenger), n, out) != n) status = -1;
+    }
+    free(copy);
+    return status;
+}
+
+static int writeFlightColumns(FILE* out, size_t count, const int32_t* booked) {
+    for (int column = 0; column < FLIGHT_COLUMN_COUNT; ++column) {
+        if (column == FLIGHT_COLUMN_BOOKED) {
+            if (fwrite(booked, sizeof(int32_t), count, out) != count) return -1;
+            if (writePadding(out, count * sizeof(int32_t), columnBytes(count)) != 0) return -1;
+            continue;
+        }
+        for (size_t base = 0; base < count; base += FLIGHT_BLOCK_ROWS) {
+            size_t n = count - base < FLIGHT_BLOCK_ROWS ? count - base : FLIGHT_BLOCK_ROWS;
+            if (fwrite(columnSlice(flightColumnsBlock(&flightColumns, base), column), sizeof(int32_t), n, out) != n) return -1;
+        }
+        if (writePadding(out, count * sizeof(int32_t), columnBytes(count)) != 0) return -1;
+    }
+    return 0;
+}
+
+// Columns a snapshot of that version has; version 3 predates overbooking
+static int flightColumnCount(uint32_t version) {
+    return version == 3 ? FLIGHT_COLUMN_OVERBOOK : FLIGHT_COLUMN_COUNT;
+}
+
+// Columns missing from an older snapshot stay zero
+static int loadFlightColumns(const char* columns, size_t count, int columnCount) {
+    if (flightColumnsReserve(&flightColumns, count) != 0) return -1;
+    for (int column = 0; column < columnCount; ++column) {
+        const char* src = columns + column * columnBytes(count);
+        for (size_t base = 0; base < count; base += FLIGHT_BLOCK_ROWS) {
+            size_t n = count - base < FLIGHT_BLOCK_ROWS ? count - base : FLIGHT_BLOCK_ROWS;
+            memcpy(columnSlice(flightColumnsBlock(&flightColumns, base), column), src + base * sizeof(int32_t),
+                   n * sizeof(int32_t));
+        }
+    }
+    return 0;
+}
+
+int persistWriteSnapshot(const char* path) {
+    char tmpPath[PERSIST_PATH_LEN + 8];
+    snprintf(tmpPath, sizeof(tmpPath), "%s.tmp", path);
+    FILE* out = fopen(tmpPath, "wb");
+    if (!out) return -1;
+
+    SnapshotHeader h;
+    memset(&h, 0, sizeof(h));
+    memcpy(h.magic, PERSIST_MAGIC, sizeof(PERSIST_MAGIC));
+    h.version = PERSIST_VERSION;
+    h.headerSize = sizeof(SnapshotHeader);
+    h.flightRecordSize = sizeof(FlightInfo);
+    h.passengerRecordSize = sizeof(Passenger);
+    h.airportRecordSize = sizeof(AirportCode);
+    h.flightCount = (uint64_t)flightCount;
+    h.passengerCount = (uint64_t)passengerCount;
+    h.flightOffset = alignUp(sizeof(SnapshotHeader));
+    h.passengerOffset = alignUp(h.flightOffset + h.flightCount * sizeof(FlightInfo));
+    h.flightIndexOffset = alignUp(h.passengerOffset + h.passengerCount * sizeof(Passenger));
+    h.flightIndexCapacity = flightIndex.capacity;
+    h.passengerIndexOffset = alignUp(h.flightIndexOffset + h.flightIndexCapacity * sizeof(HashIndexSlot));
+    h.passengerIndexCapacity = passengerIndex.capacity;
+    h.airportCount = (uint64_t)airportCount;
+    h.airportOffset = alignUp(h.passengerIndexOffset + h.passengerIndexCapacity * sizeof(HashIndexSlot));
+    h.airportIndexOffset = alignUp(h.airportOffset + h.airportCount * sizeof(AirportCode));
+    h.airportIndexCapacity = airportIndex.capacity;
+    h.flightColumnsOffset = alignUp(h.airportIndexOffset + h.airportIndexCapacity * sizeof(HashIndexSlot));
+    h.fileSize = h.flightColumnsOffset + FLIGHT_COLUMN_COUNT * columnBytes(h.flightCount);
+
+    int32_t* booked = (int32_t*)calloc(flightCount ? (size_t)flightCount : 1, sizeof(int32_t));
+    int status = booked ? 0 : -1;
+    if (!status && fwrite(&h, sizeof(h), 1, out) != 1) status = -1;
+    if (!status) status = writePadding(out, sizeof(h), h.flightOffset);
+    if (!status) status = writeArena(out, &flightStore, (size_t)flightCount);
+    if (!status) status = writePadding(out, h.flightOffset + h.flightCount * sizeof(FlightInfo), h.passengerOffset);
+    if (!status) status = writePassengers(out, (size_t)passengerCount, booked, (size_t)flightCount);
+    if (!status) status = writePadding(out, h.passengerOffset + h.passengerCount * sizeof(Passenger), h.flightIndexOffset);
+    if (!status && h.flightIndexCapacity &&
+        fwrite(flightIndex.slots, sizeof(HashIndexSlot), flightIndex.capacity, out) != flightIndex.capacity) {
+        status = -1;
+    }
+    if (!status) status = writePadding(out, h.flightIndexOffset + h.flightIndexCapacity * sizeof(HashIndexSlot), h.passengerIndexOffset);
+    if (!status && h.passengerIndexCapacity &&
+        fwrite(passengerIndex.slots, sizeof(HashIndexSlot), passengerIndex.capacity, out) != passengerIndex.capacity) {
+        status = -1;
+    }
+    if (!status) status = writePadding(out, h.passengerIndexOffset + h.passengerIndexCapacity * sizeof(HashIndexSlot), h.airportOffset);
+    if (!status) status = writeArena(out, &airportStore, (size_t)airportCount);
+    if (!status) status = writePadding(out, h.airportOffset + h.airportCount * sizeof(AirportCode), h.airportIndexOffset);
+    if (!status && h.airportIndexCapacity &&
+        fwrite(airportIndex.slots, sizeof(HashIndexSlot), airportIndex.capacity, out) != airportIndex.capacity) {
+        status = -1;
+    }
+    if (!status) status = writePadding(out, h.airportIndexOffset + h.airportIndexCapacity * sizeof(HashIndexSlot), h.flightColumnsOffset);
+    if (!status) status = writeFlightColumns(out, (size_t)flightCount, booked);
+    free(booked);
+    if (!status) status = syncFile(out);
+    if (fclose(out) != 0) status = -1;
+    if (status != 0) {
+        remove(tmpPath);
+        return -1;
+    }
+#ifdef _WIN32
+    remove(path); // rename() does not replace on Windows
+#endif
+    return rename(tmpPath, path) == 0 ? 0 : -1;
+}
+
+static int mapFile(const char* path, char** baseOut, size_t* sizeOut) {
+#ifdef _WIN32
+    // No mmap: read the whole snapshot in one go instead
+    FILE* in = fopen(path, "rb");
+    if (!in) return errno == ENOENT ? 1 : -1;
+    fseek(in, 0, SEEK_END);
+    long size = ftell(in);
+    rewind(in);
+    char* base = size > 0 ? (char*)malloc((size_t)size) : NULL;
+    if (!base || fread(base, 1, (size_t)size, in) != (size_t)size) {
+        free(base);
+        fclose(in);
+        return -1;
+    }
+    fclose(in);
+    *baseOut = base;
+    *sizeOut = (size_t)size;
+    return 0;
+#else
+    int fd = open(path, O_RDONLY);
+    if (fd < 0) return errno == ENOENT ? 1 : -1;
+    struct stat st;
+    if (fstat(fd, &st) != 0 || st.st_size < (off_t)sizeof(SnapshotHeader)) {
+        close(fd);
+        return -1;
+    }
+    // Private writable mapping: in-place updates are copy-on-write and never reach the file
+    void* base = mmap(NULL, (size_t)st.st_size, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (base == MAP_FAILED) return -1;
+    *baseOut = (char*)base;
+    *sizeOut = (size_t)st.st_size;
+    return 0;
+#endif
+}
+
+static void unmapFile(char* base, size_t size) {
+#ifdef _WIN32
+    (void)size;
+    free(base);
+#else
+    munmap(base, size);
+#endif
+}
+
+void persistUnmapSnapshot(void) {
+    if (!mappedBase) return;
+    unmapFile(mappedBase, mappedSize);
+    mappedBase = NULL;
+    mappedSize = 0;
+}
+
+// Passenger records only ever grew at the end, so an older one is a prefix of today's.
+static uint64_t passengerRecordSize(uint32_t version) {
+    switch (version) {
+        case 3: return offsetof(Passenger, ticketStatus);
+        case 4: return offsetof(Passenger, seat);
+        default: return sizeof(Passenger);
+    }
+}
+
+// Copies an older record and fills in the fields it lacks.
+static void upgradePassenger(Passenger* p, const void* record, size_t recordSize) {
+    memcpy(p, record, recordSize);
+    if (recordSize <= offsetof(Passenger, ticketStatus)) {
+        p->ticketStatus = TICKET_CONFIRMED; // no waitlist yet: every booking held a seat
+        p->waitlistPriority = 0;
+    }
+    if (recordSize <= offsetof(Passenger, seat)) p->seat = -1;
+}
+
+// Older passenger records cannot be adopted in place; they are copied into owned chunks.
+static int upgradePassengers(const char* records, size_t count, size_t recordSize) {
+    if (recordArenaReserve(&passengerStore, count) != 0) return -1;
+    for (size_t i = 0; i < count; ++i) {
+        upgradePassenger((Passenger*)recordArenaAt(&passengerStore, i), records + i * recordSize, recordSize);
+    }
+    return 0;
+}
+
+// count records of recordSize at offset lie inside the file, suitably aligned
+static int sectionFits(const SnapshotHeader* h, uint64_t offset, uint64_t count, uint64_t recordSize) {
+    return offset % PERSIST_ALIGN == 0 && offset >= sizeof(SnapshotHeader) && offset <= h->fileSize &&
+           (recordSize == 0 || count <= (h->fileSize - offset) / recordSize);
+}
+
+// Slot tables are probed with capacity - 1 as a mask and need a free slot to end a miss
+static int indexFits(const SnapshotHeader* h, uint64_t offset, uint64_t capacity, uint64_t records) {
+    if (capacity == 0) return records == 0;
+    return (capacity & (capacity - 1)) == 0 && capacity > records && sectionFits(h, offset, capacity, sizeof(HashIndexSlot));
+}
+
+// Every section must lie inside the mapping before any of it is read.
+static int snapshotLayoutValid(const SnapshotHeader* h) {
+    return sectionFits(h, h->flightOffset, h->flightCount, sizeof(FlightInfo)) &&
+           sectionFits(h, h->passengerOffset, h->passengerCount, passengerRecordSize(h->version)) &&
+           sectionFits(h, h->airportOffset, h->airportCount, sizeof(AirportCode)) &&
+           indexFits(h, h->flightIndexOffset, h->flightIndexCapacity, h->flightCount) &&
+           indexFits(h, h->passengerIndexOffset, h->passengerIndexCapacity, h->passengerCount) &&
+           indexFits(h, h->airportIndexOffset, h->airportIndexCapacity, h->airportCount) &&
+           sectionFits(h, h->flightColumnsOffset, (uint64_t)flightColumnCount(h->version), columnBytes(h->flightCount));
+}
+
+static int terminated(const char* field, size_t size) {
+    return memchr(field, '\0', size) != NULL;
+}
+#define FIELD_TERMINATED(field) terminated((field), sizeof(field))
+
+// Occupied slots must name existing records, one per record, which also leaves a free slot to end every probe
+static int slotsValid(const char* base, uint64_t offset, uint64_t capacity, uint64_t records) {
+    const HashIndexSlot* slots = (const HashIndexSlot*)(base + offset);
+    uint64_t used = 0;
+    for (uint64_t i = 0; i < capacity; ++i) {
+        int32_t record = slots[i].recordIndex;
+        if (record == -1) continue;
+        if (record < 0 || (uint64_t)record >= records) return 0;
+        used++;
+    }
+    return used == records;
+}
+
+/*
+ * The stores, indexes and report code use record ids and strings as they
+ * are, so every id must name an existing record and every string must be
+ * terminated within its field. Runs on the loaded arenas (so upgraded
+ * passengers are checked too) before the counts make anything visible.
+ */
+static int snapshotRecordsValid(const char* base, const SnapshotHeader* h) {
+    for (uint64_t i = 0; i < h->airportCount; ++i) {
+        if (!FIELD_TERMINATED(((const AirportCode*)recordArenaAt(&airportStore, (size_t)i))->code)) return 0;
+    }
+    for (uint64_t i = 0; i < h->flightCount; ++i) {
+        const FlightInfo* f = (const FlightInfo*)recordArenaAt(&flightStore, (size_t)i);
+        if (f->origin < 0 || (uint64_t)f->origin >= h->airportCount || f->destination < 0 ||
+            (uint64_t)f->destination >= h->airportCount || !FIELD_TERMINATED(f->flightNumber) ||
+            !FIELD_TERMINATED(f->departureTime) || !FIELD_TERMINATED(f->arrivalTime) ||
+            !FIELD_TERMINATED(f->aircraft) || !FIELD_TERMINATED(f->status)) {
+            return 0;
+        }
+    }
+    for (uint64_t i = 0; i < h->passengerCount; ++i) {
+        const Passenger* p = (const Passenger*)recordArenaAt(&passengerStore, (size_t)i);
+        if (p->flightIndex < 0 || (uint64_t)p->flightIndex >= h->flightCount || p->ticketStatus < TICKET_CONFIRMED ||
+            p->ticketStatus > TICKET_CANCELLED || p->seat < -1 || !FIELD_TERMINATED(p->id) ||
+            !FIELD_TERMINATED(p->firstName) || !FIELD_TERMINATED(p->lastName) || !FIELD_TERMINATED(p->email) ||
+            !FIELD_TERMINATED(p->phone)) {
+            return 0;
+        }
+    }
+    return slotsValid(base, h->flightIndexOffset, h->flightIndexCapacity, h->flightCount) &&
+           slotsValid(base, h->passengerIndexOffset, h->passengerIndexCapacity, h->passengerCount) &&
+           slotsValid(base, h->airportIndexOffset, h->airportIndexCapacity, h->airportCount);
+}
+
+// Returns 0 when loaded, 1 if there is no snapshot, -1 if it is unusable.
+// Snapshots from PERSIST_VERSION_OLDEST on are upgraded as they load.
+int persistLoadSnapshot(const char* path) {
+    char* base;
+    size_t size;
+    loadedVersion = 0;
+    int mapped = mapFile(path, &base, &size);
+    if (mapped != 0) return mapped;
+    const SnapshotHeader* h = (const SnapshotHeader*)base;
+    if (memcmp(h->magic, PERSIST_MAGIC, sizeof(PERSIST_MAGIC)) != 0 || h->version < PERSIST_VERSION_OLDEST ||
+        h->version > PERSIST_VERSION || h->headerSize != sizeof(SnapshotHeader) ||
+        h->flightRecordSize != sizeof(FlightInfo) || h->passengerRecordSize != passengerRecordSize(h->version) || h->airportRecordSize != sizeof(AirportCode) ||
+        h->fileSize > size || h->flightCount > 0x7fffffff || h->passengerCount > 0x7fffffff ||
+        h->airportCount > 0x7fffffff || !snapshotLayoutValid(h)) {
+        unmapFile(base, size);
+        return -1;
+    }
+    if (recordArenaAdopt(&flightStore, base + h->flightOffset, (size_t)h->flightCount) != 0 ||
+        (h->version == PERSIST_VERSION
+             ? recordArenaAdopt(&passengerStore, base + h->passengerOffset, (size_t)h->passengerCount)
+             : upgradePassengers(base + h->passengerOffset, (size_t)h->passengerCount, h->passengerRecordSize)) != 0 ||
+        recordArenaAdopt(&airportStore, base + h->airportOffset, (size_t)h->airportCount) != 0 ||
+        loadFlightColumns(base + h->flightColumnsOffset, (size_t)h->flightCount, flightColumnCount(h->version)) != 0 ||
+        !snapshotRecordsValid(base, h)) {
+        recordArenaFree(&flightStore);
+        recordArenaFree(&passengerStore);
+        recordArenaFree(&airportStore);
+        flightColumnsFree(&flightColumns);
+        unmapFile(base, size);
+        return -1;
+    }
+    flightCount = (int)h->flightCount;
+    passengerCount = (int)h->passengerCount;
+    airportCount = (int)h->airportCount;
+    if (h->flightIndexCapacity) {
+        hashIndexAdopt(&flightIndex, (HashIndexSlot*)(base + h->flightIndexOffset), (size_t)h->flightIndexCapacity, (size_t)h->flightCount);
+    }
+    if (h->passengerIndexCapacity) {
+        hashIndexAdopt(&passengerIndex, (HashIndexSlot*)(base + h->passengerIndexOffset), (size_t)h->passengerIndexCapacity, (size_t)h->passengerCount);
+    }
+    if (h->airportIndexCapacity) {
+        hashIndexAdopt(&airportIndex, (HashIndexSlot*)(base + h->airportIndexOffset), (size_t)h->airportIndexCapacity, (size_t)h->airportCount);
+    }
+    mappedBase = base;
+    mappedSize = size;
+    loadedVersion = h->version;
+    return 0;
+}
+
+/* ---------- Write-ahead log ---------- */
+
+typedef struct {
+    char* data;
+    size_t length;
+    size_t capacity;
+} LogBuffer;
+
+// All of the below are guarded by logLock.
+static int logFd = -1;
+static LogBuffer logActive;   // appends go here
+static LogBuffer logFlushing; // owned by the flush in progress, if any
+static int flushInProgress = 0;
+static int logFailed = 0;
+// LSNs count log bytes since persistOpen; they keep growing across compactions
+static uint64_t appendedLsn = 0;
+static uint64_t writtenLsn = 0;
+static uint64_t syncedLsn = 0;
+static PersistLogStats logStats;
+static pthread_cond_t logFlushed = PTHREAD_COND_INITIALIZER;
+static pthread_cond_t flusherWake = PTHREAD_COND_INITIALIZER;
+static pthread_t flusherThread;
+static int flusherRunning = 0;
+
+static _Thread_local int batchDepth = 0;
+static _Thread_local uint64_t batchLsn = 0;
+
+static int openLog(const char* path, int truncate) {
+#ifdef _WIN32
+    return _open(path, _O_WRONLY | _O_CREAT | _O_APPEND | _O_BINARY | (truncate ? _O_TRUNC : 0), _S_IREAD | _S_IWRITE);
+#else
+    return open(path, O_WRONLY | O_CREAT | O_APPEND | (truncate ? O_TRUNC : 0), 0644);
+#endif
+}
+
+static int writeAll(int fd, const char* data, size_t length) {
+    while (length > 0) {
+#ifdef _WIN32
+        int n = _write(fd, data, length > 0x40000000u ? 0x40000000u : (unsigned)length);
+#else
+        ssize_t n = write(fd, data, length);
+#endif
+        if (n <= 0) return -1;
+        data += n;
+        length -= (size_t)n;
+    }
+    return 0;
+}
+
+static int syncLog(int fd) {
+#if defined(_WIN32)
+    return _commit(fd);
+#elif defined(__APPLE__)
+    return fsync(fd);
+#else
+    return fdatasync(fd); // the log only appends, so the size update is all the metadata it needs
+#endif
+}
+
+static void closeLog(int fd) {
+#ifdef _WIN32
+    _close(fd);
+#else
+    close(fd);
+#endif
+}
+
+static void sleepMicros(int micros) {
+    struct timespec ts = { micros / 1000000, (long)(micros % 1000000) * 1000 };
+    nanosleep(&ts, NULL);
+}
+
+static void logFailure(void) {
+    if (!logFailed) printf("Warning: unable to write %s; recent changes may not survive a crash.\n", logPath);
+    logFailed = 1;
+}
+
+/*
+ * Writes out everything appended so far, and syncs it if asked. Called
+ * with logLock held and no flush in progress; the lock is dropped around
+ * the I/O so appends carry on into the other buffer meanwhile.
+ */
+static void flushLogLocked(int sync, int delayUs) {
+    flushInProgress = 1;
+    if (delayUs > 0) {
+        pthread_mutex_unlock(&logLock);
+        sleepMicros(delayUs);
+        pthread_mutex_lock(&logLock);
+    }
+    LogBuffer out = logActive;
+    logActive = logFlushing;
+    logFlushing = out;
+    uint64_t target = appendedLsn;
+    int fd = logFd;
+    pthread_mutex_unlock(&logLock);
+    int status = fd == -1 ? -1 : 0;
+    if (status == 0 && out.length > 0) status = writeAll(fd, out.data, out.length);
+    if (status == 0 && sync) status = syncLog(fd);
+    pthread_mutex_lock(&logLock);
+    logFlushing.length = 0;
+    if (status == 0) {
+        writtenLsn = target;
+        if (sync) syncedLsn = target;
+        logStats.writes += out.length > 0;
+        logStats.syncs += sync != 0;
+    } else {
+        logFailure();
+    }
+    flushInProgress = 0;
+    pthread_cond_broadcast(&logFlushed);
+}
+
+static int reserveLog(LogBuffer* b, size_t n) {
+    if (b->length + n <= b->capacity) return 0;
+    size_t capacity = b->capacity ? b->capacity : 65536;
+    while (capacity < b->length + n) capacity *= 2;
+    char* grown = (char*)realloc(b->data, capacity);
+    if (!grown) return -1;
+    b->data = grown;
+    b->capacity = capacity;
+    return 0;
+}
+
+static uint64_t appendEntry(uint32_t type, uint64_t index, const void* payload, uint32_t size) {
+    LogEntryHeader eh;
+    eh.type = type;
+    eh.size = size;
+    eh.index = index;
+    uint32_t sum = checksumBytes(checksumBytes(2166136261u, &eh, sizeof(eh)), payload, size);
+    size_t n = sizeof(eh) + size + sizeof(sum);
+    uint64_t lsn = 0;
+    pthread_mutex_lock(&logLock);
+    if (logFd != -1 && reserveLog(&logActive, n) == 0) {
+        char* dst = logActive.data + logActive.length;
+        memcpy(dst, &eh, sizeof(eh));
+        memcpy(dst + sizeof(eh), payload, size);
+        memcpy(dst + sizeof(eh) + size, &sum, sizeof(sum));
+        logActive.length += n;
+        appendedLsn += n;
+        lsn = appendedLsn;
+        logEntries++;
+        logStats.entries++;
+        logStats.bytes += n;
+        // Keeps memory bounded when nobody commits for a while (bulk loads, buffered mode)
+        if (logActive.length >= PERSIST_LOG_FLUSH_BYTES && !flushInProgress) flushLogLocked(0, 0);
+    } else if (logFd != -1) {
+        logFailure();
+    }
+    pthread_mutex_unlock(&logLock);
+    return lsn;
+}
+
+uint64_t persistLogFlight(int index) {
+    if (!persistEnabled) return 0;
+    Flight row;
+    flightRow(index, &row);
+    return appendEntry(LOG_ENTRY_FLIGHT, (uint64_t)index, &row, sizeof(Flight));
+}
+
+uint64_t persistLogPassenger(int index) {
+    if (!persistEnabled) return 0;
+    return appendEntry(LOG_ENTRY_PASSENGER, (uint64_t)index, passengerAt(index), sizeof(Passenger));
+}
+
+uint64_t persistLogCheckIn(int passengerIndex) {
+    if (!persistEnabled) return 0;
+    int32_t status = passengerAt(passengerIndex)->checkInStatus;
+    return appendEntry(LOG_ENTRY_CHECKIN, (uint64_t)passengerIndex, &status, sizeof(status));
+}
+
+uint64_t persistLogTicket(int passengerIndex) {
+    if (!persistEnabled) return 0;
+    int32_t status = passengerAt(passengerIndex)->ticketStatus;
+    return appendEntry(LOG_ENTRY_TICKET, (uint64_t)passengerIndex, &status, sizeof(status));
+}
+
+uint64_t persistLogOverbook(int flightIndex) {
+    if (!persistEnabled) return 0;
+    int32_t limit = flightColumnsBlock(&flightColumns, (size_t)flightIndex)->overbook[FLIGHT_ROW_SLOT(flightIndex)];
+    return appendEntry(LOG_ENTRY_OVERBOOK, (uint64_t)flightIndex, &limit, sizeof(limit));
+}
+
+uint64_t persistLogSeat(int passengerIndex) {
+    if (!persistEnabled) return 0;
+    int32_t seat = passengerAt(passengerIndex)->seat;
+    return appendEntry(LOG_ENTRY_SEAT, (uint64_t)passengerIndex, &seat, sizeof(seat));
+}
+
+int persistCommit(uint64_t lsn) {
+    if (lsn == 0) return 0;
+    if (batchDepth > 0) {
+        if (lsn > batchLsn) batchLsn = lsn;
+        return 0;
+    }
+    if (durability.mode != PERSIST_SYNC_GROUP) return 0;
+    pthread_mutex_lock(&logLock);
+    while (!logFailed && syncedLsn < lsn) {
+        if (flushInProgress) pthread_cond_wait(&logFlushed, &logLock);
+        else flushLogLocked(1, durability.groupDelayUs);
+    }
+    int status = logFailed ? -1 : 0;
+    pthread_mutex_unlock(&logLock);
+    return status;
+}
+
+void persistBeginBatch(void) {
+    batchDepth++;
+}
+
+int persistEndBatch(void) {
+    if (batchDepth == 0 || --batchDepth > 0) return 0;
+    uint64_t lsn = batchLsn;
+    batchLsn = 0;
+    return persistCommit(lsn);
+}
+
+void persistLogStats(PersistLogStats* out) {
+    pthread_mutex_lock(&logLock);
+    *out = logStats;
+    pthread_mutex_unlock(&logLock);
+}
+
+static void* intervalFlusher(void* unused) {
+    (void)unused;
+    pthread_mutex_lock(&logLock);
+    while (flusherRunning) {
+        struct timespec deadline;
+        clock_gettime(CLOCK_REALTIME, &deadline);
+        deadline.tv_sec += durability.intervalMs / 1000;
+        deadline.tv_nsec += (long)(durability.intervalMs % 1000) * 1000000;
+        if (deadline.tv_nsec >= 1000000000) {
+            deadline.tv_sec++;
+            deadline.tv_nsec -= 1000000000;
+        }
+        pthread_cond_timedwait(&flusherWake, &logLock, &deadline);
+        if (flusherRunning && !flushInProgress && syncedLsn < appendedLsn) flushLogLocked(1, 0);
+    }
+    pthread_mutex_unlock(&logLock);
+    return NULL;
+}
+
+void persistSetDurability(const PersistDurability* d) {
+    durability = *d;
+    if (durability.groupDelayUs < 0) durability.groupDelayUs = 0;
+    if (durability.intervalMs < 1) durability.intervalMs = 1;
+}
+
+static const char* const SYNC_MODE_NAMES[] = { "group", "interval", "buffered" };
+
+int persistParseSyncMode(const char* name, PersistSyncMode* out) {
+    for (int m = PERSIST_SYNC_GROUP; m <= PERSIST_SYNC_BUFFERED; ++m) {
+        if (strcmp(name, SYNC_MODE_NAMES[m]) == 0) {
+            *out = (PersistSyncMode)m;
+            return 0;
+        }
+    }
+    return -1;
+}
+
+const char* persistSyncModeName(PersistSyncMode mode) {
+    return mode >= PERSIST_SYNC_GROUP && mode <= PERSIST_SYNC_BUFFERED ? SYNC_MODE_NAMES[mode] : "unknown";
+}
+
+static void creditSeats(int flight, int seats) {
+    atomic_fetch_add(&flightColumnsBlock(&flightColumns, (size_t)flight)->bookedSeats[FLIGHT_ROW_SLOT(flight)], seats);
+}
+
+static int applyEntry(const LogEntryHeader* eh, const void* payload) {
+    // A log left by an older version holds shorter records; the missing fields take their defaults
+    if (eh->type == LOG_ENTRY_FLIGHT && (eh->size == sizeof(Flight) || eh->size == offsetof(Flight, overbook)) &&
+        eh->index <= (uint64_t)flightCount) {
+        FlightInfo* f = (FlightInfo*)recordArenaSlot(&flightStore, (size_t)eh->index);
+        if (!f || flightColumnsReserve(&flightColumns, (size_t)eh->index + 1) != 0) return -1;
+        Flight row;
+        memset(&row, 0, sizeof(row));
+        memcpy(&row, payload, eh->size);
+        int origin = internAirport(row.origin);
+        int destination = internAirport(row.destination);
+        if (origin == -1 || destination == -1) return -1;
+        strcpy(f->flightNumber, row.flightNumber);
+        f->origin = origin;
+        f->destination = destination;
+        strcpy(f->departureTime, row.departureTime);
+        strcpy(f->arrivalTime, row.arrivalTime);
+        strcpy(f->aircraft, row.aircraft);
+        strcpy(f->status, row.status);
+        FlightColumnBlock* block = flightColumnsBlock(&flightColumns, (size_t)eh->index);
+        size_t slot = FLIGHT_ROW_SLOT(eh->index);
+        block->price[slot] = row.price;
+        block->capacity[slot] = row.capacity;
+        block->priority[slot] = row.priority;
+        block->overbook[slot] = row.overbook;
+        atomic_store(&block->bookedSeats[slot], row.bookedSeats);
+        if (eh->index == (uint64_t)flightCount) {
+            if (hashIndexInsert(&flightIndex, flightCount) != 0) return -1;
+            flightCount++;
+        }
+        return 0;
+    }
+    if (eh->type == LOG_ENTRY_PASSENGER &&
+        (eh->size == sizeof(Passenger) || eh->size == passengerRecordSize(4) || eh->size == passengerRecordSize(3)) &&
+        eh->index <= (uint64_t)passengerCount) {
+        Passenger* p = (Passenger*)recordArenaSlot(&passengerStore, (size_t)eh->index);
+        if (!p) return -1;
+        upgradePassenger(p, payload, eh->size);
+        if (eh->index == (uint64_t)passengerCount) {
+            if (hashIndexInsert(&passengerIndex, passengerCount) != 0) return -1;
+            passengerCount++;
+            // The flight record in the snapshot/log predates this booking
+            int flightIdx = p->flightIndex;
+            if (flightIdx < 0 || flightIdx >= flightCount) return -1;
+            if (p->ticketStatus == TICKET_CONFIRMED) creditSeats(flightIdx, 1);
+        }
+        return 0;
+    }
+    if (eh->type == LOG_ENTRY_TICKET && eh->size == sizeof(int32_t) && eh->index < (uint64_t)passengerCount) {
+        Passenger* p = passengerAt((int)eh->index);
+        int32_t status;
+        memcpy(&status, payload, sizeof(status));
+        // Cancelling a confirmed ticket frees its seat; a promotion takes one
+        creditSeats(p->flightIndex, (status == TICKET_CONFIRMED) - (p->ticketStatus == TICKET_CONFIRMED));
+        p->ticketStatus = status;
+        return 0;
+    }
+    if (eh->type == LOG_ENTRY_OVERBOOK && eh->size == sizeof(int32_t) && eh->index < (uint64_t)flightCount) {
+        memcpy(&flightColumnsBlock(&flightColumns, (size_t)eh->index)->overbook[FLIGHT_ROW_SLOT(eh->index)], payload,
+               sizeof(int32_t));
+        return 0;
+    }
+    if (eh->type == LOG_ENTRY_SEAT && eh->size == sizeof(int32_t) && eh->index < (uint64_t)passengerCount) {
+        memcpy(&passengerAt((int)eh->index)->seat, payload, sizeof(int32_t));
+        return 0;
+    }
+    if (eh->type == LOG_ENTRY_CHECKIN && eh->size == sizeof(int32_t) && eh->index < (uint64_t)passengerCount) {
+        int32_t status;
+        memcpy(&status, payload, sizeof(status));
+        passengerAt((int)eh->index)->checkInStatus = status;
+        return 0;
+    }
+    return -1;
+}
+
+long persistReplayLog(const char* path) {
+    FILE* in = fopen(path, "rb");
+    if (!in) return 0;
+    long applied = 0;
+    long failure = 0;
+    char payload[sizeof(Flight) > sizeof(Passenger) ? sizeof(Flight) : sizeof(Passenger)];
+    LogEntryHeader eh;
+    long goodBytes = 0;
+    while (fread(&eh, sizeof(eh), 1, in) == 1) {
+        uint32_t stored;
+        if (eh.size > sizeof(payload) || fread(payload, 1, eh.size, in) != eh.size ||
+            fread(&stored, sizeof(stored), 1, in) != 1 ||
+            stored != checksumBytes(checksumBytes(2166136261u, &eh, sizeof(eh)), payload, eh.size)) {
+            failure = PERSIST_REPLAY_TORN;
+            break;
+        }
+        // Intact but unusable: the entries after it may still matter, so this is not a torn tail
+        if (applyEntry(&eh, payload) != 0) {
+            failure = PERSIST_REPLAY_INCONSISTENT;
+            break;
+        }
+        applied++;
+        goodBytes = ftell(in);
+    }
+    // Any bytes past the last complete entry are a torn write
+    if (!failure && (fseek(in, 0, SEEK_END) != 0 || ftell(in) != goodBytes)) failure = PERSIST_REPLAY_TORN;
+    fclose(in);
+    return failure ? failure : applied;
+}
+
+static double nowMs(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1000.0 + ts.tv_nsec / 1e6;
+}
+
+int persistOpen(const char* basePath) {
+    snprintf(snapshotPath, sizeof(snapshotPath), "%s.db", basePath);
+    snprintf(logPath, sizeof(logPath), "%s.log", basePath);
+    double start = nowMs();
+    int loaded = persistLoadSnapshot(snapshotPath);
+    if (loaded < 0) {
+        // Starting empty would let the next compaction overwrite it
+        printf("Unable to load %s (unreadable, corrupt or from an incompatible version); it was left untouched.\n",
+               snapshotPath);
+        return PERSIST_OPEN_REFUSED;
+    }
+    double mapped = nowMs();
+    long replayed = persistReplayLog(logPath);
+    double done = nowMs();
+    if (replayed == PERSIST_REPLAY_INCONSISTENT) {
+        // Compacting now would throw away every entry past the bad one
+        printf("Unable to replay %s: an intact entry does not fit the data before it; both files were left untouched.\n",
+               logPath);
+        return PERSIST_OPEN_REFUSED;
+    }
+    if (flightCount || passengerCount) {
+        printf("Loaded %d flights, %d passengers from %s (snapshot %.2f ms, log replay %.2f ms)\n",
+               flightCount, passengerCount, basePath, mapped - start, done - mapped);
+    }
+
+    logFd = openLog(logPath, 0);
+    if (logFd == -1) {
+        printf("Unable to open %s; changes will not be saved.\n", logPath);
+        return -1;
+    }
+    persistEnabled = 1;
+    logEntries = replayed > 0 ? replayed : 0;
+    appendedLsn = writtenLsn = syncedLsn = 0;
+    logFailed = 0;
+    memset(&logStats, 0, sizeof(logStats));
+    if (replayed < 0) {
+        // Torn tail from a crash: fold what was readable into a snapshot and start a clean log
+        printf("Recovered %s up to its last complete entry.\n", logPath);
+        persistCompact();
+    } else if (loadedVersion && loadedVersion < PERSIST_VERSION) {
+        // Rewrite it now so the upgrade is done once, not on every start
+        printf("Upgraded %s from version %u to %d.\n", snapshotPath, (unsigned)loadedVersion, PERSIST_VERSION);
+        persistCompact();
+    }
+    if (durability.mode == PERSIST_SYNC_INTERVAL) {
+        flusherRunning = 1;
+        if (pthread_create(&flusherThread, NULL, intervalFlusher, NULL) != 0) {
+            flusherRunning = 0;
+            printf("Unable to start the log flusher; falling back to group commit.\n");
+            durability.mode = PERSIST_SYNC_GROUP;
+        }
+    }
+    return 0;
+}
+
+void persistSync(void) {
+    if (!persistEnabled) return;
+    pthread_mutex_lock(&logLock);
+    if (!flushInProgress && writtenLsn < appendedLsn) flushLogLocked(0, 0);
+    long entries = logEntries;
+    pthread_mutex_unlock(&logLock);
+    if (entries >= PERSIST_COMPACT_ENTRIES) persistCompact();
+}
+
+int persistCompact(void) {
+    if (!persistEnabled) return -1;
+    // Bookings log their record before publishing it and may rehash passengerIndex;
+    // holding the registry keeps both out of the snapshot's way (it is taken before logLock)
+    pthread_rwlock_wrlock(&passengerRegistryLock);
+    pthread_mutex_lock(&logLock);
+    while (flushInProgress) pthread_cond_wait(&logFlushed, &logLock);
+    int status = persistWriteSnapshot(snapshotPath);
+    if (status == 0) {
+        // Snapshot is durable; the log's contents, written or still buffered, are now redundant
+        logActive.length = 0;
+        writtenLsn = syncedLsn = appendedLsn;
+        logFailed = 0;
+        if (logFd != -1) closeLog(logFd);
+        logFd = openLog(logPath, 1);
+        if (logFd == -1) logFailure();
+        logEntries = 0;
+        pthread_cond_broadcast(&logFlushed);
+    } else if (!logFailed) {
+        flushLogLocked(1, 0);
+    }
+    pthread_mutex_unlock(&logLock);
+    pthread_rwlock_unlock(&passengerRegistryLock);
+    return status;
+}
+
+void persistClose(void) {
+    if (!persistEnabled) return;
+    if (flusherRunning) {
+        pthread_mutex_lock(&logLock);
+        flusherRunning = 0;
+        pthread_cond_signal(&flusherWake);
+        pthread_mutex_unlock(&logLock);
+        pthread_join(flusherThread, NULL);
+    }
+    if (persistCompact() != 0) {
+        printf("Warning: snapshot compaction failed; %s keeps the changes.\n", logPath);
+    }
+    pthread_mutex_lock(&logLock);
+    while (flushInProgress) pthread_cond_wait(&logFlushed, &logLock);
+    if (logFd != -1) {
+        if (syncedLsn < appendedLsn) flushLogLocked(1, 0);
+        closeLog(logFd);
+        logFd = -1;
+    }
+    free(logActive.data);
+    free(logFlushing.data);
+    memset(&logActive, 0, sizeof(logActive));
+    memset(&logFlushing, 0, sizeof(logFlushing));
+    persistEnabled = 0;
+    pthread_mutex_unlock(&logLock);
+}
@@ -0,0 +1,149 @@
+#ifndef PERSIST_H
+#define PERSIST_H
+
+#include <stdint.h>
+
+/*
+ * Binary persistence for flights and passengers.
+ *
+ * <base>.db  - versioned snapshot: fixed header, then raw FlightInfo,
+ *              Passenger and AirportCode records, the hash index slot
+ *              tables and the flight columns (price, capacity, booked
+ *              seats, priority, overbooking limit; one array each). It is
+ *              mmap'd (MAP_PRIVATE) at startup and the record arenas and
+ *              indexes point straight into the mapping; only the 20 bytes
+ *              per flight of column data are copied out. Loading reads
+ *              every record and slot once to check its ids and strings,
+ *              a sequential scan with no allocation or rehashing.
+ * <base>.log - write-ahead log of flight (full Flight row)/passenger record
+ *              writes, check-ins, ticket status changes (cancellation,
+ *              waitlist promotion), seat assignments and overbooking limits
+ *              since the last snapshot; replayed on open and folded into a
+ *              fresh snapshot (compaction) once it grows past a threshold
+ *              and on clean shutdown.
+ *
+ * Log writes are two steps: persistLog*() appends an entry to an in-memory
+ * buffer and returns its LSN (the log's logical length after the entry),
+ * and persistCommit(lsn) makes it as durable as the sync mode promises.
+ * In PERSIST_SYNC_GROUP mode committers share fdatasync calls: the first
+ * one in becomes the leader, swaps out the buffer and syncs everything
+ * appended so far while later appends fill the other buffer; followers
+ * whose entries that sync covered just wake up. A small groupDelayUs makes
+ * the leader wait for more followers, trading commit latency for fewer
+ * syncs. The call that appends must not hold locks the committers need.
+ */
+#define PERSIST_MAGIC "AIRLNDB"
+#define PERSIST_VERSION 5
+#define PERSIST_VERSION_OLDEST 3 // older snapshots (names, not ids, in records) are refused
+#define PERSIST_COMPACT_ENTRIES 100000
+#define PERSIST_LOG_FLUSH_BYTES (1 << 20) // buffered entries past this are written out without a sync
+
+typedef enum {
+    PERSIST_SYNC_GROUP = 0, // commit returns once fdatasync covers the entry
+    PERSIST_SYNC_INTERVAL,  // commit returns at once; a flusher syncs every intervalMs
+    PERSIST_SYNC_BUFFERED   // written at each menu step or when the buffer fills, synced only on compaction
+} PersistSyncMode;
+
+typedef struct {
+    PersistSyncMode mode;
+    int groupDelayUs; // GROUP: leader waits this long to gather followers before syncing
+    int intervalMs;   // INTERVAL: upper bound on the window a power loss can cost
+} PersistDurability;
+
+#define PERSIST_DURABILITY_DEFAULT { PERSIST_SYNC_GROUP, 0, 50 }
+
+typedef struct {
+    uint64_t entries;
+    uint64_t bytes;
+    uint64_t writes; // write() calls
+    uint64_t syncs;  // fdatasync() calls
+} PersistLogStats;
+
+typedef struct {
+    char magic[8];
+    uint32_t version;
+    uint32_t headerSize;
+    uint32_t flightRecordSize;
+    uint32_t passengerRecordSize;
+    uint32_t airportRecordSize;
+    uint32_t reserved;
+    uint64_t flightCount;
+    uint64_t passengerCount;
+    uint64_t flightOffset;
+    uint64_t passengerOffset;
+    uint64_t flightIndexOffset;
+    uint64_t flightIndexCapacity;
+    uint64_t passengerIndexOffset;
+    uint64_t passengerIndexCapacity;
+    uint64_t airportCount;
+    uint64_t airportOffset;
+    uint64_t airportIndexOffset;
+    uint64_t airportIndexCapacity;
+    uint64_t flightColumnsOffset; // price[], capacity[], bookedSeats[], priority[], overbook[], each flightCount long and aligned
+    uint64_t fileSize;
+} SnapshotHeader;
+
+// CHECKIN, TICKET, OVERBOOK and SEAT carry one int32: check-in status, ticket status, overbooking limit, seat
+enum {
+    LOG_ENTRY_FLIGHT = 1,
+    LOG_ENTRY_PASSENGER = 2,
+    LOG_ENTRY_CHECKIN = 3,
+    LOG_ENTRY_TICKET = 4,
+    LOG_ENTRY_OVERBOOK = 5,
+    LOG_ENTRY_SEAT = 6
+};
+
+typedef struct {
+    uint32_t type;
+    uint32_t size;   // payload bytes
+    uint64_t index;  // record position in its store
+} LogEntryHeader;   // followed by payload and a 32-bit FNV-1a checksum
+
+// Takes effect at the next persistOpen().
+void persistSetDurability(const PersistDurability* durability);
+// "group", "interval" or "buffered"; returns 0, or -1 for an unknown name.
+int persistParseSyncMode(const char* name, PersistSyncMode* out);
+const char* persistSyncModeName(PersistSyncMode mode);
+
+#define PERSIST_OPEN_REFUSED -2
+
+// Loads <base>.db and replays <base>.log into the (empty) stores, then keeps
+// the log open for appends. A snapshot from an older version (down to
+// PERSIST_VERSION_OLDEST) is upgraded and rewritten. Returns 0 on success (including "no files yet"),
+// -1 if the log cannot be opened (changes will not be saved), or
+// PERSIST_OPEN_REFUSED if existing data could not be loaded: the files are
+// left as they are and the stores must not be used.
+int persistOpen(const char* basePath);
+// Each returns the entry's LSN, or 0 when persistence is off.
+uint64_t persistLogFlight(int index);
+uint64_t persistLogPassenger(int index);
+uint64_t persistLogCheckIn(int passengerIndex);
+uint64_t persistLogTicket(int passengerIndex);
+uint64_t persistLogOverbook(int flightIndex);
+uint64_t persistLogSeat(int passengerIndex);
+// Returns once lsn is durable per the sync mode; 0, or -1 if the log could not be written.
+int persistCommit(uint64_t lsn);
+// Between these, persistCommit() on this thread only records the LSN and
+// persistEndBatch() commits the highest one, so a bulk load pays one sync.
+void persistBeginBatch(void);
+int persistEndBatch(void);
+void persistLogStats(PersistLogStats* out);
+// Writes out buffered log entries and compacts if the log has grown large.
+void persistSync(void);
+// Takes passengerRegistryLock for writing; the caller must not hold it.
+int persistCompact(void);
+// Compacts and closes; persistence is off afterwards.
+void persistClose(void);
+
+int persistWriteSnapshot(const char* path);
+#define PERSIST_REPLAY_TORN -1         // ends in a torn/corrupt entry; everything before it was applied
+#define PERSIST_REPLAY_INCONSISTENT -2 // an intact entry could not be applied (e.g. refers to a missing record)
+
+// Applies a log to the stores without opening it for appends. Returns the
+// number of entries applied, or one of the PERSIST_REPLAY_ codes above.
+long persistReplayLog(const char* path);
+int persistLoadSnapshot(const char* path);
+// Called by resetStores() once nothing points into the mapping any more.
+void persistUnmapSnapshot(void);
+
+#endif // PERSIST_H
@@ -0,0 +1,235 @@
+#include "reportwriter.h"
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+
+static void flushBuffer(ReportWriter* w) {
+    if (w->length && !w->failed && fwrite(w->buffer, 1, w->length, w->out) != w->length) w->failed = 1;
+    w->length = 0;
+}
+
+// Room for n more bytes; only grows past REPORT_BUFFER_SIZE for a single oversized cell.
+static int reserve(ReportWriter* w, size_t n) {
+    if (w->failed) return -1;
+    if (w->length + n <= w->capacity) return 0;
+    flushBuffer(w);
+    if (n > w->capacity) {
+        char* grown = (char*)realloc(w->buffer, n);
+        if (!grown) {
+            w->failed = 1;
+            return -1;
+        }
+        w->buffer = grown;
+        w->capacity = n;
+    }
+    return w->failed ? -1 : 0;
+}
+
+static void putBytes(ReportWriter* w, const char* s, size_t n) {
+    memcpy(w->buffer + w->length, s, n);
+    w->length += n;
+}
+
+// JSON members need the key in front; the other formats only a separator.
+static size_t cellOverhead(const ReportWriter* w) {
+    const ReportColumn* c = &w->columns[w->column];
+    if (w->format == REPORT_JSON) return strlen(c->key) + 8;
+    return 1 + (w->format == REPORT_TEXT ? (size_t)c->width : 0);
+}
+
+static void beginCell(ReportWriter* w) {
+    if (w->format == REPORT_JSON) {
+        if (w->column == 0) {
+            if (w->rows > 0) w->buffer[w->length++] = ',';
+            w->buffer[w->length++] = '\n';
+            w->buffer[w->length++] = '{';
+        } else {
+            w->buffer[w->length++] = ',';
+        }
+        const char* key = w->columns[w->column].key;
+        w->buffer[w->length++] = '"';
+        putBytes(w, key, strlen(key));
+        w->buffer[w->length++] = '"';
+        w->buffer[w->length++] = ':';
+    } else if (w->column > 0) {
+        w->buffer[w->length++] = w->format == REPORT_CSV ? ',' : ' ';
+    }
+}
+
+static void endCell(ReportWriter* w, size_t start) {
+    if (w->format == REPORT_TEXT) {
+        size_t used = w->length - start;
+        size_t width = (size_t)w->columns[w->column].width;
+        if (used < width) {
+            memset(w->buffer + w->length, ' ', width - used);
+            w->length += width - used;
+        }
+    }
+    w->column++;
+}
+
+static int csvNeedsQuotes(const char* s, size_t n) {
+    for (size_t i = 0; i < n; ++i) {
+        if (s[i] == ',' || s[i] == '"' || s[i] == '\n' || s[i] == '\r') return 1;
+    }
+    return 0;
+}
+
+static void putCsvQuoted(ReportWriter* w, const char* s, size_t n) {
+    for (size_t i = 0; i < n; ++i) {
+        if (s[i] == '"') w->buffer[w->length++] = '"';
+        w->buffer[w->length++] = s[i];
+    }
+}
+
+// Copies runs of plain bytes in one go; only quotes, backslashes and control bytes are escaped.
+static void putJsonEscaped(ReportWriter* w, const char* s, size_t n) {
+    static const char HEX[] = "0123456789abcdef";
+    size_t run = 0;
+    for (size_t i = 0; i < n; ++i) {
+        unsigned char ch = (unsigned char)s[i];
+        if (ch >= 0x20 && ch != '"' && ch != '\\') continue;
+        putBytes(w, s + run, i - run);
+        run = i + 1;
+        if (ch < 0x20) {
+            putBytes(w, "\\u00", 4);
+            w->buffer[w->length++] = HEX[ch >> 4];
+            w->buffer[w->length++] = HEX[ch & 15];
+        } else {
+            w->buffer[w->length++] = '\\';
+            w->buffer[w->length++] = (char)ch;
+        }
+    }
+    putBytes(w, s + run, n - run);
+}
+
+static void putPart(ReportWriter* w, const char* s, size_t n, int quoted) {
+    if (w->format == REPORT_JSON) putJsonEscaped(w, s, n);
+    else if (quoted) putCsvQuoted(w, s, n);
+    else putBytes(w, s, n);
+}
+
+static void putStringCell(ReportWriter* w, const char* first, size_t firstLen, char sep, const char* second,
+                          size_t secondLen) {
+    size_t n = firstLen + (sep ? 1 + secondLen : 0);
+    // Worst cases: JSON \u00XX escapes (6 bytes each) plus quotes
+    if (reserve(w, cellOverhead(w) + 6 * n + 2) != 0) return;
+    beginCell(w);
+    size_t start = w->length;
+    int quoted = w->format == REPORT_JSON ||
+                 (w->format == REPORT_CSV && (csvNeedsQuotes(first, firstLen) || (sep && csvNeedsQuotes(second, secondLen))));
+    if (quoted) w->buffer[w->length++] = '"';
+    putPart(w, first, firstLen, quoted);
+    if (sep) {
+        putPart(w, &sep, 1, quoted);
+        putPart(w, second, secondLen, quoted);
+    }
+    if (quoted) w->buffer[w->length++] = '"';
+    endCell(w, start);
+}
+
+void reportText(ReportWriter* w, const char* text) {
+    putStringCell(w, text, strlen(text), 0, NULL, 0);
+}
+
+void reportJoined(ReportWriter* w, const char* first, char sep, const char* second) {
+    putStringCell(w, first, strlen(first), sep, second, strlen(second));
+}
+
+// Decimal digits of value into the end of buf; returns the first digit.
+static char* formatUnsigned(char* end, unsigned long long value) {
+    do {
+        *--end = (char)('0' + value % 10);
+        value /= 10;
+    } while (value);
+    return end;
+}
+
+void reportInt(ReportWriter* w, long value) {
+    char digits[24];
+    char* end = digits + sizeof(digits);
+    unsigned long long magnitude = value < 0 ? 0ull - (unsigned long long)value : (unsigned long long)value;
+    char* first = formatUnsigned(end, magnitude);
+    if (value < 0) *--first = '-';
+    if (reserve(w, cellOverhead(w) + (size_t)(end - first)) != 0) return;
+    beginCell(w);
+    size_t start = w->length;
+    putBytes(w, first, (size_t)(end - first));
+    endCell(w, start);
+}
+
+void reportMoney(ReportWriter* w, double amount) {
+    char digits[48];
+    char* end = digits + sizeof(digits);
+    char* first;
+    // nearbyint() rounds ties to even, as glibc's "%.2f" does for exactly representable halves
+    double cents = nearbyint(amount * 100.0);
+    if (isfinite(cents) && fabs(cents) < 1e17) {
+        unsigned long long magnitude = (unsigned long long)fabs(cents);
+        char* p = end;
+        *--p = (char)('0' + magnitude % 10);
+        *--p = (char)('0' + magnitude / 10 % 10);
+        *--p = '.';
+        first = formatUnsigned(p, magnitude / 100);
+        if (cents < 0) *--first = '-';
+    } else {
+        int n = snprintf(digits, sizeof(digits), "%.2f", amount);
+        first = digits;
+        end = digits + (n > 0 && n < (int)sizeof(digits) ? n : 0);
+    }
+    if (reserve(w, cellOverhead(w) + (size_t)(end - first) + 1) != 0) return;
+    beginCell(w);
+    size_t start = w->length;
+    if (w->format == REPORT_TEXT) w->buffer[w->length++] = '$';
+    putBytes(w, first, (size_t)(end - first));
+    endCell(w, start);
+}
+
+void reportEndRow(ReportWriter* w) {
+    if (reserve(w, 2) != 0) return;
+    if (w->format == REPORT_JSON) w->buffer[w->length++] = '}';
+    else w->buffer[w->length++] = '\n';
+    w->column = 0;
+    w->rows++;
+}
+
+int reportWriterOpen(ReportWriter* w, FILE* out, ReportFormat format, const ReportColumn* columns, int columnCount) {
+    w->out = out;
+    w->format = format;
+    w->columns = columns;
+    w->columnCount = columnCount;
+    w->column = 0;
+    w->rows = 0;
+    w->length = 0;
+    w->failed = 0;
+    w->capacity = REPORT_BUFFER_SIZE;
+    w->buffer = (char*)malloc(w->capacity);
+    if (!w->buffer) return -1;
+    if (format == REPORT_JSON) {
+        w->buffer[w->length++] = '[';
+        return 0;
+    }
+    for (int c = 0; c < columnCount; ++c) reportText(w, format == REPORT_CSV ? columns[c].key : columns[c].title);
+    if (reserve(w, 1) == 0) w->buffer[w->length++] = '\n';
+    w->column = 0;
+    return 0;
+}
+
+int reportWriterClose(ReportWriter* w) {
+    if (w->format == REPORT_JSON && reserve(w, 3) == 0) putBytes(w, w->rows ? "\n]\n" : "]\n", w->rows ? 3 : 2);
+    flushBuffer(w);
+    if (fflush(w->out) != 0) w->failed = 1;
+    free(w->buffer);
+    w->buffer = NULL;
+    w->capacity = 0;
+    return w->failed ? -1 : 0;
+}
+
+const char* reportFormatName(ReportFormat format) {
+    switch (format) {
+        case REPORT_TEXT: return "text";
+        case REPORT_CSV: return "csv";
+        case REPORT_JSON: return "json";
+    }
+    return "unknown";
+}
@@ -0,0 +1,55 @@
+#ifndef REPORTWRITER_H
+#define REPORTWRITER_H
+
+#include <stdio.h>
+#include <stddef.h>
+
+#define REPORT_BUFFER_SIZE (1 << 20)
+
+typedef enum {
+    REPORT_TEXT = 0, // fixed-width columns, as on screen
+    REPORT_CSV,      // RFC 4180 quoting, header row of column keys
+    REPORT_JSON      // one array of objects keyed by column key
+} ReportFormat;
+
+typedef struct {
+    const char* title; // text header
+    const char* key;   // CSV header and JSON member name
+    int width;         // text mode: cells are left-aligned and padded to this
+} ReportColumn;
+
+/*
+ * Row-at-a-time table writer. Cells are formatted by hand straight into
+ * one reusable buffer, which goes out in a single fwrite() whenever it
+ * fills, so a report costs one stdio call per REPORT_BUFFER_SIZE bytes
+ * instead of one per row and nothing is allocated after open. Cells are
+ * given in column order; each row ends with reportEndRow().
+ */
+typedef struct {
+    FILE* out;
+    ReportFormat format;
+    const ReportColumn* columns;
+    int columnCount;
+    int column; // next cell in the current row
+    long rows;
+    char* buffer;
+    size_t length;
+    size_t capacity;
+    int failed; // a write or allocation failed; the rest of the report is dropped
+} ReportWriter;
+
+// Allocates the buffer and writes the header. Returns 0, or -1 if out of memory.
+int reportWriterOpen(ReportWriter* w, FILE* out, ReportFormat format, const ReportColumn* columns, int columnCount);
+void reportText(ReportWriter* w, const char* text);
+// One cell holding first, sep, second, e.g. a route "DEL-BOM" or a full name.
+void reportJoined(ReportWriter* w, const char* first, char sep, const char* second);
+void reportInt(ReportWriter* w, long value);
+// Two decimals, rounded like printf("%.2f"); "$" prefixed in text mode.
+void reportMoney(ReportWriter* w, double amount);
+void reportEndRow(ReportWriter* w);
+// Writes the footer, flushes and frees the buffer. Returns 0, or -1 if anything failed.
+int reportWriterClose(ReportWriter* w);
+
+const char* reportFormatName(ReportFormat format);
+
+#endif // REPORTWRITER_H
@@ -0,0 +1,361 @@
+#include "routegraph.h"
+#include "apsp.h"
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+
+RouteGraph createRouteGraph(int vertices, int directed) {
+    RouteGraph graph;
+    graph.vertexCount = vertices;
+    graph.directed = directed ? 1 : 0;
+    graph.adjMatrix = allocateMatrix(vertices, INF_WEIGHT);
+    if (graph.adjMatrix) {
+        for (int i = 0; i < vertices; ++i) {
+            graph.adjMatrix[i][i] = 0.0;
+        }
+    }
+    return graph;
+}
+
+void freeRouteGraph(RouteGraph* graph) {
+    if (!graph || !graph->adjMatrix) return;
+    freeMatrix(graph->adjMatrix, graph->vertexCount);
+    graph->adjMatrix = NULL;
+}
+
+double** allocateMatrix(int n, double initial) {
+    if (n <= 0) return NULL;
+    double** matrix = (double**)malloc(sizeof(double*) * n);
+    if (!matrix) return NULL;
+    for (int i = 0; i < n; ++i) {
+        matrix[i] = (double*)malloc(sizeof(double) * n);
+        if (!matrix[i]) {
+            for (int k = 0; k < i; ++k) {
+                free(matrix[k]);
+            }
+            free(matrix);
+            return NULL;
+        }
+        for (int j = 0; j < n; ++j) {
+            matrix[i][j] = initial;
+        }
+    }
+    return matrix;
+}
+
+void freeMatrix(double** matrix, int n) {
+    if (!matrix) return;
+    for (int i = 0; i < n; ++i) {
+        free(matrix[i]);
+    }
+    free(matrix);
+}
+
+double primMST(const RouteGraph* graph, MSTResultEdge* output, int* edgeCount) {
+    int V = graph->vertexCount;
+    
+    double* key = (double*)malloc(sizeof(double) * V);
+    int* parent = (int*)malloc(sizeof(int) * V);
+    bool* inMST = (bool*)malloc(sizeof(bool) * V);
+    
+    // Initialize arrays
+    for (int i = 0; i < V; i++) {
+        key[i] = INF_WEIGHT;
+        parent[i] = -1;
+        inMST[i] = false;
+    }
+    
+    // Build MST; a round that reaches nothing starts a new tree, so
+    // disconnected graphs give a spanning forest
+    for (int count = 0; count < V; count++) {
+        // Find minimum key vertex not in MST
+        double min = INF_WEIGHT;
+        int u = -1;
+        int firstOutside = -1;
+        for (int v = 0; v < V; v++) {
+            if (inMST[v]) continue;
+            if (firstOutside == -1) firstOutside = v;
+            if (key[v] < min) {
+                min = key[v];
+                u = v;
+            }
+        }
+        if (u == -1) u = firstOutside;
+        
+        inMST[u] = true;
+        
+        // Update keys of adjacent vertices
+        for (int v = 0; v < V; v++) {
+            double weight = graph->adjMatrix[u][v];
+            if (inMST[v] == false && weight < key[v]) {
+                key[v] = weight;
+                parent[v] = u;
+            }
+        }
+    }
+    
+    // Build output and calculate total weight; tree roots have no parent
+    double total = 0.0;
+    int idx = 0;
+    for (int v = 0; v < V; v++) {
+        if (parent[v] == -1) continue;
+        output[idx].src = parent[v];
+        output[idx].dest = v;
+        output[idx].weight = key[v];
+        total += output[idx].weight;
+        idx++;
+    }
+    
+    *edgeCount = idx;
+    
+    free(key);
+    free(parent);
+    free(inMST);
+    
+    return total;
+}
+
+int buildUndirectedEdgeList(const RouteGraph* graph, RouteEdge** edgesOut) {
+    if (!graph || !graph->adjMatrix) {
+        *edgesOut = NULL;
+        return 0;
+    }
+    int V = graph->vertexCount;
+    int capacity = V * (V - 1) / 2;
+    if (capacity <= 0) {
+        *edgesOut = NULL;
+        return 0;
+    }
+    RouteEdge* edges = (RouteEdge*)malloc(sizeof(RouteEdge) * capacity);
+    if (!edges) {
+        *edgesOut = NULL;
+        return 0;
+    }
+    int count = 0;
+    for (int i = 0; i < V; ++i) {
+        for (int j = i + 1; j < V; ++j) {
+            double wForward = graph->adjMatrix[i][j];
+            double wBackward = graph->adjMatrix[j][i];
+            double weight = wForward;
+            if (wBackward < weight) weight = wBackward;
+            if (weight < INF_WEIGHT / 2.0) {
+                edges[count].src = i;
+                edges[count].dest = j;
+                edges[count].weight = weight;
+                ++count;
+            }
+        }
+    }
+    *edgesOut = edges;
+    return count;
+}
+
+/* Simple Dijkstra (single-source) using adjacency matrix (non-negative weights only) */
+void dijkstra(const RouteGraph* graph, int src, double* dist) {
+    int V = graph->vertexCount;
+    bool* visited = (bool*)calloc(V, sizeof(bool));
+    for (int i = 0; i < V; ++i) dist[i] = INF_WEIGHT;
+    dist[src] = 0.0;
+
+    for (int count = 0; count < V; ++count) {
+        double minDist = INF_WEIGHT;
+        int u = -1;
+        for (int v = 0; v < V; ++v) {
+            if (!visited[v] && dist[v] < minDist) {
+                minDist = dist[v];
+                u = v;
+            }
+        }
+        if (u == -1) break;
+        visited[u] = true;
+        for (int v = 0; v < V; ++v) {
+            double w = graph->adjMatrix[u][v];
+            if (w >= INF_WEIGHT / 2.0) continue;
+            double alt = dist[u] + w;
+            if (alt < dist[v]) dist[v] = alt;
+        }
+    }
+    free(visited);
+}
+
+int floydWarshallReference(const RouteGraph* graph, double** distOut) {
+    if (!graph || !graph->adjMatrix || !distOut) return -1;
+    int V = graph->vertexCount;
+    for (int i = 0; i < V; ++i) {
+        for (int j = 0; j < V; ++j) {
+            distOut[i][j] = graph->adjMatrix[i][j];
+        }
+        distOut[i][i] = 0.0;
+    }
+
+    for (int k = 0; k < V; ++k) {
+        for (int i = 0; i < V; ++i) {
+            if (distOut[i][k] >= INF_WEIGHT / 2.0) continue;
+            for (int j = 0; j < V; ++j) {
+                if (distOut[k][j] >= INF_WEIGHT / 2.0) continue;
+                double alt = distOut[i][k] + distOut[k][j];
+                if (alt < distOut[i][j]) {
+                    distOut[i][j] = alt;
+                }
+            }
+        }
+    }
+    return 0;
+}
+
+int floydWarshallAllPairs(const RouteGraph* graph, double** distOut) {
+    if (!graph || !graph->adjMatrix || !distOut) return -1;
+    DistanceMatrix dist;
+    if (distanceMatrixFromGraph(&dist, graph) != 0) return -1;
+    if (apspBlockedFloydWarshall(&dist, APSP_KERNEL_AUTO) < 0) {
+        distanceMatrixFree(&dist);
+        return -1;
+    }
+    for (int i = 0; i < graph->vertexCount; ++i) {
+        memcpy(distOut[i], distanceMatrixRow(&dist, i), sizeof(double) * (size_t)graph->vertexCount);
+    }
+    distanceMatrixFree(&dist);
+    return 0;
+}
+
+int buildCsrGraph(CsrGraph* graph, int vertexCount, const RouteEdge* edges, int edgeCount, int directed) {
+    int arcs = 0;
+    for (int i = 0; i < edgeCount; ++i) {
+        if (edges[i].src == edges[i].dest) continue;
+        arcs += directed ? 1 : 2;
+    }
+    graph->vertexCount = vertexCount;
+    graph->arcCount = arcs;
+    graph->rowStart = (int*)calloc((size_t)vertexCount + 1, sizeof(int));
+    graph->target = (int*)malloc(sizeof(int) * (arcs > 0 ? arcs : 1));
+    graph->weight = (double*)malloc(sizeof(double) * (arcs > 0 ? arcs : 1));
+    if (!graph->rowStart || !graph->target || !graph->weight) {
+        freeCsrGraph(graph);
+        return -1;
+    }
+    // Counting sort of arcs by source vertex
+    for (int i = 0; i < edgeCount; ++i) {
+        const RouteEdge* e = &edges[i];
+        if (e->src == e->dest) continue;
+        graph->rowStart[e->src + 1]++;
+        if (!directed) graph->rowStart[e->dest + 1]++;
+    }
+    for (int v = 0; v < vertexCount; ++v) graph->rowStart[v + 1] += graph->rowStart[v];
+    int* fill = (int*)malloc(sizeof(int) * (vertexCount > 0 ? vertexCount : 1));
+    if (!fill) {
+        freeCsrGraph(graph);
+        return -1;
+    }
+    memcpy(fill, graph->rowStart, sizeof(int) * vertexCount);
+    for (int i = 0; i < edgeCount; ++i) {
+        const RouteEdge* e = &edges[i];
+        if (e->src == e->dest) continue;
+        int slot = fill[e->src]++;
+        graph->target[slot] = e->dest;
+        graph->weight[slot] = e->weight;
+        if (!directed) {
+            slot = fill[e->dest]++;
+            graph->target[slot] = e->src;
+            graph->weight[slot] = e->weight;
+        }
+    }
+    free(fill);
+    return 0;
+}
+
+int buildReverseCsrGraph(CsrGraph* reverse, const CsrGraph* graph) {
+    int n = graph->vertexCount;
+    int arcs = graph->arcCount;
+    reverse->vertexCount = n;
+    reverse->arcCount = arcs;
+    reverse->rowStart = (int*)calloc((size_t)n + 1, sizeof(int));
+    reverse->target = (int*)malloc(sizeof(int) * (arcs > 0 ? arcs : 1));
+    reverse->weight = (double*)malloc(sizeof(double) * (arcs > 0 ? arcs : 1));
+    int* fill = (int*)malloc(sizeof(int) * (n > 0 ? n : 1));
+    if (!reverse->rowStart || !reverse->target || !reverse->weight || !fill) {
+        free(fill);
+        freeCsrGraph(reverse);
+        return -1;
+    }
+    for (int a = 0; a < arcs; ++a) reverse->rowStart[graph->target[a] + 1]++;
+    for (int v = 0; v < n; ++v) reverse->rowStart[v + 1] += reverse->rowStart[v];
+    memcpy(fill, reverse->rowStart, sizeof(int) * n);
+    for (int u = 0; u < n; ++u) {
+        for (int a = graph->rowStart[u]; a < graph->rowStart[u + 1]; ++a) {
+            int slot = fill[graph->target[a]]++;
+            reverse->target[slot] = u;
+            reverse->weight[slot] = graph->weight[a];
+        }
+    }
+    free(fill);
+    return 0;
+}
+
+double csrArcWeight(const CsrGraph* graph, int u, int v) {
+    double best = INF_WEIGHT;
+    for (int a = graph->rowStart[u]; a < graph->rowStart[u + 1]; ++a) {
+        if (graph->target[a] == v && graph->weight[a] < best) best = graph->weight[a];
+    }
+    return best;
+}
+
+void freeCsrGraph(CsrGraph* graph) {
+    free(graph->rowStart);
+    free(graph->target);
+    free(graph->weight);
+    graph->rowStart = NULL;
+    graph->target = NULL;
+    graph->weight = NULL;
+    graph->vertexCount = 0;
+    graph->arcCount = 0;
+}
+
+void dijkstraCsrWithHeap(const CsrGraph* graph, int src, double* dist, IndexedHeap* heap) {
+    dijkstraCsrTree(graph, src, dist, NULL, heap);
+}
+
+void dijkstraCsrTree(const CsrGraph* graph, int src, double* dist, int* parent, IndexedHeap* heap) {
+    for (int i = 0; i < graph->vertexCount; ++i) dist[i] = INF_WEIGHT;
+    if (parent) {
+        for (int i = 0; i < graph->vertexCount; ++i) parent[i] = -1;
+    }
+    dist[src] = 0.0;
+    indexedHeapPushOrDecrease(heap, src, 0.0);
+    double du;
+    int u;
+    while ((u = indexedHeapPop(heap, &du)) != -1) {
+        for (int a = graph->rowStart[u]; a < graph->rowStart[u + 1]; ++a) {
+            int v = graph->target[a];
+            double alt = du + graph->weight[a];
+            if (alt < dist[v]) {
+                dist[v] = alt;
+                if (parent) parent[v] = u;
+                indexedHeapPushOrDecrease(heap, v, alt);
+            }
+        }
+    }
+}
+
+int dijkstraCsr(const CsrGraph* graph, int src, double* dist) {
+    IndexedHeap heap;
+    if (indexedHeapInit(&heap, graph->vertexCount) != 0) return -1;
+    dijkstraCsrWithHeap(graph, src, dist, &heap);
+    indexedHeapFree(&heap);
+    return 0;
+}
+
+int routeGraphIsDense(int vertexCount, long arcCount) {
+    if (vertexCount < 2) return 1;
+    double possible = (double)vertexCount * (double)(vertexCount - 1);
+    return (double)arcCount / possible >= DENSE_GRAPH_DENSITY;
+}
+
+int shortestPathsFrom(const RouteGraph* matrix, const CsrGraph* csr, int src, double* dist) {
+    int useMatrix = matrix && matrix->adjMatrix && (!csr || routeGraphIsDense(csr->vertexCount, csr->arcCount));
+    if (useMatrix) {
+        dijkstra(matrix, src, dist);
+        return 1;
+    }
+    if (!csr) return -1;
+    return dijkstraCsr(csr, src, dist) == 0 ? 0 : -1;
+}
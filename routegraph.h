@@ -0,0 +1,71 @@
+#ifndef ROUTEGRAPH_H
+#define ROUTEGRAPH_H
+
+#include "indexedheap.h"
+
+#define INF_WEIGHT 1e12
+// Above this fraction of possible arcs the O(V^2) matrix scan beats heap-based search
+#define DENSE_GRAPH_DENSITY 0.25
+
+typedef struct {
+    int src;
+    int dest;
+    double weight;
+} RouteEdge;
+
+typedef struct {
+    int vertexCount;
+    int directed; // bool, but keep int for scanf compatibility
+    double **adjMatrix;
+} RouteGraph;
+
+typedef struct {
+    int src;
+    int dest;
+    double weight;
+} MSTResultEdge;
+
+/*
+ * Compressed sparse row adjacency: the arcs leaving v are
+ * target/weight[rowStart[v] .. rowStart[v + 1]). Undirected routes are
+ * stored as two arcs.
+ */
+typedef struct {
+    int vertexCount;
+    int arcCount;
+    int* rowStart;
+    int* target;
+    double* weight;
+} CsrGraph;
+
+RouteGraph createRouteGraph(int vertices, int directed);
+void freeRouteGraph(RouteGraph* graph);
+double** allocateMatrix(int n, double initial);
+void freeMatrix(double** matrix, int n);
+
+double primMST(const RouteGraph* graph, MSTResultEdge* output, int* edgeCount);
+int buildUndirectedEdgeList(const RouteGraph* graph, RouteEdge** edgesOut);
+// Blocked SIMD kernel from apsp.c; distOut rows are filled from its contiguous result.
+int floydWarshallAllPairs(const RouteGraph* graph, double** distOut);
+// Textbook triple loop over the row pointers, kept as a baseline for benchmarks.
+int floydWarshallReference(const RouteGraph* graph, double** distOut);
+void dijkstra(const RouteGraph* graph, int src, double* dist);
+
+int buildCsrGraph(CsrGraph* graph, int vertexCount, const RouteEdge* edges, int edgeCount, int directed);
+// Same vertices with every arc turned around, for searches that run backwards from a target.
+int buildReverseCsrGraph(CsrGraph* reverse, const CsrGraph* graph);
+void freeCsrGraph(CsrGraph* graph);
+// Cheapest u->v arc, or INF_WEIGHT if there is none.
+double csrArcWeight(const CsrGraph* graph, int u, int v);
+// O(E log V) Dijkstra; heap must have capacity >= vertexCount and be empty.
+void dijkstraCsrWithHeap(const CsrGraph* graph, int src, double* dist, IndexedHeap* heap);
+// As above, also recording each vertex's predecessor on its shortest path (-1 for src/unreached).
+void dijkstraCsrTree(const CsrGraph* graph, int src, double* dist, int* parent, IndexedHeap* heap);
+int dijkstraCsr(const CsrGraph* graph, int src, double* dist);
+
+int routeGraphIsDense(int vertexCount, long arcCount);
+// Single-source shortest paths on whichever representation suits the density.
+// Returns 1 if the matrix path was used, 0 for CSR, -1 on failure.
+int shortestPathsFrom(const RouteGraph* matrix, const CsrGraph* csr, int src, double* dist);
+
+#endif // ROUTEGRAPH_H
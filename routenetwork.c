@@ -0,0 +1,298 @@
+#include "routenetwork.h"
+#include "airline.h"
+#include "stores.h"
+#include "linereader.h"
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define ROUTE_MAX_FIELDS 10
+#define OPENFLIGHTS_ROUTE_FIELDS 9
+
+static const char* airportKeyAt(void* ctx, int index) {
+    return routeNetworkAirportCode((const RouteNetwork*)ctx, index);
+}
+
+void routeNetworkInit(RouteNetwork* net, int directed) {
+    RecordArena airports = RECORD_ARENA_INIT(Airport, 10);
+    net->airports = airports;
+    net->airportCount = 0;
+    hashIndexInit(&net->airportIndex, airportKeyAt, net);
+    net->routes = NULL;
+    net->routeCount = 0;
+    net->routeCapacity = 0;
+    net->directed = directed ? 1 : 0;
+    net->coordinateCount = 0;
+    net->skippedLines = 0;
+}
+
+void routeNetworkFree(RouteNetwork* net) {
+    hashIndexFree(&net->airportIndex);
+    recordArenaFree(&net->airports);
+    free(net->routes);
+    net->routes = NULL;
+    net->airportCount = 0;
+    net->routeCount = 0;
+    net->routeCapacity = 0;
+    net->coordinateCount = 0;
+}
+
+int routeNetworkFind(const RouteNetwork* net, const char* code) {
+    return hashIndexFind(&net->airportIndex, code);
+}
+
+int routeNetworkIntern(RouteNetwork* net, const char* code) {
+    int existing = hashIndexFind(&net->airportIndex, code);
+    if (existing != -1) return existing;
+    size_t len = strlen(code);
+    if (len == 0 || len >= AIRPORT_CODE_LEN) return -1;
+    Airport* a = (Airport*)recordArenaSlot(&net->airports, (size_t)net->airportCount);
+    if (!a) return -1;
+    memcpy(a->code, code, len + 1);
+    a->hasCoordinates = 0;
+    if (hashIndexInsert(&net->airportIndex, net->airportCount) != 0) return -1;
+    return net->airportCount++;
+}
+
+int routeNetworkAddRoute(RouteNetwork* net, int src, int dest, double weight) {
+    if (net->routeCount == net->routeCapacity) {
+        int capacity = net->routeCapacity ? net->routeCapacity * 2 : 64;
+        RouteEdge* grown = (RouteEdge*)realloc(net->routes, sizeof(RouteEdge) * (size_t)capacity);
+        if (!grown) return -1;
+        net->routes = grown;
+        net->routeCapacity = capacity;
+    }
+    RouteEdge* e = &net->routes[net->routeCount++];
+    e->src = src;
+    e->dest = dest;
+    e->weight = weight;
+    return 0;
+}
+
+void routeNetworkSetCoordinates(RouteNetwork* net, int airport, double latitude, double longitude) {
+    Airport* a = (Airport*)recordArenaAt(&net->airports, (size_t)airport);
+    if (!a->hasCoordinates) net->coordinateCount++;
+    a->latitude = latitude;
+    a->longitude = longitude;
+    a->hasCoordinates = 1;
+}
+
+// Resolves a stored airport id to its vertex, interning the code on first sight
+static int flightAirportVertex(RouteNetwork* net, int* vertexOf, int airport) {
+    if (vertexOf[airport] == -1) vertexOf[airport] = routeNetworkIntern(net, airportCode(airport));
+    return vertexOf[airport];
+}
+
+int routeNetworkLoadFlights(RouteNetwork* net) {
+    int* vertexOf = (int*)malloc(sizeof(int) * (size_t)(airportCount > 0 ? airportCount : 1));
+    if (!vertexOf) return -1;
+    for (int a = 0; a < airportCount; ++a) vertexOf[a] = -1;
+    int added = 0;
+    for (int i = 0; i < flightCount; ++i) {
+        const FlightInfo* f = flightAt(i);
+        int src = flightAirportVertex(net, vertexOf, f->origin);
+        int dest = flightAirportVertex(net, vertexOf, f->destination);
+        if (src == -1 || dest == -1) {
+            free(vertexOf);
+            return -1;
+        }
+        int dep = flightClockMinutes(f->departureTime);
+        int arr = flightClockMinutes(f->arrivalTime);
+        // Arrival before departure means the flight crosses midnight
+        double minutes = (dep >= 0 && arr >= 0) ? (double)((arr - dep + 24 * 60) % (24 * 60)) : 0.0;
+        if (routeNetworkAddRoute(net, src, dest, minutes > 0 ? minutes : 1.0) != 0) {
+            free(vertexOf);
+            return -1;
+        }
+        added++;
+    }
+    free(vertexOf);
+    return added;
+}
+
+typedef struct {
+    RouteNetwork* net;
+    int added;
+    int failed;
+} RouteLoadState;
+
+static void routeLine(void* ctx, char* line, size_t len) {
+    RouteLoadState* state = (RouteLoadState*)ctx;
+    RouteNetwork* net = state->net;
+    if (state->failed) return;
+    if (!line) {
+        net->skippedLines++;
+        return;
+    }
+    if (len > 0 && line[len - 1] == '\r') line[--len] = '\0';
+    if (len == 0 || line[0] == '#') return;
+
+    char* fields[ROUTE_MAX_FIELDS];
+    int count = 0;
+    fields[count++] = line;
+    for (char* c = line; *c && count <= ROUTE_MAX_FIELDS; ++c) {
+        if (*c == ',') {
+            *c = '\0';
+            if (count < ROUTE_MAX_FIELDS) fields[count] = c + 1;
+            count++;
+        }
+    }
+
+    const char* srcCode;
+    const char* destCode;
+    double weight = 1.0;
+    char* end;
+    if (count == 2 || count == 3) {
+        srcCode = fields[0];
+        destCode = fields[1];
+        if (count == 3) {
+            weight = strtod(fields[2], &end);
+            if (end == fields[2] || *end != '\0' || !isfinite(weight) || weight < 0) {
+                net->skippedLines++;
+                return;
+            }
+        }
+    } else if (count == OPENFLIGHTS_ROUTE_FIELDS) {
+        srcCode = fields[2];
+        destCode = fields[4];
+        long stops = strtol(fields[7], &end, 10);
+        weight = (end != fields[7] && stops > 0) ? (double)(stops + 1) : 1.0;
+    } else {
+        net->skippedLines++;
+        return;
+    }
+
+    int src = routeNetworkIntern(net, srcCode);
+    int dest = routeNetworkIntern(net, destCode);
+    if (src == -1 || dest == -1) {
+        // Over-long or empty codes are bad rows; anything else is memory running out
+        if (srcCode[0] && destCode[0] && strlen(srcCode) < AIRPORT_CODE_LEN && strlen(destCode) < AIRPORT_CODE_LEN) {
+            state->failed = 1;
+        } else {
+            net->skippedLines++;
+        }
+        return;
+    }
+    if (routeNetworkAddRoute(net, src, dest, weight) != 0) {
+        state->failed = 1;
+        return;
+    }
+    state->added++;
+}
+
+int routeNetworkLoadStream(RouteNetwork* net, FILE* in) {
+    RouteLoadState state = { net, 0, 0 };
+    if (lineReaderRun(in, routeLine, &state) != 0 || state.failed) return -1;
+    return state.added;
+}
+
+int routeNetworkLoadFile(RouteNetwork* net, const char* path) {
+    FILE* in = strcmp(path, "-") == 0 ? stdin : fopen(path, "rb");
+    if (!in) return -1;
+    int added = routeNetworkLoadStream(net, in);
+    if (in != stdin) fclose(in);
+    return added;
+}
+
+#define OPENFLIGHTS_AIRPORT_FIELDS 14
+#define AIRPORT_MAX_FIELDS 16
+
+// Splits on ',' outside double quotes and strips the quotes; returns the field count.
+static int splitQuotedFields(char* line, char* fields[], int maxFields) {
+    int count = 0;
+    char* out = line;
+    char* c = line;
+    int quoted = 0;
+    fields[count++] = out;
+    for (; *c; ++c) {
+        if (*c == '"') {
+            quoted = !quoted;
+        } else if (*c == ',' && !quoted) {
+            *out++ = '\0';
+            if (count == maxFields) return -1;
+            fields[count++] = out;
+        } else {
+            *out++ = *c;
+        }
+    }
+    *out = '\0';
+    return count;
+}
+
+static int parseDegrees(const char* text, double limit, double* out) {
+    char* end;
+    double value = strtod(text, &end);
+    if (end == text || *end != '\0' || value < -limit || value > limit) return -1;
+    *out = value;
+    return 0;
+}
+
+typedef struct {
+    RouteNetwork* net;
+    int located;
+} AirportLoadState;
+
+static void airportLine(void* ctx, char* line, size_t len) {
+    AirportLoadState* state = (AirportLoadState*)ctx;
+    RouteNetwork* net = state->net;
+    if (!line) {
+        net->skippedLines++;
+        return;
+    }
+    if (len > 0 && line[len - 1] == '\r') line[--len] = '\0';
+    if (len == 0 || line[0] == '#') return;
+
+    char* fields[AIRPORT_MAX_FIELDS];
+    int count = splitQuotedFields(line, fields, AIRPORT_MAX_FIELDS);
+    int airport = -1;
+    const char* lat;
+    const char* lon;
+    if (count == 3) {
+        airport = routeNetworkFind(net, fields[0]);
+        lat = fields[1];
+        lon = fields[2];
+    } else if (count == OPENFLIGHTS_AIRPORT_FIELDS) {
+        airport = routeNetworkFind(net, fields[4]);                  // IATA
+        if (airport == -1) airport = routeNetworkFind(net, fields[5]); // ICAO
+        lat = fields[6];
+        lon = fields[7];
+    } else {
+        net->skippedLines++;
+        return;
+    }
+    if (airport == -1) return;
+    double latitude, longitude;
+    if (parseDegrees(lat, 90.0, &latitude) || parseDegrees(lon, 180.0, &longitude)) {
+        net->skippedLines++;
+        return;
+    }
+    if (!routeNetworkAirport(net, airport)->hasCoordinates) state->located++;
+    routeNetworkSetCoordinates(net, airport, latitude, longitude);
+}
+
+int routeNetworkLoadAirportsFile(RouteNetwork* net, const char* path) {
+    FILE* in = fopen(path, "rb");
+    if (!in) return -1;
+    AirportLoadState state = { net, 0 };
+    int status = lineReaderRun(in, airportLine, &state);
+    fclose(in);
+    return status == 0 ? state.located : -1;
+}
+
+int routeNetworkBuildMatrix(const RouteNetwork* net, RouteGraph* graph, int symmetric) {
+    int directed = net->directed && !symmetric;
+    *graph = createRouteGraph(net->airportCount, directed);
+    if (!graph->adjMatrix) return -1;
+    double** m = graph->adjMatrix;
+    for (int i = 0; i < net->routeCount; ++i) {
+        const RouteEdge* e = &net->routes[i];
+        if (e->src == e->dest) continue;
+        if (m[e->src][e->dest] > e->weight) m[e->src][e->dest] = e->weight;
+        if (!directed && m[e->dest][e->src] > e->weight) m[e->dest][e->src] = e->weight;
+    }
+    return 0;
+}
+
+int routeNetworkBuildCsr(const RouteNetwork* net, CsrGraph* csr) {
+    return buildCsrGraph(csr, net->airportCount, net->routes, net->routeCount, net->directed);
+}
@@ -0,0 +1,83 @@
+#ifndef ROUTENETWORK_H
+#define ROUTENETWORK_H
+
+#include <stdio.h>
+#include "arena.h"
+#include "hashindex.h"
+#include "routegraph.h"
+
+#define AIRPORT_CODE_LEN 32 // same as Flight origin/destination
+
+typedef struct {
+    char code[AIRPORT_CODE_LEN];
+    double latitude;  // degrees, valid when hasCoordinates
+    double longitude;
+    int hasCoordinates;
+} Airport;
+
+/*
+ * Route network as loaded from flights or a route file: airports are
+ * interned once through a hash index, so every route endpoint becomes a
+ * dense vertex id, and routes are kept as a flat edge list. The matrix
+ * and CSR forms used by the algorithms are built from it on demand.
+ * The airport index points back at the network, so it must not be
+ * moved after routeNetworkInit().
+ */
+typedef struct {
+    RecordArena airports;
+    int airportCount;
+    HashIndex airportIndex;
+    RouteEdge* routes;
+    int routeCount;
+    int routeCapacity;
+    int directed;
+    int coordinateCount; // airports with hasCoordinates set
+    long skippedLines;   // malformed or unusable rows seen by the loaders
+} RouteNetwork;
+
+void routeNetworkInit(RouteNetwork* net, int directed);
+void routeNetworkFree(RouteNetwork* net);
+
+static inline const Airport* routeNetworkAirport(const RouteNetwork* net, int airport) {
+    return (const Airport*)recordArenaAt(&net->airports, (size_t)airport);
+}
+
+static inline const char* routeNetworkAirportCode(const RouteNetwork* net, int airport) {
+    return routeNetworkAirport(net, airport)->code;
+}
+
+// Vertex id for code, or -1 if unknown.
+int routeNetworkFind(const RouteNetwork* net, const char* code);
+// Vertex id for code, adding it if new. -1 if the code is empty, too long, or memory runs out.
+int routeNetworkIntern(RouteNetwork* net, const char* code);
+int routeNetworkAddRoute(RouteNetwork* net, int src, int dest, double weight);
+void routeNetworkSetCoordinates(RouteNetwork* net, int airport, double latitude, double longitude);
+
+// One route per stored flight, weighted by scheduled block time in minutes.
+// Returns the number of routes added, or -1 on allocation failure.
+int routeNetworkLoadFlights(RouteNetwork* net);
+
+/*
+ * Streamed route file, one route per line ('#' comments):
+ *   SRC,DST[,WEIGHT]      weight defaults to 1
+ *   OpenFlights routes.dat rows (9 fields: source code in field 3,
+ *   destination in field 5); weighted by hop count, stops + 1
+ * Returns the number of routes added, or -1 on read/allocation failure.
+ */
+int routeNetworkLoadStream(RouteNetwork* net, FILE* in);
+int routeNetworkLoadFile(RouteNetwork* net, const char* path);
+
+/*
+ * Coordinates for airports already in the network, one per line:
+ *   CODE,LATITUDE,LONGITUDE
+ *   OpenFlights airports.dat rows (quoted CSV; IATA or ICAO code)
+ * Unknown codes are ignored. Returns the number of airports located, or -1.
+ */
+int routeNetworkLoadAirportsFile(RouteNetwork* net, const char* path);
+
+// Dense matrix keeping the cheapest of parallel routes; symmetric fills both
+// directions even for a directed network. -1 on allocation failure.
+int routeNetworkBuildMatrix(const RouteNetwork* net, RouteGraph* graph, int symmetric);
+int routeNetworkBuildCsr(const RouteNetwork* net, CsrGraph* csr);
+
+#endif // ROUTENETWORK_H
@@ -0,0 +1,226 @@
+#include "routequery.h"
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define DEG_TO_RAD (3.14159265358979323846 / 180.0)
+
+enum { SEARCH_FORWARD = 0, SEARCH_BACKWARD = 1 };
+
+static void toUnitVector(double latitude, double longitude, double* out) {
+    double lat = latitude * DEG_TO_RAD;
+    double lon = longitude * DEG_TO_RAD;
+    out[0] = cos(lat) * cos(lon);
+    out[1] = cos(lat) * sin(lon);
+    out[2] = sin(lat);
+}
+
+// Arc length from the straight-line chord between two unit vectors
+static double unitDistanceKm(const double* a, const double* b) {
+    double dx = a[0] - b[0], dy = a[1] - b[1], dz = a[2] - b[2];
+    double half = 0.5 * sqrt(dx * dx + dy * dy + dz * dz);
+    if (half > 1.0) half = 1.0;
+    return 2.0 * EARTH_RADIUS_KM * asin(half);
+}
+
+double greatCircleKm(double lat1, double lon1, double lat2, double lon2) {
+    double a[3], b[3];
+    toUnitVector(lat1, lon1, a);
+    toUnitVector(lat2, lon2, b);
+    return unitDistanceKm(a, b);
+}
+
+void routeItineraryInit(RouteItinerary* it) {
+    it->stops = NULL;
+    it->stopCount = 0;
+    it->stopCapacity = 0;
+    it->cost = INF_WEIGHT;
+    it->settled = 0;
+}
+
+void routeItineraryFree(RouteItinerary* it) {
+    free(it->stops);
+    routeItineraryInit(it);
+}
+
+static int itineraryPush(RouteItinerary* it, int airport) {
+    if (it->stopCount == it->stopCapacity) {
+        int capacity = it->stopCapacity ? it->stopCapacity * 2 : 16;
+        int* grown = (int*)realloc(it->stops, sizeof(int) * (size_t)capacity);
+        if (!grown) return -1;
+        it->stops = grown;
+        it->stopCapacity = capacity;
+    }
+    it->stops[it->stopCount++] = airport;
+    return 0;
+}
+
+void routeQueryFree(RouteQuery* q) {
+    if (q->ownsReverse) freeCsrGraph(&q->reverse);
+    q->ownsReverse = 0;
+    for (int side = 0; side < 2; ++side) {
+        free(q->dist[side]);
+        free(q->parent[side]);
+        free(q->stamp[side]);
+        q->dist[side] = NULL;
+        q->parent[side] = NULL;
+        q->stamp[side] = NULL;
+        if (q->heap[side].pos) indexedHeapFree(&q->heap[side]);
+    }
+    free(q->potential);
+    free(q->potentialStamp);
+    free(q->unitVectors);
+    q->potential = NULL;
+    q->potentialStamp = NULL;
+    q->unitVectors = NULL;
+}
+
+int routeQueryInit(RouteQuery* q, const RouteNetwork* net, const CsrGraph* forward) {
+    memset(q, 0, sizeof(*q));
+    q->forward = forward;
+    int n = forward->vertexCount;
+    size_t count = (size_t)(n > 0 ? n : 1);
+    if (net->directed) {
+        if (buildReverseCsrGraph(&q->reverse, forward) != 0) return -1;
+        q->ownsReverse = 1;
+    }
+    int failed = 0;
+    for (int side = 0; side < 2; ++side) {
+        q->dist[side] = (double*)malloc(sizeof(double) * count);
+        q->parent[side] = (int*)malloc(sizeof(int) * count);
+        q->stamp[side] = (unsigned*)calloc(count, sizeof(unsigned));
+        if (indexedHeapInit(&q->heap[side], n) != 0) failed = 1;
+        if (!q->dist[side] || !q->parent[side] || !q->stamp[side]) failed = 1;
+    }
+    q->potential = (double*)malloc(sizeof(double) * count);
+    q->potentialStamp = (unsigned*)calloc(count, sizeof(unsigned));
+    if (failed || !q->potential || !q->potentialStamp) {
+        routeQueryFree(q);
+        return -1;
+    }
+
+    if (n > 0 && net->coordinateCount == n) {
+        q->unitVectors = (double*)malloc(sizeof(double) * 3 * count);
+        if (!q->unitVectors) {
+            routeQueryFree(q);
+            return -1;
+        }
+        for (int v = 0; v < n; ++v) {
+            const Airport* a = routeNetworkAirport(net, v);
+            toUnitVector(a->latitude, a->longitude, &q->unitVectors[3 * v]);
+        }
+        // Tightest scale that keeps every route at least as long as its great-circle bound
+        double scale = INF_WEIGHT;
+        for (int u = 0; u < n; ++u) {
+            for (int a = forward->rowStart[u]; a < forward->rowStart[u + 1]; ++a) {
+                double km = unitDistanceKm(&q->unitVectors[3 * u], &q->unitVectors[3 * forward->target[a]]);
+                if (km > 1e-6 && forward->weight[a] / km < scale) scale = forward->weight[a] / km;
+            }
+        }
+        // Headroom for rounding so reduced costs never go negative
+        q->heuristicScale = scale < INF_WEIGHT ? scale * (1.0 - 1e-9) : 0.0;
+    }
+    return 0;
+}
+
+static inline double labelOf(const RouteQuery* q, int side, int v) {
+    return q->stamp[side][v] == q->generation ? q->dist[side][v] : INF_WEIGHT;
+}
+
+/*
+ * Balanced potential (pi_dest(v) - pi_src(v)) / 2 for the forward search and
+ * its negation for the backward one. Both are consistent, so the searches
+ * can stop on the plain bidirectional test minKeyForward + minKeyBackward >= best.
+ */
+static double forwardPotential(RouteQuery* q, int v, int src, int dest) {
+    if (q->heuristicScale == 0.0) return 0.0;
+    if (q->potentialStamp[v] != q->generation) {
+        const double* p = &q->unitVectors[3 * v];
+        double toDest = unitDistanceKm(p, &q->unitVectors[3 * dest]);
+        double toSrc = unitDistanceKm(p, &q->unitVectors[3 * src]);
+        q->potential[v] = 0.5 * q->heuristicScale * (toDest - toSrc);
+        q->potentialStamp[v] = q->generation;
+    }
+    return q->potential[v];
+}
+
+static int buildItinerary(const RouteQuery* q, int meetFrom, int meetTo, RouteItinerary* out) {
+    // Forward half is collected backwards from the meeting arc, then flipped
+    for (int v = meetFrom; v != -1; v = q->parent[SEARCH_FORWARD][v]) {
+        if (itineraryPush(out, v) != 0) return -1;
+    }
+    for (int i = 0, j = out->stopCount - 1; i < j; ++i, --j) {
+        int t = out->stops[i];
+        out->stops[i] = out->stops[j];
+        out->stops[j] = t;
+    }
+    for (int v = meetTo; v != -1; v = q->parent[SEARCH_BACKWARD][v]) {
+        if (itineraryPush(out, v) != 0) return -1;
+    }
+    return 0;
+}
+
+int routeQueryBest(RouteQuery* q, int src, int dest, RouteItinerary* out) {
+    out->stopCount = 0;
+    out->cost = INF_WEIGHT;
+    out->settled = 0;
+    if (src == dest) {
+        out->cost = 0.0;
+        return itineraryPush(out, src) == 0 ? 0 : -1;
+    }
+    if (++q->generation == 0) {
+        size_t count = (size_t)(q->forward->vertexCount > 0 ? q->forward->vertexCount : 1);
+        memset(q->stamp[SEARCH_FORWARD], 0, sizeof(unsigned) * count);
+        memset(q->stamp[SEARCH_BACKWARD], 0, sizeof(unsigned) * count);
+        memset(q->potentialStamp, 0, sizeof(unsigned) * count);
+        q->generation = 1;
+    }
+    const CsrGraph* graphs[2] = { q->forward, q->ownsReverse ? &q->reverse : q->forward };
+    const int ends[2] = { src, dest };
+    for (int side = 0; side < 2; ++side) {
+        int v = ends[side];
+        q->dist[side][v] = 0.0;
+        q->parent[side][v] = -1;
+        q->stamp[side][v] = q->generation;
+        double p = forwardPotential(q, v, src, dest);
+        indexedHeapPushOrDecrease(&q->heap[side], v, side == SEARCH_FORWARD ? p : -p);
+    }
+
+    double best = INF_WEIGHT;
+    int meetFrom = -1, meetTo = -1;
+    while (!indexedHeapEmpty(&q->heap[0]) && !indexedHeapEmpty(&q->heap[1])) {
+        double forwardKey = indexedHeapMinKey(&q->heap[0]);
+        double backwardKey = indexedHeapMinKey(&q->heap[1]);
+        if (forwardKey + backwardKey >= best) break;
+        int side = forwardKey <= backwardKey ? SEARCH_FORWARD : SEARCH_BACKWARD;
+        int other = 1 - side;
+        double key;
+        int u = indexedHeapPop(&q->heap[side], &key);
+        out->settled++;
+        double du = q->dist[side][u];
+        const CsrGraph* g = graphs[side];
+        for (int a = g->rowStart[u]; a < g->rowStart[u + 1]; ++a) {
+            int v = g->target[a];
+            double alt = du + g->weight[a];
+            if (alt < labelOf(q, side, v)) {
+                q->dist[side][v] = alt;
+                q->parent[side][v] = u;
+                q->stamp[side][v] = q->generation;
+                double p = forwardPotential(q, v, src, dest);
+                indexedHeapPushOrDecrease(&q->heap[side], v, alt + (side == SEARCH_FORWARD ? p : -p));
+            }
+            double dv = labelOf(q, other, v);
+            if (dv < INF_WEIGHT && alt + dv < best) {
+                best = alt + dv;
+                // Store the joining arc in travel direction
+                meetFrom = side == SEARCH_FORWARD ? u : v;
+                meetTo = side == SEARCH_FORWARD ? v : u;
+            }
+        }
+    }
+    indexedHeapClear(&q->heap[0]);
+    indexedHeapClear(&q->heap[1]);
+    if (best >= INF_WEIGHT / 2.0) return 1;
+    out->cost = best;
+    return buildItinerary(q, meetFrom, meetTo, out);
+}
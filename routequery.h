@@ -0,0 +1,57 @@
+#ifndef ROUTEQUERY_H
+#define ROUTEQUERY_H
+
+#include "routegraph.h"
+#include "routenetwork.h"
+
+#define EARTH_RADIUS_KM 6371.0
+
+typedef struct {
+    int* stops; // airport ids from origin to destination
+    int stopCount;
+    int stopCapacity;
+    double cost;
+    int settled; // vertices popped by both searches together
+} RouteItinerary;
+
+/*
+ * Point-to-point routing over a CSR network. Each query runs a forward
+ * search from the origin and a backward search from the destination and
+ * stops as soon as the two frontiers prove the best meeting point.
+ *
+ * When every airport has coordinates, both searches are A*-guided by the
+ * great-circle distance to their goal, scaled by the smallest
+ * weight-per-km seen on any route. That bound never overestimates, so
+ * answers stay exact whatever the weights mean (km, minutes, fares).
+ *
+ * Per-vertex state is reset lazily with a generation stamp, so a query
+ * only pays for the vertices it touches.
+ */
+typedef struct {
+    const CsrGraph* forward;
+    CsrGraph reverse;
+    int ownsReverse;     // directed networks need a transposed copy
+    double* unitVectors; // x,y,z per airport on the unit sphere, NULL without coordinates
+    double heuristicScale; // weight units per km of great-circle distance; 0 = plain Dijkstra
+    double* dist[2];
+    int* parent[2];
+    double* potential; // forward potential; the backward one is its negation
+    unsigned* stamp[2];
+    unsigned* potentialStamp;
+    unsigned generation;
+    IndexedHeap heap[2];
+} RouteQuery;
+
+// forward must outlive the query. Returns 0 or -1 on allocation failure.
+int routeQueryInit(RouteQuery* q, const RouteNetwork* net, const CsrGraph* forward);
+void routeQueryFree(RouteQuery* q);
+
+// Returns 0 with the itinerary filled in, 1 if dest is unreachable, -1 on allocation failure.
+int routeQueryBest(RouteQuery* q, int src, int dest, RouteItinerary* out);
+
+void routeItineraryInit(RouteItinerary* it);
+void routeItineraryFree(RouteItinerary* it);
+
+double greatCircleKm(double lat1, double lon1, double lat2, double lon2);
+
+#endif // ROUTEQUERY_H
@@ -0,0 +1,529 @@
+#include "routeupdate.h"
+#include "spanningtree.h"
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+
+// Relative slack when deciding whether a source's paths ran over a changed arc
+#define TIGHT_PATH_TOLERANCE 1e-9
+
+typedef struct {
+    double weight;
+    int id;
+} WeightedRoute;
+
+static int compareWeightedRoutes(const void* a, const void* b) {
+    const WeightedRoute* x = (const WeightedRoute*)a;
+    const WeightedRoute* y = (const WeightedRoute*)b;
+    if (x->weight != y->weight) return x->weight < y->weight ? -1 : 1;
+    return (x->id > y->id) - (x->id < y->id);
+}
+
+static inline int otherEnd(const DynamicRoute* r, int v) {
+    return r->src == v ? r->dest : r->src;
+}
+
+static unsigned nextGeneration(DynamicRoutes* g) {
+    if (++g->generation == 0) {
+        memset(g->mark, 0, sizeof(unsigned) * (size_t)(g->vertexCount > 0 ? g->vertexCount : 1));
+        g->generation = 1;
+    }
+    return g->generation;
+}
+
+// Turns the path from v up to its root around, making v the root of its tree
+static void reroot(DynamicRoutes* g, int v) {
+    int prev = -1, prevRoute = -1;
+    while (v != -1) {
+        int up = g->parentVertex[v];
+        int upRoute = g->parentRoute[v];
+        g->parentVertex[v] = prev;
+        g->parentRoute[v] = prevRoute;
+        prev = v;
+        prevRoute = upRoute;
+        v = up;
+    }
+}
+
+// Joins two different trees with route id
+static void forestLink(DynamicRoutes* g, int id) {
+    DynamicRoute* r = &g->routes[id];
+    reroot(g, r->src);
+    g->parentVertex[r->src] = r->dest;
+    g->parentRoute[r->src] = id;
+    r->inForest = 1;
+    g->forestEdges++;
+    g->forestWeight += r->weight;
+}
+
+static void forestCut(DynamicRoutes* g, int id) {
+    DynamicRoute* r = &g->routes[id];
+    int child = g->parentRoute[r->src] == id ? r->src : r->dest;
+    g->parentVertex[child] = -1;
+    g->parentRoute[child] = -1;
+    r->inForest = 0;
+    g->forestEdges--;
+    g->forestWeight -= r->weight;
+}
+
+// Heaviest forest edge on the climb from v up to (not past) stop
+static int heaviestUpTo(const DynamicRoutes* g, int v, int stop, int heaviest) {
+    for (; v != stop; v = g->parentVertex[v]) {
+        int e = g->parentRoute[v];
+        if (heaviest == -1 || g->routes[e].weight > g->routes[heaviest].weight) heaviest = e;
+    }
+    return heaviest;
+}
+
+// A live route outside the forest: join two trees, or replace the heaviest
+// edge on the tree path between its endpoints if it is lighter.
+static void forestOffer(DynamicRoutes* g, int id) {
+    const DynamicRoute* r = &g->routes[id];
+    if (r->src == r->dest) return;
+    unsigned gen = nextGeneration(g);
+    for (int v = r->src; v != -1; v = g->parentVertex[v]) g->mark[v] = gen;
+    int meet = r->dest;
+    while (meet != -1 && g->mark[meet] != gen) meet = g->parentVertex[meet];
+    if (meet == -1) {
+        forestLink(g, id);
+        return;
+    }
+    int heaviest = heaviestUpTo(g, r->src, meet, -1);
+    heaviest = heaviestUpTo(g, r->dest, meet, heaviest);
+    if (g->routes[heaviest].weight > r->weight) {
+        forestCut(g, heaviest);
+        forestLink(g, id);
+    }
+}
+
+// Root of v's tree, remembered for every vertex on the climb until the next generation
+static int cachedRoot(DynamicRoutes* g, int v) {
+    unsigned gen = g->generation;
+    int depth = 0;
+    int top = v;
+    while (g->mark[top] != gen && g->parentVertex[top] != -1) {
+        g->stack[depth++] = top;
+        top = g->parentVertex[top];
+    }
+    int root = g->mark[top] == gen ? g->rootOf[top] : top;
+    g->mark[top] = gen;
+    g->rootOf[top] = root;
+    while (depth > 0) {
+        int u = g->stack[--depth];
+        g->mark[u] = gen;
+        g->rootOf[u] = root;
+    }
+    return root;
+}
+
+// Cuts forest edge id and rejoins the two halves with the cheapest live
+// route between them; id itself competes unless it has been removed.
+// Every other route already lies within one tree, so a route crosses the
+// cut exactly when one of its ends sits under the detached half's root.
+static void forestReplace(DynamicRoutes* g, int id) {
+    const DynamicRoute* cut = &g->routes[id];
+    int detached = g->parentRoute[cut->src] == id ? cut->src : cut->dest;
+    forestCut(g, id);
+    nextGeneration(g);
+    int best = -1;
+    for (int i = 0; i < g->routeCount; ++i) {
+        const DynamicRoute* r = &g->routes[i];
+        if (r->removed || r->inForest) continue;
+        if ((cachedRoot(g, r->src) == detached) == (cachedRoot(g, r->dest) == detached)) continue;
+        if (best == -1 || r->weight < g->routes[best].weight) best = i;
+    }
+    if (best != -1) forestLink(g, best);
+}
+
+// Parent pointers for the forest Kruskal picked, by breadth-first search from each tree's lowest vertex
+static int buildForestParents(DynamicRoutes* g) {
+    int n = g->vertexCount;
+    int* start = (int*)calloc((size_t)n + 1, sizeof(int));
+    int* incident = (int*)malloc(sizeof(int) * 2 * (size_t)(g->forestEdges > 0 ? g->forestEdges : 1));
+    if (!start || !incident) {
+        free(start);
+        free(incident);
+        return -1;
+    }
+    for (int i = 0; i < g->routeCount; ++i) {
+        if (!g->routes[i].inForest) continue;
+        start[g->routes[i].src + 1]++;
+        start[g->routes[i].dest + 1]++;
+    }
+    for (int v = 0; v < n; ++v) start[v + 1] += start[v];
+    for (int i = 0; i < g->routeCount; ++i) {
+        if (!g->routes[i].inForest) continue;
+        incident[start[g->routes[i].src]++] = i;
+        incident[start[g->routes[i].dest]++] = i;
+    }
+    // The fill pass moved every start up by one row; shift back
+    for (int v = n; v > 0; --v) start[v] = start[v - 1];
+    start[0] = 0;
+
+    unsigned gen = nextGeneration(g);
+    for (int rootVertex = 0; rootVertex < n; ++rootVertex) {
+        if (g->mark[rootVertex] == gen) continue;
+        int head = 0, tail = 0;
+        g->stack[tail++] = rootVertex;
+        g->mark[rootVertex] = gen;
+        g->parentVertex[rootVertex] = -1;
+        g->parentRoute[rootVertex] = -1;
+        while (head < tail) {
+            int u = g->stack[head++];
+            for (int k = start[u]; k < start[u + 1]; ++k) {
+                int v = otherEnd(&g->routes[incident[k]], u);
+                if (g->mark[v] == gen) continue;
+                g->mark[v] = gen;
+                g->parentVertex[v] = u;
+                g->parentRoute[v] = incident[k];
+                g->stack[tail++] = v;
+            }
+        }
+    }
+    free(start);
+    free(incident);
+    return 0;
+}
+
+int dynamicRoutesInit(DynamicRoutes* g, int vertexCount, const RouteEdge* edges, int edgeCount, int directed) {
+    memset(g, 0, sizeof(*g));
+    g->vertexCount = vertexCount;
+    g->directed = directed ? 1 : 0;
+    g->routeCapacity = edgeCount > 16 ? edgeCount : 16;
+    size_t n = (size_t)(vertexCount > 0 ? vertexCount : 1);
+    g->routes = (DynamicRoute*)malloc(sizeof(DynamicRoute) * (size_t)g->routeCapacity);
+    g->parentVertex = (int*)malloc(sizeof(int) * n);
+    g->parentRoute = (int*)malloc(sizeof(int) * n);
+    g->stack = (int*)malloc(sizeof(int) * n);
+    g->rootOf = (int*)malloc(sizeof(int) * n);
+    g->mark = (unsigned*)calloc(n, sizeof(unsigned));
+    WeightedRoute* order = (WeightedRoute*)malloc(sizeof(WeightedRoute) * (size_t)g->routeCapacity);
+    int* parent = (int*)malloc(sizeof(int) * n);
+    int* rank = (int*)calloc(n, sizeof(int));
+    if (!g->routes || !g->parentVertex || !g->parentRoute || !g->stack || !g->rootOf || !g->mark || !order || !parent ||
+        !rank) {
+        free(order);
+        free(parent);
+        free(rank);
+        dynamicRoutesFree(g);
+        return -1;
+    }
+    for (int v = 0; v < vertexCount; ++v) parent[v] = v;
+    for (int i = 0; i < edgeCount; ++i) {
+        DynamicRoute* r = &g->routes[i];
+        r->src = edges[i].src;
+        r->dest = edges[i].dest;
+        r->weight = edges[i].weight;
+        r->inForest = 0;
+        r->removed = 0;
+        order[i].weight = edges[i].weight;
+        order[i].id = i;
+    }
+    g->routeCount = edgeCount;
+    g->liveRoutes = edgeCount;
+
+    // Kruskal once up front; every later change is applied to the forest in place
+    qsort(order, (size_t)edgeCount, sizeof(WeightedRoute), compareWeightedRoutes);
+    for (int i = 0; i < edgeCount && g->forestEdges < vertexCount - 1; ++i) {
+        const DynamicRoute* r = &g->routes[order[i].id];
+        if (!disjointSetUnion(parent, rank, r->src, r->dest)) continue;
+        g->routes[order[i].id].inForest = 1;
+        g->forestEdges++;
+        g->forestWeight += r->weight;
+    }
+    free(order);
+    free(parent);
+    free(rank);
+    g->csrStale = 1;
+    if (buildForestParents(g) != 0) {
+        dynamicRoutesFree(g);
+        return -1;
+    }
+    return 0;
+}
+
+void dynamicRoutesFree(DynamicRoutes* g) {
+    free(g->routes);
+    free(g->parentVertex);
+    free(g->parentRoute);
+    free(g->stack);
+    free(g->rootOf);
+    free(g->mark);
+    free(g->affected);
+    free(g->repair);
+    free(g->oldFromSrc);
+    free(g->oldFromDest);
+    if (g->hasDistances) {
+        distanceMatrixFree(&g->dist);
+        indexedHeapFree(&g->heap);
+    }
+    if (!g->csrStale) {
+        freeCsrGraph(&g->csr);
+        if (g->directed) freeCsrGraph(&g->reverse);
+    }
+    memset(g, 0, sizeof(*g));
+}
+
+static int rebuildCsr(DynamicRoutes* g) {
+    if (!g->csrStale) return 0;
+    RouteEdge* live = (RouteEdge*)malloc(sizeof(RouteEdge) * (size_t)(g->liveRoutes > 0 ? g->liveRoutes : 1));
+    if (!live) return -1;
+    int count = 0;
+    for (int i = 0; i < g->routeCount; ++i) {
+        const DynamicRoute* r = &g->routes[i];
+        if (r->removed) continue;
+        live[count].src = r->src;
+        live[count].dest = r->dest;
+        live[count].weight = r->weight;
+        count++;
+    }
+    int status = buildCsrGraph(&g->csr, g->vertexCount, live, count, g->directed);
+    free(live);
+    if (status != 0) return -1;
+    if (g->directed && buildReverseCsrGraph(&g->reverse, &g->csr) != 0) {
+        freeCsrGraph(&g->csr);
+        return -1;
+    }
+    g->csrStale = 0;
+    return 0;
+}
+
+static void markCsrStale(DynamicRoutes* g) {
+    if (g->csrStale) return;
+    freeCsrGraph(&g->csr);
+    if (g->directed) freeCsrGraph(&g->reverse);
+    g->csrStale = 1;
+}
+
+int dynamicRoutesTrackDistances(DynamicRoutes* g, DistanceMatrix* initial) {
+    if (g->hasDistances) return 0;
+    size_t n = (size_t)(g->vertexCount > 0 ? g->vertexCount : 1);
+    g->affected = (int*)malloc(sizeof(int) * n);
+    g->repair = (int*)malloc(sizeof(int) * n);
+    g->oldFromSrc = (double*)malloc(sizeof(double) * n);
+    g->oldFromDest = (double*)malloc(sizeof(double) * n);
+    if (!g->affected || !g->repair || !g->oldFromSrc || !g->oldFromDest || indexedHeapInit(&g->heap, g->vertexCount) != 0) {
+        free(g->affected);
+        free(g->repair);
+        free(g->oldFromSrc);
+        free(g->oldFromDest);
+        g->affected = g->repair = NULL;
+        g->oldFromSrc = g->oldFromDest = NULL;
+        return -1;
+    }
+    if (initial) {
+        g->dist = *initial;
+    } else if (distanceMatrixInit(&g->dist, g->vertexCount) != 0 || rebuildCsr(g) != 0) {
+        if (g->dist.data) distanceMatrixFree(&g->dist);
+        indexedHeapFree(&g->heap);
+        return -1;
+    } else {
+        for (int s = 0; s < g->vertexCount; ++s) {
+            dijkstraCsrWithHeap(&g->csr, s, distanceMatrixRow(&g->dist, s), &g->heap);
+        }
+    }
+    g->hasDistances = 1;
+    return 0;
+}
+
+/*
+ * Arc u->v became available at weight w. A pair (i, j) can only improve
+ * through it if i reaches v cheaper via u and u reaches j cheaper via v,
+ * so the rows and columns that pass both tests are the only ones touched.
+ */
+static void relaxThroughArc(DynamicRoutes* g, int u, int v, double w) {
+    int n = g->vertexCount;
+    const double* fromU = distanceMatrixRow(&g->dist, u);
+    const double* fromV = distanceMatrixRow(&g->dist, v);
+    int* columns = g->affected;
+    int columnCount = 0;
+    for (int j = 0; j < n; ++j) {
+        if (w + fromV[j] < fromU[j]) columns[columnCount++] = j;
+    }
+    if (columnCount == 0) return;
+    // Past a quarter of the row a straight min over it vectorises better than the gather
+    int denseRows = columnCount * 4 > n;
+    for (int i = 0; i < n; ++i) {
+        double* row = distanceMatrixRow(&g->dist, i);
+        double base = row[u] + w;
+        if (base >= row[v]) continue;
+        if (denseRows) {
+            for (int j = 0; j < n; ++j) {
+                double alt = base + fromV[j];
+                row[j] = alt < row[j] ? alt : row[j];
+            }
+        } else {
+            for (int k = 0; k < columnCount; ++k) {
+                int j = columns[k];
+                double alt = base + fromV[j];
+                if (alt < row[j]) row[j] = alt;
+            }
+        }
+    }
+}
+
+static void distancesRouteCheaper(DynamicRoutes* g, const DynamicRoute* r) {
+    if (!g->hasDistances || r->src == r->dest) return;
+    relaxThroughArc(g, r->src, r->dest, r->weight);
+    if (!g->directed) relaxThroughArc(g, r->dest, r->src, r->weight);
+}
+
+static inline int arcIsTight(double toU, double w, double fromV, double toTarget) {
+    if (toU >= INF_WEIGHT / 2.0 || fromV >= INF_WEIGHT / 2.0) return 0;
+    double through = toU + w + fromV;
+    return through <= toTarget + TIGHT_PATH_TOLERANCE * through;
+}
+
+/*
+ * Row s after route r (weight oldWeight before the change) got dearer or
+ * went away. Targets whose shortest path could have used the route are
+ * cleared and re-settled by a Dijkstra that starts from their cheapest
+ * arcs in from the rest of the row, which is unchanged.
+ */
+static void repairRow(DynamicRoutes* g, int s, const DynamicRoute* r, double oldWeight) {
+    int n = g->vertexCount;
+    double* row = distanceMatrixRow(&g->dist, s);
+    double toSrc = row[r->src], toDest = row[r->dest];
+    unsigned gen = nextGeneration(g);
+    int count = 0;
+    for (int j = 0; j < n; ++j) {
+        if (arcIsTight(toSrc, oldWeight, g->oldFromDest[j], row[j]) ||
+            (!g->directed && arcIsTight(toDest, oldWeight, g->oldFromSrc[j], row[j]))) {
+            g->repair[count++] = j;
+            g->mark[j] = gen;
+        }
+    }
+    for (int k = 0; k < count; ++k) row[g->repair[k]] = INF_WEIGHT;
+    const CsrGraph* in = g->directed ? &g->reverse : &g->csr;
+    for (int k = 0; k < count; ++k) {
+        int j = g->repair[k];
+        double best = j == s ? 0.0 : INF_WEIGHT;
+        for (int a = in->rowStart[j]; a < in->rowStart[j + 1]; ++a) {
+            int x = in->target[a];
+            if (g->mark[x] == gen) continue;
+            double alt = row[x] + in->weight[a];
+            if (alt < best) best = alt;
+        }
+        if (best < INF_WEIGHT) {
+            row[j] = best;
+            indexedHeapPushOrDecrease(&g->heap, j, best);
+        }
+    }
+    const CsrGraph* out = &g->csr;
+    double du;
+    int u;
+    while ((u = indexedHeapPop(&g->heap, &du)) != -1) {
+        for (int a = out->rowStart[u]; a < out->rowStart[u + 1]; ++a) {
+            int v = out->target[a];
+            if (g->mark[v] != gen) continue;
+            double alt = du + out->weight[a];
+            if (alt < row[v]) {
+                row[v] = alt;
+                indexedHeapPushOrDecrease(&g->heap, v, alt);
+            }
+        }
+    }
+    g->targetsRepaired += count;
+}
+
+// Route r lost weight oldWeight (now dearer or gone): only sources that
+// could have been routing over it are repaired.
+static int distancesRouteDearer(DynamicRoutes* g, const DynamicRoute* r, double oldWeight) {
+    if (!g->hasDistances || r->src == r->dest) return 0;
+    int count = 0;
+    for (int i = 0; i < g->vertexCount; ++i) {
+        const double* row = distanceMatrixRow(&g->dist, i);
+        if (arcIsTight(row[r->src], oldWeight, 0.0, row[r->dest]) ||
+            (!g->directed && arcIsTight(row[r->dest], oldWeight, 0.0, row[r->src]))) {
+            g->affected[count++] = i;
+        }
+    }
+    if (count == 0) return 0;
+    if (rebuildCsr(g) != 0) return -1;
+    size_t rowBytes = sizeof(double) * (size_t)g->vertexCount;
+    memcpy(g->oldFromSrc, distanceMatrixRow(&g->dist, r->src), rowBytes);
+    memcpy(g->oldFromDest, distanceMatrixRow(&g->dist, r->dest), rowBytes);
+    for (int k = 0; k < count; ++k) repairRow(g, g->affected[k], r, oldWeight);
+    g->rowsRepaired += count;
+    return 0;
+}
+
+// NaN would fail every comparison the forest and distance repairs make
+static int validWeight(double weight) {
+    return isfinite(weight) && weight >= 0;
+}
+
+int dynamicRoutesAdd(DynamicRoutes* g, int src, int dest, double weight) {
+    if (src < 0 || dest < 0 || src >= g->vertexCount || dest >= g->vertexCount || !validWeight(weight)) return -1;
+    if (g->routeCount == g->routeCapacity) {
+        int capacity = g->routeCapacity * 2;
+        DynamicRoute* routes = (DynamicRoute*)realloc(g->routes, sizeof(DynamicRoute) * (size_t)capacity);
+        if (!routes) return -1;
+        g->routes = routes;
+        g->routeCapacity = capacity;
+    }
+    int id = g->routeCount++;
+    DynamicRoute* r = &g->routes[id];
+    r->src = src;
+    r->dest = dest;
+    r->weight = weight;
+    r->inForest = 0;
+    r->removed = 0;
+    g->liveRoutes++;
+    markCsrStale(g);
+    forestOffer(g, id);
+    distancesRouteCheaper(g, r);
+    return id;
+}
+
+int dynamicRoutesRemove(DynamicRoutes* g, int route) {
+    if (route < 0 || route >= g->routeCount || g->routes[route].removed) return -1;
+    DynamicRoute* r = &g->routes[route];
+    r->removed = 1;
+    g->liveRoutes--;
+    markCsrStale(g);
+    if (r->inForest) forestReplace(g, route);
+    return distancesRouteDearer(g, r, r->weight) == 0 ? route : -1;
+}
+
+int dynamicRoutesReprice(DynamicRoutes* g, int route, double weight) {
+    if (route < 0 || route >= g->routeCount || g->routes[route].removed || !validWeight(weight)) return -1;
+    DynamicRoute* r = &g->routes[route];
+    double oldWeight = r->weight;
+    if (weight == oldWeight) return route;
+    if (r->inForest) g->forestWeight += weight - oldWeight;
+    r->weight = weight;
+    markCsrStale(g);
+    if (weight < oldWeight) {
+        // A cheaper forest edge stays optimal; a cheaper outside route may now belong in it
+        if (!r->inForest) forestOffer(g, route);
+        distancesRouteCheaper(g, r);
+        return route;
+    }
+    if (r->inForest) forestReplace(g, route);
+    return distancesRouteDearer(g, r, oldWeight) == 0 ? route : -1;
+}
+
+int dynamicRoutesFind(const DynamicRoutes* g, int src, int dest) {
+    int best = -1;
+    for (int i = 0; i < g->routeCount; ++i) {
+        const DynamicRoute* r = &g->routes[i];
+        if (r->removed) continue;
+        int match = (r->src == src && r->dest == dest) || (!g->directed && r->src == dest && r->dest == src);
+        if (match && (best == -1 || r->weight < g->routes[best].weight)) best = i;
+    }
+    return best;
+}
+
+int dynamicRoutesForest(const DynamicRoutes* g, MSTResultEdge* out) {
+    int count = 0;
+    for (int i = 0; i < g->routeCount; ++i) {
+        const DynamicRoute* r = &g->routes[i];
+        if (!r->inForest) continue;
+        out[count].src = r->src;
+        out[count].dest = r->dest;
+        out[count].weight = r->weight;
+        count++;
+    }
+    return count;
+}
@@ -0,0 +1,94 @@
+#ifndef ROUTEUPDATE_H
+#define ROUTEUPDATE_H
+
+#include "apsp.h"
+#include "routegraph.h"
+
+typedef struct {
+    int src;
+    int dest;
+    double weight;
+    int inForest; // bool: currently an edge of the spanning forest
+    int removed;  // bool: cancelled; the id is never reused
+} DynamicRoute;
+
+/*
+ * Route network that keeps its minimum spanning forest, and optionally
+ * its all-pairs distances, current as single routes are added, cancelled
+ * or repriced, instead of re-sorting every edge and rerunning APSP.
+ *
+ * Forest (routes always treated as two-way, as Prim and Kruskal do), kept
+ * as parent pointers so tree paths are found by climbing, O(depth):
+ *   add / cheaper    swap out the heaviest edge on the tree path between
+ *                    the endpoints if the new route is lighter
+ *   cancel / dearer  a forest edge splits its tree; the cheapest
+ *                    remaining route across the cut, O(E), rejoins it
+ * Distances (follow route direction when the network is directed):
+ *   add / cheaper    every pair relaxed through the one changed arc, only
+ *                    over rows and columns it can improve, O(V^2) worst
+ *   cancel / dearer  for each source that routed over the arc, only the
+ *                    targets reached through it are re-settled, by a
+ *                    Dijkstra seeded from their unaffected neighbours
+ *
+ * Vertex ids are fixed at init; route ids are stable for the lifetime.
+ */
+typedef struct {
+    int vertexCount;
+    int directed;
+    DynamicRoute* routes;
+    int routeCount; // including removed ones
+    int routeCapacity;
+    int liveRoutes;
+
+    // Forest as parent pointers; roots have parentVertex -1
+    int* parentVertex;
+    int* parentRoute; // route joining a vertex to its parent
+    int forestEdges;
+    double forestWeight;
+
+    // Scratch for tree walks and row repairs, reset by generation
+    int* stack;
+    int* rootOf;
+    unsigned* mark;
+    unsigned generation;
+
+    // All-pairs distances, only once dynamicRoutesTrackDistances() succeeded
+    DistanceMatrix dist;
+    int hasDistances;
+    CsrGraph csr; // live routes, rebuilt lazily for row repairs
+    CsrGraph reverse; // arcs into each vertex; only built for directed networks
+    int csrStale;
+    IndexedHeap heap;
+    int* affected;
+    int* repair;
+    double* oldFromSrc; // rows of the changed route's endpoints before a repair
+    double* oldFromDest;
+    long rowsRepaired;     // sources re-settled since init, for reporting
+    long targetsRepaired;  // and the targets within them
+} DynamicRoutes;
+
+// Builds the initial forest with Kruskal. Returns 0 or -1 on allocation failure.
+int dynamicRoutesInit(DynamicRoutes* g, int vertexCount, const RouteEdge* edges, int edgeCount, int directed);
+void dynamicRoutesFree(DynamicRoutes* g);
+
+// Starts maintaining all-pairs distances. initial (may be NULL) must hold the
+// current distances and is taken over; otherwise they are computed here.
+int dynamicRoutesTrackDistances(DynamicRoutes* g, DistanceMatrix* initial);
+
+// Each returns the affected route id, or -1 on bad arguments (including a negative
+// or non-finite weight) or allocation failure.
+int dynamicRoutesAdd(DynamicRoutes* g, int src, int dest, double weight);
+int dynamicRoutesRemove(DynamicRoutes* g, int route);
+int dynamicRoutesReprice(DynamicRoutes* g, int route, double weight);
+
+// Cheapest live src->dest route (either direction when undirected), or -1.
+int dynamicRoutesFind(const DynamicRoutes* g, int src, int dest);
+
+static inline double dynamicRoutesDistance(const DynamicRoutes* g, int src, int dest) {
+    return distanceMatrixRow(&g->dist, src)[dest];
+}
+
+// Copies the forest edges into out (room for vertexCount - 1); returns the count.
+int dynamicRoutesForest(const DynamicRoutes* g, MSTResultEdge* out);
+
+#endif // ROUTEUPDATE_H
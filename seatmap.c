@@ -0,0 +1,233 @@
+#include "seatmap.h"
+#include <ctype.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define SEAT_LANE_BITS 16
+#define SEAT_ROWS_PER_ZONE 4
+#define SEAT_MAX_PER_ROW 10
+#define SEAT_NARROW_BODY_MAX 240
+
+struct SeatLayout {
+    int seatsPerRow;
+    int widestBlock; // most seats between two aisles
+    const char* letters;
+    uint8_t position[SEAT_MAX_PER_ROW]; // bit of each letter within the row's lane
+    uint16_t seats;                     // lane bits that are seats; the gaps are aisles
+    uint16_t window;
+    uint16_t aisle;
+};
+
+static const SeatLayout NARROW_BODY = { 6, 3, "ABCDEF", { 0, 1, 2, 4, 5, 6 }, 0x0077, 0x0041, 0x0014 };
+static const SeatLayout WIDE_BODY = { 10, 4, "ABCDEFGHJK", { 0, 1, 2, 4, 5, 6, 7, 9, 10, 11 }, 0x0EF7, 0x0801, 0x0294 };
+
+static uint64_t everyLane(uint16_t lane) {
+    return (uint64_t)lane * 0x0001000100010001ull;
+}
+
+// Bits of zone holding rows in [firstRow, endRow)
+static uint64_t rowMask(size_t zone, int firstRow, int endRow) {
+    int base = (int)zone * SEAT_ROWS_PER_ZONE;
+    int lo = firstRow > base ? firstRow - base : 0;
+    int hi = endRow - base < SEAT_ROWS_PER_ZONE ? endRow - base : SEAT_ROWS_PER_ZONE;
+    if (hi <= lo) return 0;
+    uint64_t below = hi == SEAT_ROWS_PER_ZONE ? ~0ull : (1ull << (hi * SEAT_LANE_BITS)) - 1;
+    return below & ~((1ull << (lo * SEAT_LANE_BITS)) - 1);
+}
+
+static void cabinRows(const SeatMap* map, SeatCabin cabin, int* firstRow, int* endRow) {
+    *firstRow = cabin == SEAT_CABIN_ECONOMY ? map->businessRows : 0;
+    *endRow = cabin == SEAT_CABIN_BUSINESS ? map->businessRows : map->rows;
+}
+
+// Letter index of a lane position: the seats below it
+static int letterAt(const SeatLayout* layout, int position) {
+    return __builtin_popcount(layout->seats & ((1u << position) - 1));
+}
+
+static int seatAt(const SeatMap* map, size_t zone, int bit) {
+    int row = (int)zone * SEAT_ROWS_PER_ZONE + bit / SEAT_LANE_BITS;
+    return row * map->layout->seatsPerRow + letterAt(map->layout, bit % SEAT_LANE_BITS);
+}
+
+static int seatBit(const SeatMap* map, int seat, size_t* zone, int* bit) {
+    if (seat < 0 || seat >= map->capacity) return -1;
+    int row = seat / map->layout->seatsPerRow;
+    *zone = (size_t)(row / SEAT_ROWS_PER_ZONE);
+    *bit = row % SEAT_ROWS_PER_ZONE * SEAT_LANE_BITS + map->layout->position[seat % map->layout->seatsPerRow];
+    return 0;
+}
+
+// Clears the zone's summary bit, then puts it back if a release slipped in between
+static void markSoldOut(SeatMap* map, size_t zone) {
+    uint64_t bit = 1ull << (zone % 64);
+    atomic_fetch_and(&map->summary[zone / 64], ~bit);
+    if (atomic_load(&map->zones[zone]) != 0) atomic_fetch_or(&map->summary[zone / 64], bit);
+}
+
+int seatMapInit(SeatMap* map, int capacity) {
+    memset(map, 0, sizeof(*map));
+    if (capacity < 0) capacity = 0;
+    const SeatLayout* layout = capacity > SEAT_NARROW_BODY_MAX ? &WIDE_BODY : &NARROW_BODY;
+    int rows = (capacity + layout->seatsPerRow - 1) / layout->seatsPerRow;
+    size_t zoneCount = ((size_t)rows + SEAT_ROWS_PER_ZONE - 1) / SEAT_ROWS_PER_ZONE;
+    size_t summaryCount = (zoneCount + 63) / 64;
+    map->zones = (atomic_ullong*)calloc(zoneCount ? zoneCount : 1, sizeof(atomic_ullong));
+    map->summary = (atomic_ullong*)calloc(summaryCount ? summaryCount : 1, sizeof(atomic_ullong));
+    if (!map->zones || !map->summary) {
+        seatMapFree(map);
+        return -1;
+    }
+    for (int row = 0; row < rows; ++row) {
+        int seats = capacity - row * layout->seatsPerRow;
+        if (seats > layout->seatsPerRow) seats = layout->seatsPerRow;
+        uint64_t lane = 0;
+        for (int s = 0; s < seats; ++s) lane |= 1ull << layout->position[s];
+        size_t zone = (size_t)(row / SEAT_ROWS_PER_ZONE);
+        atomic_fetch_or_explicit(&map->zones[zone], lane << (row % SEAT_ROWS_PER_ZONE * SEAT_LANE_BITS),
+                                 memory_order_relaxed);
+        atomic_fetch_or_explicit(&map->summary[zone / 64], 1ull << (zone % 64), memory_order_relaxed);
+    }
+    map->layout = layout;
+    map->capacity = capacity;
+    map->rows = rows;
+    map->businessRows = rows / 10;
+    map->zoneCount = zoneCount;
+    return 0;
+}
+
+void seatMapFree(SeatMap* map) {
+    free(map->zones);
+    free(map->summary);
+    memset(map, 0, sizeof(*map));
+}
+
+int seatMapClaim(SeatMap* map, int seat) {
+    size_t zone;
+    int bit;
+    if (seatBit(map, seat, &zone, &bit) != 0) return -1;
+    uint64_t mask = 1ull << bit;
+    uint64_t before = atomic_fetch_and(&map->zones[zone], ~mask);
+    if (!(before & mask)) return -1;
+    if ((before & ~mask) == 0) markSoldOut(map, zone);
+    return 0;
+}
+
+void seatMapRelease(SeatMap* map, int seat) {
+    size_t zone;
+    int bit;
+    if (seatBit(map, seat, &zone, &bit) != 0) return;
+    atomic_fetch_or(&map->zones[zone], 1ull << bit);
+    atomic_fetch_or(&map->summary[zone / 64], 1ull << (zone % 64));
+}
+
+/*
+ * Takes the frontmost run of count free seats in rows [firstRow, endRow)
+ * starting at one of the starts bits. Zones come from the summary in
+ * order; within a zone the run's start bits are free & free>>1 & ...,
+ * and a lost CAS retries the same zone with the value it saw.
+ */
+static int claimRun(SeatMap* map, int firstRow, int endRow, uint64_t starts, int count) {
+    if (firstRow >= endRow) return -1;
+    size_t firstZone = (size_t)firstRow / SEAT_ROWS_PER_ZONE;
+    size_t endZone = (size_t)(endRow - 1) / SEAT_ROWS_PER_ZONE + 1;
+    uint64_t runBits = (1ull << count) - 1;
+    for (size_t s = firstZone / 64; s * 64 < endZone; ++s) {
+        uint64_t candidates = atomic_load_explicit(&map->summary[s], memory_order_acquire);
+        while (candidates) {
+            size_t zone = s * 64 + (size_t)__builtin_ctzll(candidates);
+            candidates &= candidates - 1;
+            if (zone < firstZone) continue;
+            if (zone >= endZone) return -1;
+            uint64_t allowed = starts & rowMask(zone, firstRow, endRow);
+            uint64_t free = atomic_load_explicit(&map->zones[zone], memory_order_relaxed);
+            for (;;) {
+                uint64_t run = free & allowed;
+                for (int i = 1; i < count && run; ++i) run &= free >> i;
+                if (!run) break;
+                int bit = __builtin_ctzll(run);
+                uint64_t taken = runBits << bit;
+                if (atomic_compare_exchange_weak_explicit(&map->zones[zone], &free, free & ~taken, memory_order_acq_rel,
+                                                          memory_order_relaxed)) {
+                    if ((free & ~taken) == 0) markSoldOut(map, zone);
+                    return seatAt(map, zone, bit);
+                }
+            }
+        }
+    }
+    return -1;
+}
+
+int seatMapClaimFirst(SeatMap* map, SeatCabin cabin, SeatPreference pref) {
+    if (!map->layout) return -1;
+    const SeatLayout* layout = map->layout;
+    uint16_t lane = pref == SEAT_PREF_WINDOW ? layout->window : pref == SEAT_PREF_AISLE ? layout->aisle : layout->seats;
+    int firstRow, endRow;
+    cabinRows(map, cabin, &firstRow, &endRow);
+    return claimRun(map, firstRow, endRow, everyLane(lane), 1);
+}
+
+int seatMapClaimAdjacent(SeatMap* map, SeatCabin cabin, int count) {
+    if (!map->layout || count < 1 || count > map->layout->widestBlock) return -1;
+    int firstRow, endRow;
+    cabinRows(map, cabin, &firstRow, &endRow);
+    return claimRun(map, firstRow, endRow, everyLane(map->layout->seats), count);
+}
+
+int seatMapFreeSeats(const SeatMap* map, SeatCabin cabin) {
+    if (!map->layout) return 0;
+    int firstRow, endRow;
+    cabinRows(map, cabin, &firstRow, &endRow);
+    if (firstRow >= endRow) return 0;
+    int free = 0;
+    size_t endZone = (size_t)(endRow - 1) / SEAT_ROWS_PER_ZONE + 1;
+    for (size_t zone = (size_t)firstRow / SEAT_ROWS_PER_ZONE; zone < endZone; ++zone) {
+        uint64_t bits = atomic_load_explicit(&map->zones[zone], memory_order_relaxed);
+        free += __builtin_popcountll(bits & rowMask(zone, firstRow, endRow));
+    }
+    return free;
+}
+
+int seatMapSeatsPerRow(const SeatMap* map) {
+    return map->layout ? map->layout->seatsPerRow : 0;
+}
+
+SeatCabin seatMapCabinOf(const SeatMap* map, int seat) {
+    return seat / map->layout->seatsPerRow < map->businessRows ? SEAT_CABIN_BUSINESS : SEAT_CABIN_ECONOMY;
+}
+
+void seatMapLabel(const SeatMap* map, int seat, char* out) {
+    if (seat < 0 || seat >= map->capacity) {
+        strcpy(out, "-");
+        return;
+    }
+    int perRow = map->layout->seatsPerRow;
+    snprintf(out, SEAT_LABEL_LEN, "%d%c", seat / perRow + 1, map->layout->letters[seat % perRow]);
+}
+
+int seatMapParse(const SeatMap* map, const char* label) {
+    if (!map->layout || !isdigit((unsigned char)label[0])) return -1;
+    char* end;
+    long row = strtol(label, &end, 10);
+    if (row < 1 || row > map->rows || end[0] == '\0' || end[1] != '\0') return -1;
+    const char* letter = strchr(map->layout->letters, toupper((unsigned char)end[0]));
+    if (!letter) return -1;
+    long seat = (row - 1) * map->layout->seatsPerRow + (letter - map->layout->letters);
+    return seat < map->capacity ? (int)seat : -1;
+}
+
+void seatMapRowText(const SeatMap* map, int row, char* out) {
+    const SeatLayout* layout = map->layout;
+    size_t zone = (size_t)(row / SEAT_ROWS_PER_ZONE);
+    uint16_t lane = (uint16_t)(atomic_load_explicit(&map->zones[zone], memory_order_relaxed) >>
+                               (row % SEAT_ROWS_PER_ZONE * SEAT_LANE_BITS));
+    int n = 0;
+    for (int position = 0; layout->seats >> position; ++position) {
+        int letter = letterAt(layout, position);
+        if (!(layout->seats >> position & 1) || row * layout->seatsPerRow + letter >= map->capacity) out[n++] = ' ';
+        else out[n++] = lane >> position & 1 ? layout->letters[letter] : '.';
+    }
+    out[n] = '\0';
+}
@@ -0,0 +1,73 @@
+#ifndef SEATMAP_H
+#define SEATMAP_H
+
+#include <stdatomic.h>
+#include <stddef.h>
+
+/*
+ * Per-flight seat map as a bitset, 1 = free. Each row is a 16-bit lane
+ * with seats at fixed positions and a zero bit at every aisle, and four
+ * rows pack into one 64-bit word, the map's zone. "First free window
+ * seat" is a mask and a ctz per zone; "N adjacent seats" ANDs a zone with
+ * itself shifted N-1 times, and the aisle and lane gaps keep runs from
+ * spanning an aisle or a row. A summary word holds one bit per zone that
+ * may still have a free seat, so searches skip sold-out zones 64 at a
+ * time. Claims clear bits with a CAS and releases set them, so any number
+ * of threads can allocate from one map without a lock.
+ *
+ * Layout follows capacity: six abreast (ABC DEF) up to 240 seats, ten
+ * abreast (ABC DEFG HJK) above. The front tenth of the rows is the
+ * business cabin. Seats are numbered row * seats-per-row + letter.
+ */
+
+#define SEAT_LABEL_LEN 16     // row number and letter
+#define SEAT_ROW_TEXT_LEN 24  // one lane of seat letters, '.' for taken, ' ' at aisles
+#define SEAT_BLOCK_MAX 4      // most seats side by side between aisles, in any layout
+
+typedef enum {
+    SEAT_CABIN_ANY = -1,
+    SEAT_CABIN_BUSINESS = 0,
+    SEAT_CABIN_ECONOMY
+} SeatCabin;
+
+typedef enum {
+    SEAT_PREF_ANY = 0,
+    SEAT_PREF_WINDOW,
+    SEAT_PREF_AISLE
+} SeatPreference;
+
+typedef struct SeatLayout SeatLayout;
+
+typedef struct {
+    atomic_ullong* zones;   // four rows each, 1 = free
+    atomic_ullong* summary; // bit z set while zone z may have a free seat
+    const SeatLayout* layout;
+    int capacity;
+    int rows;
+    int businessRows;
+    size_t zoneCount;
+} SeatMap;
+
+// Returns 0, or -1 on allocation failure. Every seat starts free.
+int seatMapInit(SeatMap* map, int capacity);
+void seatMapFree(SeatMap* map);
+
+// Takes that seat; returns 0, or -1 if it is taken or does not exist.
+int seatMapClaim(SeatMap* map, int seat);
+void seatMapRelease(SeatMap* map, int seat);
+// Takes the frontmost free seat matching cabin and preference; returns it, or -1.
+int seatMapClaimFirst(SeatMap* map, SeatCabin cabin, SeatPreference pref);
+// Takes count seats side by side in one row, with no aisle between; returns the first (the rest follow it), or -1.
+int seatMapClaimAdjacent(SeatMap* map, SeatCabin cabin, int count);
+
+int seatMapFreeSeats(const SeatMap* map, SeatCabin cabin);
+int seatMapSeatsPerRow(const SeatMap* map);
+SeatCabin seatMapCabinOf(const SeatMap* map, int seat);
+// Writes "12A"; out needs SEAT_LABEL_LEN bytes.
+void seatMapLabel(const SeatMap* map, int seat, char* out);
+// Seat number of a label like "12A", or -1.
+int seatMapParse(const SeatMap* map, const char* label);
+// Writes one row for display; out needs SEAT_ROW_TEXT_LEN bytes.
+void seatMapRowText(const SeatMap* map, int row, char* out);
+
+#endif // SEATMAP_H
@@ -0,0 +1,49 @@
+#include "secondaryindex.h"
+#include <stdlib.h>
+#include <string.h>
+
+static int growInts(int32_t** array, size_t oldSize, size_t newSize, int fill) {
+    int32_t* grown = (int32_t*)realloc(*array, sizeof(int32_t) * newSize);
+    if (!grown) return -1;
+    for (size_t i = oldSize; i < newSize; ++i) grown[i] = fill;
+    *array = grown;
+    return 0;
+}
+
+static int reserveKeys(SecondaryIndex* index, size_t keys) {
+    if (keys <= index->keyCapacity) return 0;
+    size_t capacity = index->keyCapacity ? index->keyCapacity : 64;
+    while (capacity < keys) capacity *= 2;
+    if (growInts(&index->head, index->keyCapacity, capacity, -1) != 0 ||
+        growInts(&index->tail, index->keyCapacity, capacity, -1) != 0 ||
+        growInts(&index->count, index->keyCapacity, capacity, 0) != 0) {
+        return -1; // arrays grown so far keep their contents; keyCapacity still describes all three
+    }
+    index->keyCapacity = capacity;
+    return 0;
+}
+
+int secondaryIndexAppend(SecondaryIndex* index, int key) {
+    if (key < 0 || reserveKeys(index, (size_t)key + 1) != 0) return -1;
+    size_t record = (size_t)index->indexedCount;
+    if (record >= index->recordCapacity) {
+        size_t capacity = index->recordCapacity ? index->recordCapacity * 2 : 1024;
+        if (growInts(&index->next, index->recordCapacity, capacity, -1) != 0) return -1;
+        index->recordCapacity = capacity;
+    }
+    index->next[record] = -1;
+    if (index->tail[key] == -1) index->head[key] = (int32_t)record;
+    else index->next[index->tail[key]] = (int32_t)record;
+    index->tail[key] = (int32_t)record;
+    index->count[key]++;
+    index->indexedCount++;
+    return 0;
+}
+
+void secondaryIndexFree(SecondaryIndex* index) {
+    free(index->head);
+    free(index->tail);
+    free(index->count);
+    free(index->next);
+    memset(index, 0, sizeof(*index));
+}
@@ -0,0 +1,43 @@
+#ifndef SECONDARYINDEX_H
+#define SECONDARYINDEX_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+/*
+ * One-to-many index from a dense key (flight index, airport id, ...) to
+ * the records carrying it, as an intrusive chain per key: head/tail per
+ * key, next per record. Records are appended in store order, so every
+ * chain lists its records in insertion order, appending is O(1), and
+ * walking one key costs O(records on that key) with no scan of the
+ * store. indexedCount is how far into the store the index has got.
+ */
+typedef struct {
+    int32_t* head; // first record per key, -1 if none
+    int32_t* tail;
+    int32_t* count; // records per key
+    size_t keyCapacity;
+    int32_t* next; // next record with the same key, -1 at the end
+    size_t recordCapacity;
+    int indexedCount;
+} SecondaryIndex;
+
+#define SECONDARY_INDEX_INIT { NULL, NULL, NULL, 0, NULL, 0, 0 }
+
+// Adds record number indexedCount under key. Returns 0, or -1 on allocation failure.
+int secondaryIndexAppend(SecondaryIndex* index, int key);
+void secondaryIndexFree(SecondaryIndex* index);
+
+static inline int secondaryIndexFirst(const SecondaryIndex* index, int key) {
+    return key >= 0 && (size_t)key < index->keyCapacity ? index->head[key] : -1;
+}
+
+static inline int secondaryIndexNext(const SecondaryIndex* index, int record) {
+    return index->next[record];
+}
+
+static inline int secondaryIndexCount(const SecondaryIndex* index, int key) {
+    return key >= 0 && (size_t)key < index->keyCapacity ? index->count[key] : 0;
+}
+
+#endif // SECONDARYINDEX_H
@@ -0,0 +1,487 @@
+#include "spanningtree.h"
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define RADIX_BITS 8
+#define RADIX_BUCKETS (1 << RADIX_BITS)
+#define RADIX_PASSES (64 / RADIX_BITS)
+#define PIVOT_SAMPLES 63
+
+int disjointSetFind(int* parent, int v) {
+    while (parent[v] != v) {
+        parent[v] = parent[parent[v]];
+        v = parent[v];
+    }
+    return v;
+}
+
+int disjointSetUnion(int* parent, int* rank, int a, int b) {
+    a = disjointSetFind(parent, a);
+    b = disjointSetFind(parent, b);
+    if (a == b) return 0;
+    if (rank[a] < rank[b]) {
+        parent[a] = b;
+    } else if (rank[a] > rank[b]) {
+        parent[b] = a;
+    } else {
+        parent[b] = a;
+        rank[a]++;
+    }
+    return 1;
+}
+
+// Order-preserving map from double to unsigned: flip negatives, set the sign bit on the rest
+static inline uint64_t weightKey(double weight) {
+    uint64_t bits;
+    memcpy(&bits, &weight, sizeof(bits));
+    return (bits >> 63) ? ~bits : bits | 0x8000000000000000ull;
+}
+
+typedef struct {
+    const RouteEdge* from;
+    RouteEdge* to;
+    int count;
+    int blockSize;
+    int shift;
+    size_t* buckets; // RADIX_BUCKETS per block: counts, then next write slot
+} RadixPass;
+
+static void radixHistogram(void* ctx, long block, int worker) {
+    (void)worker;
+    RadixPass* pass = (RadixPass*)ctx;
+    size_t* counts = &pass->buckets[(size_t)block * RADIX_BUCKETS];
+    memset(counts, 0, sizeof(size_t) * RADIX_BUCKETS);
+    long begin = block * (long)pass->blockSize;
+    long end = begin + pass->blockSize < pass->count ? begin + pass->blockSize : pass->count;
+    for (long i = begin; i < end; ++i) {
+        counts[(weightKey(pass->from[i].weight) >> pass->shift) & (RADIX_BUCKETS - 1)]++;
+    }
+}
+
+static void radixScatter(void* ctx, long block, int worker) {
+    (void)worker;
+    RadixPass* pass = (RadixPass*)ctx;
+    size_t* next = &pass->buckets[(size_t)block * RADIX_BUCKETS];
+    long begin = block * (long)pass->blockSize;
+    long end = begin + pass->blockSize < pass->count ? begin + pass->blockSize : pass->count;
+    for (long i = begin; i < end; ++i) {
+        pass->to[next[(weightKey(pass->from[i].weight) >> pass->shift) & (RADIX_BUCKETS - 1)]++] = pass->from[i];
+    }
+}
+
+int sortRouteEdgesByWeight(RouteEdge* edges, int count, WorkPool* pool) {
+    if (count < 2) return 0;
+    int blocks = 1;
+    if (pool && pool->threadCount > 1 && count >= EDGE_SORT_PARALLEL_MIN) blocks = pool->threadCount * 4;
+    RouteEdge* scratch = (RouteEdge*)malloc(sizeof(RouteEdge) * (size_t)count);
+    size_t* buckets = (size_t*)malloc(sizeof(size_t) * RADIX_BUCKETS * (size_t)blocks);
+    if (!scratch || !buckets) {
+        free(scratch);
+        free(buckets);
+        return -1;
+    }
+    RadixPass pass = { edges, scratch, count, (count + blocks - 1) / blocks, 0, buckets };
+    for (int p = 0; p < RADIX_PASSES; ++p) {
+        pass.shift = p * RADIX_BITS;
+        if (blocks > 1) {
+            workPoolRun(pool, blocks, radixHistogram, &pass);
+        } else {
+            radixHistogram(&pass, 0, 0);
+        }
+        // Exclusive prefix over (digit, block) so each block scatters into its own slots
+        size_t total = 0;
+        int skip = 0;
+        for (int d = 0; d < RADIX_BUCKETS && !skip; ++d) {
+            size_t digitTotal = 0;
+            for (int b = 0; b < blocks; ++b) {
+                size_t* slot = &buckets[(size_t)b * RADIX_BUCKETS + d];
+                size_t n = *slot;
+                *slot = total;
+                total += n;
+                digitTotal += n;
+            }
+            skip = digitTotal == (size_t)count;
+        }
+        if (skip) continue; // every key has this digit; the pass would not move anything
+        if (blocks > 1) {
+            workPoolRun(pool, blocks, radixScatter, &pass);
+        } else {
+            radixScatter(&pass, 0, 0);
+        }
+        RouteEdge* swap = (RouteEdge*)pass.from;
+        pass.from = pass.to;
+        pass.to = swap;
+    }
+    if (pass.from != edges) memcpy(edges, pass.from, sizeof(RouteEdge) * (size_t)count);
+    free(scratch);
+    free(buckets);
+    return 0;
+}
+
+typedef struct {
+    int* parent;
+    int* rank;
+    MSTResultEdge* output;
+    int count;
+    int target; // vertexCount - 1: nothing can be added after that
+    double weight;
+} KruskalState;
+
+static int kruskalStateInit(KruskalState* st, int vertexCount, MSTResultEdge* output) {
+    size_t n = (size_t)(vertexCount > 0 ? vertexCount : 1);
+    st->parent = (int*)malloc(sizeof(int) * n);
+    st->rank = (int*)calloc(n, sizeof(int));
+    if (!st->parent || !st->rank) {
+        free(st->parent);
+        free(st->rank);
+        return -1;
+    }
+    for (int v = 0; v < vertexCount; ++v) st->parent[v] = v;
+    st->output = output;
+    st->count = 0;
+    st->target = vertexCount > 0 ? vertexCount - 1 : 0;
+    st->weight = 0.0;
+    return 0;
+}
+
+static void kruskalStateFree(KruskalState* st) {
+    free(st->parent);
+    free(st->rank);
+}
+
+// Edges must already be in weight order
+static void kruskalScan(KruskalState* st, const RouteEdge* edges, int count) {
+    for (int i = 0; i < count && st->count < st->target; ++i) {
+        if (!disjointSetUnion(st->parent, st->rank, edges[i].src, edges[i].dest)) continue;
+        MSTResultEdge* out = &st->output[st->count++];
+        out->src = edges[i].src;
+        out->dest = edges[i].dest;
+        out->weight = edges[i].weight;
+        st->weight += edges[i].weight;
+    }
+}
+
+double kruskalForest(int vertexCount, RouteEdge* edges, int edgeCount, MSTResultEdge* output, int* forestEdgeCount,
+                     WorkPool* pool) {
+    *forestEdgeCount = 0;
+    KruskalState st;
+    if (kruskalStateInit(&st, vertexCount, output) != 0) return -1.0;
+    if (sortRouteEdgesByWeight(edges, edgeCount, pool) != 0) {
+        kruskalStateFree(&st);
+        return -1.0;
+    }
+    kruskalScan(&st, edges, edgeCount);
+    kruskalStateFree(&st);
+    *forestEdgeCount = st.count;
+    return st.weight;
+}
+
+static int compareWeights(const void* a, const void* b) {
+    double x = *(const double*)a, y = *(const double*)b;
+    return (x > y) - (x < y);
+}
+
+static double samplePivot(const RouteEdge* edges, int count, uint64_t* rng) {
+    double sample[PIVOT_SAMPLES];
+    for (int i = 0; i < PIVOT_SAMPLES; ++i) {
+        *rng ^= *rng << 13;
+        *rng ^= *rng >> 7;
+        *rng ^= *rng << 17;
+        sample[i] = edges[*rng % (uint64_t)count].weight;
+    }
+    qsort(sample, PIVOT_SAMPLES, sizeof(double), compareWeights);
+    return sample[PIVOT_SAMPLES / 2];
+}
+
+// Moves edges with weight <= pivot (or < pivot when strict) to the front; returns how many
+static int partitionByWeight(RouteEdge* edges, int count, double pivot, int strict) {
+    int light = 0;
+    for (int i = 0; i < count; ++i) {
+        int isLight = strict ? edges[i].weight < pivot : edges[i].weight <= pivot;
+        if (!isLight) continue;
+        RouteEdge t = edges[light];
+        edges[light] = edges[i];
+        edges[i] = t;
+        light++;
+    }
+    return light;
+}
+
+static int filterKruskalRun(KruskalState* st, RouteEdge* edges, int count, WorkPool* pool, uint64_t* rng) {
+    if (st->count == st->target || count == 0) return 0;
+    int split = 0;
+    if (count > FILTER_KRUSKAL_BASE_EDGES) {
+        double pivot = samplePivot(edges, count, rng);
+        split = partitionByWeight(edges, count, pivot, 0);
+        // A pivot equal to the heaviest weight leaves nothing heavy; retry with the pivot itself heavy
+        if (split == count) split = partitionByWeight(edges, count, pivot, 1);
+    }
+    if (split == 0) {
+        // Small enough, or every weight equal to the pivot: sort and scan directly
+        if (sortRouteEdgesByWeight(edges, count, pool) != 0) return -1;
+        kruskalScan(st, edges, count);
+        return 0;
+    }
+    if (filterKruskalRun(st, edges, split, pool, rng) != 0) return -1;
+    if (st->count == st->target) return 0;
+    int kept = split;
+    for (int i = split; i < count; ++i) {
+        if (disjointSetFind(st->parent, edges[i].src) == disjointSetFind(st->parent, edges[i].dest)) continue;
+        edges[kept++] = edges[i];
+    }
+    return filterKruskalRun(st, edges + split, kept - split, pool, rng);
+}
+
+double filterKruskalForest(int vertexCount, RouteEdge* edges, int edgeCount, MSTResultEdge* output,
+                           int* forestEdgeCount, WorkPool* pool) {
+    *forestEdgeCount = 0;
+    KruskalState st;
+    if (kruskalStateInit(&st, vertexCount, output) != 0) return -1.0;
+    uint64_t rng = 0x9E3779B97F4A7C15ull;
+    int status = filterKruskalRun(&st, edges, edgeCount, pool, &rng);
+    kruskalStateFree(&st);
+    if (status != 0) return -1.0;
+    *forestEdgeCount = st.count;
+    return st.weight;
+}
+
+double primForestCsr(const CsrGraph* graph, MSTResultEdge* output, int* forestEdgeCount) {
+    *forestEdgeCount = 0;
+    int n = graph->vertexCount;
+    size_t count = (size_t)(n > 0 ? n : 1);
+    int* parent = (int*)malloc(sizeof(int) * count);
+    double* key = (double*)malloc(sizeof(double) * count);
+    unsigned char* done = (unsigned char*)calloc(count, 1);
+    IndexedHeap heap;
+    if (!parent || !key || !done || indexedHeapInit(&heap, n) != 0) {
+        free(parent);
+        free(key);
+        free(done);
+        return -1.0;
+    }
+    for (int v = 0; v < n; ++v) {
+        key[v] = INF_WEIGHT;
+        parent[v] = -1;
+    }
+    double total = 0.0;
+    int edges = 0;
+    for (int root = 0; root < n; ++root) {
+        if (done[root]) continue;
+        // Each unreached vertex starts a new tree of the forest
+        key[root] = 0.0;
+        indexedHeapPushOrDecrease(&heap, root, 0.0);
+        double k;
+        int u;
+        while ((u = indexedHeapPop(&heap, &k)) != -1) {
+            done[u] = 1;
+            if (parent[u] != -1) {
+                output[edges].src = parent[u];
+                output[edges].dest = u;
+                output[edges].weight = k;
+                total += k;
+                edges++;
+            }
+            for (int a = graph->rowStart[u]; a < graph->rowStart[u + 1]; ++a) {
+                int v = graph->target[a];
+                double w = graph->weight[a];
+                if (done[v] || w >= key[v]) continue;
+                key[v] = w;
+                parent[v] = u;
+                indexedHeapPushOrDecrease(&heap, v, w);
+            }
+        }
+    }
+    indexedHeapFree(&heap);
+    free(parent);
+    free(key);
+    free(done);
+    *forestEdgeCount = edges;
+    return total;
+}
+
+typedef struct {
+    int a; // component ids this round
+    int b;
+    int id; // index into the caller's edge list
+    double weight;
+} BoruvkaEdge;
+
+// Weight kept beside the position so comparisons stay inside the per-component array
+typedef struct {
+    double weight;
+    int edge; // -1 until the component sees an outgoing edge
+} BoruvkaPick;
+
+typedef struct {
+    BoruvkaEdge* edges;
+    int edgeCount;
+    int blockSize;
+    int components;
+    int workers;
+    BoruvkaPick* best; // workers x components: cheapest edge seen by each worker
+    int* picked;       // per component, merged across workers
+    int* relabel;  // old component -> new component
+    int* keptPerBlock;
+} BoruvkaRound;
+
+// Position order breaks weight ties, making the choice a strict total order
+static inline int boruvkaLighter(double weight, int edge, const BoruvkaPick* than) {
+    if (than->edge == -1) return 1;
+    if (weight != than->weight) return weight < than->weight;
+    return edge < than->edge;
+}
+
+static inline long boruvkaBlockEnd(const BoruvkaRound* r, long block) {
+    long end = (block + 1) * (long)r->blockSize;
+    return end < r->edgeCount ? end : r->edgeCount;
+}
+
+static inline void boruvkaOffer(BoruvkaPick* pick, double weight, int edge) {
+    if (!boruvkaLighter(weight, edge, pick)) return;
+    pick->weight = weight;
+    pick->edge = edge;
+}
+
+static void boruvkaFindCheapest(void* ctx, long block, int worker) {
+    BoruvkaRound* r = (BoruvkaRound*)ctx;
+    BoruvkaPick* best = &r->best[(size_t)worker * (size_t)r->components];
+    const BoruvkaEdge* edges = r->edges;
+    for (long i = block * (long)r->blockSize; i < boruvkaBlockEnd(r, block); ++i) {
+        boruvkaOffer(&best[edges[i].a], edges[i].weight, (int)i);
+        boruvkaOffer(&best[edges[i].b], edges[i].weight, (int)i);
+    }
+}
+
+static void boruvkaMergeBest(void* ctx, long block, int worker) {
+    (void)worker;
+    BoruvkaRound* r = (BoruvkaRound*)ctx;
+    long begin = block * (long)r->blockSize;
+    long end = begin + r->blockSize < r->components ? begin + r->blockSize : r->components;
+    for (long c = begin; c < end; ++c) {
+        BoruvkaPick pick = r->best[c];
+        for (int w = 1; w < r->workers; ++w) {
+            const BoruvkaPick* other = &r->best[(size_t)w * (size_t)r->components + (size_t)c];
+            if (other->edge != -1) boruvkaOffer(&pick, other->weight, other->edge);
+        }
+        r->picked[c] = pick.edge;
+    }
+}
+
+// Renames both ends to the contracted components and keeps, in order, only edges between two of them
+static void boruvkaCompact(void* ctx, long block, int worker) {
+    (void)worker;
+    BoruvkaRound* r = (BoruvkaRound*)ctx;
+    long begin = block * (long)r->blockSize;
+    long kept = begin;
+    for (long i = begin; i < boruvkaBlockEnd(r, block); ++i) {
+        BoruvkaEdge e = r->edges[i];
+        e.a = r->relabel[e.a];
+        e.b = r->relabel[e.b];
+        if (e.a != e.b) r->edges[kept++] = e;
+    }
+    r->keptPerBlock[block] = (int)(kept - begin);
+}
+
+static void boruvkaParallel(BoruvkaRound* r, WorkPool* pool, long tasks, WorkPoolTaskFn fn) {
+    if (tasks > 1) {
+        workPoolRun(pool, tasks, fn, r);
+    } else if (tasks == 1) {
+        fn(r, 0, 0);
+    }
+}
+
+double boruvkaForest(int vertexCount, const RouteEdge* edges, int edgeCount, MSTResultEdge* output,
+                     int* forestEdgeCount, WorkPool* pool) {
+    *forestEdgeCount = 0;
+    int workers = pool ? pool->threadCount : 1;
+    size_t n = (size_t)(vertexCount > 0 ? vertexCount : 1);
+    int maxBlocks = workers * 4;
+    BoruvkaRound r;
+    memset(&r, 0, sizeof(r));
+    r.workers = workers;
+    r.edges = (BoruvkaEdge*)malloc(sizeof(BoruvkaEdge) * (size_t)(edgeCount > 0 ? edgeCount : 1));
+    r.best = (BoruvkaPick*)malloc(sizeof(BoruvkaPick) * n * (size_t)workers);
+    r.picked = (int*)malloc(sizeof(int) * n);
+    r.relabel = (int*)malloc(sizeof(int) * n);
+    r.keptPerBlock = (int*)malloc(sizeof(int) * (size_t)maxBlocks);
+    int* parent = (int*)malloc(sizeof(int) * n);
+    int* rank = (int*)malloc(sizeof(int) * n);
+    if (!r.edges || !r.best || !r.picked || !r.relabel || !r.keptPerBlock || !parent || !rank) {
+        free(r.edges);
+        free(r.best);
+        free(r.picked);
+        free(r.relabel);
+        free(r.keptPerBlock);
+        free(parent);
+        free(rank);
+        return -1.0;
+    }
+    for (int i = 0; i < edgeCount; ++i) {
+        if (edges[i].src == edges[i].dest) continue;
+        BoruvkaEdge* e = &r.edges[r.edgeCount++];
+        e->a = edges[i].src;
+        e->b = edges[i].dest;
+        e->id = i;
+        e->weight = edges[i].weight;
+    }
+    r.components = vertexCount;
+
+    double total = 0.0;
+    int count = 0;
+    while (r.edgeCount > 0) {
+        int parallel = workers > 1 && r.edgeCount >= EDGE_SORT_PARALLEL_MIN;
+        int blocks = parallel ? maxBlocks : 1;
+        int usedWorkers = parallel ? workers : 1;
+        r.blockSize = (r.edgeCount + blocks - 1) / blocks;
+        r.workers = usedWorkers;
+        for (size_t i = 0; i < (size_t)r.components * (size_t)usedWorkers; ++i) r.best[i].edge = -1;
+        boruvkaParallel(&r, pool, blocks, boruvkaFindCheapest);
+        int edgeBlockSize = r.blockSize;
+        r.blockSize = (r.components + blocks - 1) / blocks;
+        boruvkaParallel(&r, pool, blocks, boruvkaMergeBest);
+
+        // Contract the picks; a pick made by both of its ends is only taken once
+        for (int c = 0; c < r.components; ++c) {
+            parent[c] = c;
+            rank[c] = 0;
+        }
+        for (int c = 0; c < r.components; ++c) {
+            int e = r.picked[c];
+            if (e == -1 || !disjointSetUnion(parent, rank, r.edges[e].a, r.edges[e].b)) continue;
+            const RouteEdge* original = &edges[r.edges[e].id];
+            output[count].src = original->src;
+            output[count].dest = original->dest;
+            output[count].weight = original->weight;
+            total += original->weight;
+            count++;
+        }
+        int next = 0;
+        for (int c = 0; c < r.components; ++c) {
+            if (disjointSetFind(parent, c) == c) r.picked[c] = next++;
+        }
+        for (int c = 0; c < r.components; ++c) r.relabel[c] = r.picked[disjointSetFind(parent, c)];
+        if (next == r.components) break; // nothing merged: the rest are isolated trees
+
+        r.blockSize = edgeBlockSize;
+        boruvkaParallel(&r, pool, blocks, boruvkaCompact);
+        int kept = 0;
+        for (int b = 0; b < blocks; ++b) {
+            long begin = (long)b * edgeBlockSize;
+            if (begin >= r.edgeCount) break;
+            if (kept != begin) memmove(&r.edges[kept], &r.edges[begin], sizeof(BoruvkaEdge) * (size_t)r.keptPerBlock[b]);
+            kept += r.keptPerBlock[b];
+        }
+        r.edgeCount = kept;
+        r.components = next;
+    }
+    free(r.edges);
+    free(r.best);
+    free(r.picked);
+    free(r.relabel);
+    free(r.keptPerBlock);
+    free(parent);
+    free(rank);
+    *forestEdgeCount = count;
+    return total;
+}
@@ -0,0 +1,66 @@
+#ifndef SPANNINGTREE_H
+#define SPANNINGTREE_H
+
+#include "routegraph.h"
+#include "workpool.h"
+
+// Below this many edges Filter-Kruskal just sorts and scans
+#define FILTER_KRUSKAL_BASE_EDGES 65536
+// Radix sorts smaller than this stay on the calling thread
+#define EDGE_SORT_PARALLEL_MIN 262144
+
+/*
+ * Union-find over caller-owned arrays: parent[v] = v and rank[v] = 0 to
+ * start. Finds halve the path as they climb; unions hang the lower-rank
+ * root under the higher one.
+ */
+int disjointSetFind(int* parent, int v);
+// Returns 1 if a and b were in different sets (now merged), 0 otherwise.
+int disjointSetUnion(int* parent, int* rank, int a, int b);
+
+/*
+ * Stable LSD radix sort by weight, 8 bits per pass over the IEEE-754 bit
+ * pattern (remapped so negative weights order correctly too). Passes
+ * where every weight shares the digit are skipped. With a pool, each pass
+ * histograms and scatters contiguous blocks in parallel.
+ * Returns 0, or -1 if the scratch buffer cannot be allocated.
+ */
+int sortRouteEdgesByWeight(RouteEdge* edges, int count, WorkPool* pool);
+
+/*
+ * Minimum spanning forest of an undirected edge list; edges are reordered
+ * in place and output needs room for vertexCount - 1 edges. A connected
+ * graph gives exactly vertexCount - 1 edges. pool may be NULL.
+ * Both return the total weight, or -1 on allocation failure.
+ */
+double kruskalForest(int vertexCount, RouteEdge* edges, int edgeCount, MSTResultEdge* output, int* forestEdgeCount,
+                     WorkPool* pool);
+// Filter-Kruskal: partitions around a sampled pivot weight, solves the light
+// half first, then drops heavy edges already inside one tree before recursing.
+// Dense graphs rarely sort most of their edges; below FILTER_KRUSKAL_BASE_EDGES
+// this is kruskalForest().
+double filterKruskalForest(int vertexCount, RouteEdge* edges, int edgeCount, MSTResultEdge* output,
+                           int* forestEdgeCount, WorkPool* pool);
+
+/*
+ * Prim over CSR with an indexed heap, O(E log V), restarting from the next
+ * unreached vertex so disconnected input yields a forest. Every route must
+ * be present in both directions (an undirected CSR).
+ * Returns the total weight, or -1 on allocation failure.
+ */
+double primForestCsr(const CsrGraph* graph, MSTResultEdge* output, int* forestEdgeCount);
+
+/*
+ * Boruvka: every round each component picks its cheapest outgoing edge,
+ * ties broken by position so the picks never close a cycle. Then the
+ * picks are contracted and edges inside a component are dropped. Finding
+ * the picks and relabelling and compacting the edges run in parallel
+ * blocks on the pool; each worker keeps its own per-component best
+ * array, so nothing is shared while scanning. Components at least halve
+ * every round. edges is left untouched; pool may be NULL.
+ * Returns the total weight, or -1 on allocation failure.
+ */
+double boruvkaForest(int vertexCount, const RouteEdge* edges, int edgeCount, MSTResultEdge* output,
+                     int* forestEdgeCount, WorkPool* pool);
+
+#endif // SPANNINGTREE_H
@@ -0,0 +1,213 @@
+#include "storequery.h"
+#include "stores.h"
+#include <stdlib.h>
+#include <string.h>
+
+typedef struct {
+    int record;
+    double key;
+} Ranked;
+
+typedef struct {
+    int (*compareText)(int a, int b); // text sorts compare the records themselves; NULL for numeric keys
+    int descending;
+} Ordering;
+
+// Total order on (sort key, record index); the index breaks ties so cursors are unambiguous
+static int rankedCompare(const Ordering* o, const Ranked* a, const Ranked* b) {
+    int c = o->compareText ? o->compareText(a->record, b->record) : (a->key > b->key) - (a->key < b->key);
+    if (o->descending) c = -c;
+    return c != 0 ? c : (a->record > b->record) - (a->record < b->record);
+}
+
+/*
+ * Keeps the `limit` smallest matches after the cursor in a max-heap, so
+ * a page costs O(matches * log limit) however deep into the results it is.
+ */
+typedef struct {
+    const Ordering* order;
+    Ranked cursor;
+    int hasCursor;
+    Ranked* heap;
+    int size;
+    int limit;
+    int total;
+    int after; // matches past the cursor
+} PageSelector;
+
+static void heapSiftDown(PageSelector* s, int i) {
+    for (;;) {
+        int largest = i;
+        int l = 2 * i + 1, r = l + 1;
+        if (l < s->size && rankedCompare(s->order, &s->heap[l], &s->heap[largest]) > 0) largest = l;
+        if (r < s->size && rankedCompare(s->order, &s->heap[r], &s->heap[largest]) > 0) largest = r;
+        if (largest == i) return;
+        Ranked t = s->heap[i];
+        s->heap[i] = s->heap[largest];
+        s->heap[largest] = t;
+        i = largest;
+    }
+}
+
+static void selectorOffer(PageSelector* s, int record, double key) {
+    Ranked r = { record, key };
+    s->total++;
+    if (s->hasCursor && rankedCompare(s->order, &r, &s->cursor) <= 0) return;
+    s->after++;
+    if (s->limit == 0) return;
+    if (s->size < s->limit) {
+        int i = s->size++;
+        s->heap[i] = r;
+        while (i > 0 && rankedCompare(s->order, &s->heap[(i - 1) / 2], &s->heap[i]) < 0) {
+            Ranked t = s->heap[i];
+            s->heap[i] = s->heap[(i - 1) / 2];
+            s->heap[(i - 1) / 2] = t;
+            i = (i - 1) / 2;
+        }
+    } else if (rankedCompare(s->order, &r, &s->heap[0]) < 0) {
+        s->heap[0] = r;
+        heapSiftDown(s, 0);
+    }
+}
+
+static int selectorInit(PageSelector* s, const Ordering* order, QueryCursor cursor, int limit) {
+    s->order = order;
+    s->cursor.record = cursor.record;
+    s->cursor.key = cursor.key;
+    s->hasCursor = cursor.record >= 0;
+    s->size = 0;
+    s->limit = limit > 0 ? limit : 0;
+    s->total = 0;
+    s->after = 0;
+    s->heap = (Ranked*)malloc(sizeof(Ranked) * (size_t)(s->limit > 0 ? s->limit : 1));
+    return s->heap ? 0 : -1;
+}
+
+// Heap-sorts the kept rows into page order and fills the page.
+static void selectorFinish(PageSelector* s, QueryPage* page) {
+    int n = s->size;
+    while (s->size > 1) {
+        Ranked top = s->heap[0];
+        s->heap[0] = s->heap[--s->size];
+        s->heap[s->size] = top;
+        heapSiftDown(s, 0);
+    }
+    for (int i = 0; i < n; ++i) page->records[i] = s->heap[i].record;
+    page->count = n;
+    page->total = s->total;
+    page->hasMore = s->after > n;
+    if (n > 0) {
+        page->next.record = s->heap[n - 1].record;
+        page->next.key = s->heap[n - 1].key;
+    } else {
+        page->next.record = s->cursor.record;
+        page->next.key = s->cursor.key;
+    }
+    free(s->heap);
+    s->heap = NULL;
+}
+
+// Records loaded from a snapshot or log are indexed on first use.
+static int ensureIndexed(void) {
+    pthread_rwlock_rdlock(&passengerRegistryLock);
+    int behind = flightsByOrigin.indexedCount < flightCount || passengersByFlight.indexedCount < passengerCount;
+    pthread_rwlock_unlock(&passengerRegistryLock);
+    if (!behind) return 0;
+    pthread_rwlock_wrlock(&passengerRegistryLock);
+    int status = syncSecondaryIndexes();
+    pthread_rwlock_unlock(&passengerRegistryLock);
+    return status;
+}
+
+/* ---------- Flights ---------- */
+
+void flightQueryInit(FlightQuery* q) {
+    memset(q, 0, sizeof(*q));
+    q->sort = FLIGHT_SORT_SCHEDULE;
+}
+
+static double flightSortValue(int flight, FlightSortKey sort) {
+    switch (sort) {
+        case FLIGHT_SORT_PRICE: return flightPrice(flight);
+        case FLIGHT_SORT_DEPARTURE: return flightClockMinutes(flightAt(flight)->departureTime);
+        case FLIGHT_SORT_SEATS_LEFT: return flightSeatsLeft(flight);
+        case FLIGHT_SORT_SCHEDULE: break;
+    }
+    return flight;
+}
+
+static void offerFlight(PageSelector* s, const FlightQuery* q, int flight, int destination) {
+    if (destination != -1 && flightAt(flight)->destination != destination) return;
+    if (q->maxPrice > 0 && flightPrice(flight) > q->maxPrice) return;
+    if (q->minSeats > 0 && flightSeatsLeft(flight) < q->minSeats) return;
+    selectorOffer(s, flight, flightSortValue(flight, q->sort));
+}
+
+int queryFlights(const FlightQuery* q, QueryCursor cursor, int limit, QueryPage* page) {
+    if (ensureIndexed() != 0) return -1;
+    Ordering order = { NULL, q->descending };
+    PageSelector s;
+    if (selectorInit(&s, &order, cursor, limit) != 0) return -1;
+    int origin = q->origin ? findAirport(q->origin) : -1;
+    int destination = q->destination ? findAirport(q->destination) : -1;
+    // A named airport no flight uses matches nothing
+    int known = !(q->origin && origin == -1) && !(q->destination && destination == -1);
+    if (known && origin != -1) {
+        for (int f = secondaryIndexFirst(&flightsByOrigin, origin); f != -1; f = secondaryIndexNext(&flightsByOrigin, f)) {
+            offerFlight(&s, q, f, destination);
+        }
+    } else if (known) {
+        for (int f = 0; f < flightCount; ++f) offerFlight(&s, q, f, destination);
+    }
+    selectorFinish(&s, page);
+    return 0;
+}
+
+/* ---------- Passengers ---------- */
+
+void passengerQueryInit(PassengerQuery* q) {
+    memset(q, 0, sizeof(*q));
+    q->ticketStatus = -1;
+    q->checkInStatus = -1;
+    q->sort = PASSENGER_SORT_BOOKING;
+}
+
+static int comparePassengerNames(int a, int b) {
+    const Passenger* pa = passengerAt(a);
+    const Passenger* pb = passengerAt(b);
+    int c = strcmp(pa->lastName, pb->lastName);
+    return c != 0 ? c : strcmp(pa->firstName, pb->firstName);
+}
+
+static int comparePassengerIds(int a, int b) {
+    return strcmp(passengerAt(a)->id, passengerAt(b)->id);
+}
+
+static void offerPassenger(PageSelector* s, const PassengerQuery* q, int passenger) {
+    const Passenger* p = passengerAt(passenger);
+    if (q->ticketStatus >= 0 && p->ticketStatus != q->ticketStatus) return;
+    // Waitlisted and cancelled records keep CHECKIN_PENDING, but it does not describe them
+    if (q->checkInStatus >= 0 && (p->ticketStatus != TICKET_CONFIRMED || p->checkInStatus != q->checkInStatus)) return;
+    selectorOffer(s, passenger, q->sort == PASSENGER_SORT_BOOKING ? passenger : 0.0);
+}
+
+int queryPassengers(const PassengerQuery* q, QueryCursor cursor, int limit, QueryPage* page) {
+    if (ensureIndexed() != 0) return -1;
+    Ordering order = { NULL, q->descending };
+    if (q->sort == PASSENGER_SORT_NAME) order.compareText = comparePassengerNames;
+    if (q->sort == PASSENGER_SORT_ID) order.compareText = comparePassengerIds;
+    PageSelector s;
+    if (selectorInit(&s, &order, cursor, limit) != 0) return -1;
+    pthread_rwlock_rdlock(&passengerRegistryLock);
+    if (q->flightNumber) {
+        int flight = findFlightIndex(q->flightNumber);
+        for (int p = secondaryIndexFirst(&passengersByFlight, flight); p != -1; p = secondaryIndexNext(&passengersByFlight, p)) {
+            offerPassenger(&s, q, p);
+        }
+    } else {
+        for (int p = 0; p < passengerCount; ++p) offerPassenger(&s, q, p);
+    }
+    pthread_rwlock_unlock(&passengerRegistryLock);
+    selectorFinish(&s, page);
+    return 0;
+}
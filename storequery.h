@@ -0,0 +1,69 @@
+#ifndef STOREQUERY_H
+#define STOREQUERY_H
+
+#include "airline.h"
+
+/*
+ * Filtered, sorted, paginated reads over the flight and passenger
+ * stores. Candidates come from the secondary indexes when a filter
+ * allows it (flights by origin, passengers by flight), so a query costs
+ * O(matching records), not a scan of the store. Pages use keyset
+ * cursors: a page holds the first `limit` matches ordered after the
+ * cursor by (sort key, record index), so paging stays correct while
+ * records are added and never re-sorts rows already returned.
+ */
+
+typedef enum {
+    FLIGHT_SORT_SCHEDULE = 0, // creation order
+    FLIGHT_SORT_PRICE,
+    FLIGHT_SORT_DEPARTURE,
+    FLIGHT_SORT_SEATS_LEFT
+} FlightSortKey;
+
+typedef enum {
+    PASSENGER_SORT_BOOKING = 0, // booking order
+    PASSENGER_SORT_NAME,        // last name, then first name
+    PASSENGER_SORT_ID
+} PassengerSortKey;
+
+typedef struct {
+    const char* origin;      // NULL = any
+    const char* destination; // NULL = any
+    float maxPrice;          // <= 0 = any
+    int minSeats;            // seats left, 0 = any
+    FlightSortKey sort;
+    int descending;
+} FlightQuery;
+
+typedef struct {
+    const char* flightNumber; // NULL = any
+    int ticketStatus;         // TicketStatus, or -1 = any
+    int checkInStatus;        // CheckInStatus, or -1 = any; only confirmed tickets have one
+    PassengerSortKey sort;
+    int descending;
+} PassengerQuery;
+
+// Position after the last row of a page; QUERY_CURSOR_START begins at the top.
+typedef struct {
+    int record; // -1 = before the first row
+    double key; // sort key of that record when the page was read (numeric sorts)
+} QueryCursor;
+
+#define QUERY_CURSOR_START { -1, 0.0 }
+
+typedef struct {
+    int* records; // caller-provided, room for `limit`
+    int count;
+    int total;   // matches of the filter, regardless of cursor
+    int hasMore; // rows remain after this page
+    QueryCursor next;
+} QueryPage;
+
+void flightQueryInit(FlightQuery* q);
+void passengerQueryInit(PassengerQuery* q);
+
+// Fills page->records with up to limit flight indexes. Returns 0, or -1 on allocation failure.
+int queryFlights(const FlightQuery* q, QueryCursor cursor, int limit, QueryPage* page);
+int queryPassengers(const PassengerQuery* q, QueryCursor cursor, int limit, QueryPage* page);
+
+#endif // STOREQUERY_H
@@ -0,0 +1,38 @@
+#ifndef STORES_H
+#define STORES_H
+
+#include <pthread.h>
+#include "airline.h"
+#include "arena.h"
+#include "hashindex.h"
+#include "flighttable.h"
+#include "secondaryindex.h"
+
+// Record stores and their indexes, shared with the modules that maintain them (persistence, ...)
+extern RecordArena flightStore; // FlightInfo records
+extern FlightColumns flightColumns;
+extern int flightCount;
+extern RecordArena airportStore; // AirportCode records
+extern int airportCount;
+extern HashIndex airportIndex;
+extern RecordArena passengerStore;
+extern int passengerCount;
+extern HashIndex flightIndex;
+extern HashIndex passengerIndex;
+extern pthread_rwlock_t passengerRegistryLock;
+// Secondary indexes: passengers by flight index, flights by origin airport id
+extern SecondaryIndex passengersByFlight;
+extern SecondaryIndex flightsByOrigin;
+
+// Indexes records the secondary indexes have not seen yet (e.g. loaded from disk).
+// Caller holds passengerRegistryLock for writing. Returns 0, or -1 on allocation failure.
+int syncSecondaryIndexes(void);
+
+typedef struct {
+    char code[NAME_LEN];
+} AirportCode;
+
+// Drops every flight, airport and passenger record and index entry.
+void resetStores(void);
+
+#endif // STORES_H
@@ -0,0 +1,82 @@
+#include "waitlist.h"
+#include <stdlib.h>
+#include <string.h>
+
+#define WAITLIST_HEAP_ARITY 4
+
+static int entryBefore(const WaitlistEntry* a, const WaitlistEntry* b) {
+    if (a->priority != b->priority) return a->priority < b->priority;
+    return a->passenger < b->passenger;
+}
+
+static void siftUp(WaitlistEntry* heap, size_t pos) {
+    WaitlistEntry moving = heap[pos];
+    while (pos > 0) {
+        size_t parent = (pos - 1) / WAITLIST_HEAP_ARITY;
+        if (!entryBefore(&moving, &heap[parent])) break;
+        heap[pos] = heap[parent];
+        pos = parent;
+    }
+    heap[pos] = moving;
+}
+
+static void siftDown(WaitlistEntry* heap, size_t count, size_t pos) {
+    WaitlistEntry moving = heap[pos];
+    for (;;) {
+        size_t first = pos * WAITLIST_HEAP_ARITY + 1;
+        if (first >= count) break;
+        size_t last = first + WAITLIST_HEAP_ARITY;
+        if (last > count) last = count;
+        size_t best = first;
+        for (size_t c = first + 1; c < last; ++c) {
+            if (entryBefore(&heap[c], &heap[best])) best = c;
+        }
+        if (!entryBefore(&heap[best], &moving)) break;
+        heap[pos] = heap[best];
+        pos = best;
+    }
+    heap[pos] = moving;
+}
+
+int waitlistPush(Waitlist* list, int passenger, int priority) {
+    if (list->count == list->capacity) {
+        size_t capacity = list->capacity ? list->capacity * 2 : 8;
+        WaitlistEntry* entries = (WaitlistEntry*)realloc(list->entries, sizeof(WaitlistEntry) * capacity);
+        if (!entries) return -1;
+        list->entries = entries;
+        list->capacity = capacity;
+    }
+    list->entries[list->count].priority = priority;
+    list->entries[list->count].passenger = passenger;
+    siftUp(list->entries, list->count++);
+    return 0;
+}
+
+int waitlistPop(Waitlist* list, WaitlistEntry* out) {
+    if (list->count == 0) return -1;
+    *out = list->entries[0];
+    if (--list->count > 0) {
+        list->entries[0] = list->entries[list->count];
+        siftDown(list->entries, list->count, 0);
+    }
+    return 0;
+}
+
+static int compareEntries(const void* a, const void* b) {
+    const WaitlistEntry* ea = (const WaitlistEntry*)a;
+    const WaitlistEntry* eb = (const WaitlistEntry*)b;
+    if (entryBefore(ea, eb)) return -1;
+    if (entryBefore(eb, ea)) return 1;
+    return 0;
+}
+
+void waitlistSnapshot(const Waitlist* list, WaitlistEntry* out) {
+    if (list->count == 0) return;
+    memcpy(out, list->entries, sizeof(WaitlistEntry) * list->count);
+    qsort(out, list->count, sizeof(WaitlistEntry), compareEntries);
+}
+
+void waitlistFree(Waitlist* list) {
+    free(list->entries);
+    memset(list, 0, sizeof(*list));
+}
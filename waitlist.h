@@ -0,0 +1,37 @@
+#ifndef WAITLIST_H
+#define WAITLIST_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+// Waitlisted booking; refers to the passenger store by index
+typedef struct {
+    int32_t priority;  // 1 is promoted first, like check-in tiers
+    int32_t passenger; // booking order, FIFO tie-break inside a tier
+} WaitlistEntry;
+
+/*
+ * Per-flight waitlist: a 4-ary min-heap on (priority, passenger index).
+ * Cancelling a waitlisted booking only tombstones the passenger record;
+ * its entry stays here until it reaches the top and the promoter skips
+ * it, so a cancellation never searches the heap. The owner keeps live,
+ * the number of entries still waiting, as it tombstones and promotes.
+ */
+typedef struct {
+    WaitlistEntry* entries;
+    size_t count;
+    size_t capacity;
+    int live;
+} Waitlist;
+
+#define WAITLIST_INIT { NULL, 0, 0, 0 }
+
+// Returns 0, or -1 on allocation failure.
+int waitlistPush(Waitlist* list, int passenger, int priority);
+// Removes the front entry into *out; returns -1 if the heap is empty.
+int waitlistPop(Waitlist* list, WaitlistEntry* out);
+// Copies the entries, tombstones included, into out[] in promotion order; out must hold list->count.
+void waitlistSnapshot(const Waitlist* list, WaitlistEntry* out);
+void waitlistFree(Waitlist* list);
+
+#endif // WAITLIST_H
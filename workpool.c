@@ -0,0 +1,196 @@
+#include "workpool.h"
+#include <stdlib.h>
+#ifdef _WIN32
+#include <malloc.h>
+#include <windows.h>
+#else
+#include <unistd.h>
+#endif
+
+typedef struct {
+    WorkPool* pool;
+    int id;
+} WorkerStart;
+
+int workPoolDefaultThreads(void) {
+#ifdef _WIN32
+    SYSTEM_INFO info;
+    GetSystemInfo(&info);
+    int n = (int)info.dwNumberOfProcessors;
+#else
+    int n = (int)sysconf(_SC_NPROCESSORS_ONLN);
+#endif
+    return n > 0 ? n : 1;
+}
+
+static void freeRanges(WorkRange* ranges) {
+#ifdef _WIN32
+    _aligned_free(ranges);
+#else
+    free(ranges);
+#endif
+}
+
+static int takeOwnTask(WorkRange* range, long* index) {
+    int found = 0;
+    pthread_mutex_lock(&range->lock);
+    if (range->next < range->end) {
+        *index = range->next++;
+        found = 1;
+    }
+    pthread_mutex_unlock(&range->lock);
+    return found;
+}
+
+// Moves the back half of some other worker's range into ours. Returns 0 when nothing is left anywhere.
+static int stealTasks(WorkPool* pool, int id) {
+    for (int offset = 1; offset < pool->threadCount; ++offset) {
+        WorkRange* victim = &pool->ranges[(id + offset) % pool->threadCount];
+        long lo = 0, hi = 0;
+        pthread_mutex_lock(&victim->lock);
+        long remaining = victim->end - victim->next;
+        if (remaining > 0) {
+            hi = victim->end;
+            lo = victim->end - (remaining + 1) / 2;
+            victim->end = lo;
+        }
+        pthread_mutex_unlock(&victim->lock);
+        if (hi > lo) {
+            WorkRange* own = &pool->ranges[id];
+            pthread_mutex_lock(&own->lock);
+            own->next = lo;
+            own->end = hi;
+            pthread_mutex_unlock(&own->lock);
+            atomic_fetch_add_explicit(&pool->steals, 1, memory_order_relaxed);
+            return 1;
+        }
+    }
+    return 0;
+}
+
+static void runWorker(WorkPool* pool, int id) {
+    long index;
+    for (;;) {
+        while (takeOwnTask(&pool->ranges[id], &index)) {
+            pool->fn(pool->ctx, index, id);
+        }
+        if (!stealTasks(pool, id)) break;
+    }
+}
+
+static void* workerMain(void* arg) {
+    WorkerStart start = *(WorkerStart*)arg;
+    free(arg);
+    WorkPool* pool = start.pool;
+    unsigned long seen = 0;
+    pthread_mutex_lock(&pool->lock);
+    for (;;) {
+        while (pool->generation == seen && !pool->shuttingDown) {
+            pthread_cond_wait(&pool->wake, &pool->lock);
+        }
+        if (pool->shuttingDown) break;
+        seen = pool->generation;
+        pthread_mutex_unlock(&pool->lock);
+
+        runWorker(pool, start.id);
+
+        pthread_mutex_lock(&pool->lock);
+        if (--pool->running == 0) pthread_cond_signal(&pool->finished);
+    }
+    pthread_mutex_unlock(&pool->lock);
+    return NULL;
+}
+
+int workPoolInit(WorkPool* pool, int threadCount) {
+    if (threadCount <= 0) threadCount = workPoolDefaultThreads();
+    pool->threadCount = threadCount;
+    pool->threads = (pthread_t*)calloc((size_t)threadCount, sizeof(pthread_t));
+#ifdef _WIN32
+    pool->ranges = (WorkRange*)_aligned_malloc(sizeof(WorkRange) * (size_t)threadCount, WORK_POOL_CACHE_LINE);
+#else
+    pool->ranges = (WorkRange*)aligned_alloc(WORK_POOL_CACHE_LINE, sizeof(WorkRange) * (size_t)threadCount);
+#endif
+    if (!pool->threads || !pool->ranges) {
+        free(pool->threads);
+        freeRanges(pool->ranges);
+        pool->ranges = NULL;
+        return -1;
+    }
+    for (int i = 0; i < threadCount; ++i) {
+        pthread_mutex_init(&pool->ranges[i].lock, NULL);
+        pool->ranges[i].next = 0;
+        pool->ranges[i].end = 0;
+    }
+    pthread_mutex_init(&pool->lock, NULL);
+    pthread_cond_init(&pool->wake, NULL);
+    pthread_cond_init(&pool->finished, NULL);
+    pool->generation = 0;
+    pool->running = 0;
+    pool->shuttingDown = 0;
+    pool->fn = NULL;
+    pool->ctx = NULL;
+    atomic_init(&pool->steals, 0);
+
+    for (int i = 1; i < threadCount; ++i) {
+        WorkerStart* start = (WorkerStart*)malloc(sizeof(WorkerStart));
+        if (start) {
+            start->pool = pool;
+            start->id = i;
+        }
+        if (!start || pthread_create(&pool->threads[i], NULL, workerMain, start) != 0) {
+            free(start);
+            // Carry on with the helpers that did start
+            pool->threadCount = i;
+            break;
+        }
+    }
+    return 0;
+}
+
+void workPoolDestroy(WorkPool* pool) {
+    if (!pool->ranges) return;
+    pthread_mutex_lock(&pool->lock);
+    pool->shuttingDown = 1;
+    pthread_cond_broadcast(&pool->wake);
+    pthread_mutex_unlock(&pool->lock);
+    for (int i = 1; i < pool->threadCount; ++i) {
+        pthread_join(pool->threads[i], NULL);
+    }
+    for (int i = 0; i < pool->threadCount; ++i) {
+        pthread_mutex_destroy(&pool->ranges[i].lock);
+    }
+    pthread_mutex_destroy(&pool->lock);
+    pthread_cond_destroy(&pool->wake);
+    pthread_cond_destroy(&pool->finished);
+    free(pool->threads);
+    freeRanges(pool->ranges);
+    pool->threads = NULL;
+    pool->ranges = NULL;
+}
+
+void workPoolRun(WorkPool* pool, long taskCount, WorkPoolTaskFn fn, void* ctx) {
+    if (taskCount <= 0) return;
+    int workers = pool->threadCount;
+    // Contiguous starting shares keep neighbouring tasks on one core; stealing evens out the rest
+    for (int i = 0; i < workers; ++i) {
+        pthread_mutex_lock(&pool->ranges[i].lock);
+        pool->ranges[i].next = taskCount * i / workers;
+        pool->ranges[i].end = taskCount * (i + 1) / workers;
+        pthread_mutex_unlock(&pool->ranges[i].lock);
+    }
+    pthread_mutex_lock(&pool->lock);
+    pool->fn = fn;
+    pool->ctx = ctx;
+    pool->running = workers - 1;
+    pool->generation++;
+    pthread_cond_broadcast(&pool->wake);
+    pthread_mutex_unlock(&pool->lock);
+
+    runWorker(pool, 0);
+
+    pthread_mutex_lock(&pool->lock);
+    while (pool->running > 0) {
+        pthread_cond_wait(&pool->finished, &pool->lock);
+    }
+    pthread_mutex_unlock(&pool->lock);
+}
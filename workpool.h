@@ -0,0 +1,50 @@
+#ifndef WORKPOOL_H
+#define WORKPOOL_H
+
+#include <pthread.h>
+#include <stdatomic.h>
+
+#define WORK_POOL_CACHE_LINE 64
+
+typedef void (*WorkPoolTaskFn)(void* ctx, long index, int worker);
+
+/*
+ * A worker's share of the current job: task indices [next, end).
+ * The owner takes from the front. A thief takes the back half in one
+ * step, so a slow row of work is split up instead of waited on.
+ */
+typedef struct {
+    _Alignas(WORK_POOL_CACHE_LINE) pthread_mutex_t lock;
+    long next;
+    long end;
+} WorkRange;
+
+/*
+ * Fixed set of threads that run parallel-for jobs with work stealing.
+ * The calling thread acts as worker 0, so a pool of N uses N - 1
+ * helper threads. Helpers sleep on a condition variable between jobs.
+ */
+typedef struct {
+    int threadCount;
+    pthread_t* threads;
+    WorkRange* ranges;
+    pthread_mutex_t lock;
+    pthread_cond_t wake;
+    pthread_cond_t finished;
+    unsigned long generation;
+    int running; // helpers still inside the current job
+    int shuttingDown;
+    WorkPoolTaskFn fn;
+    void* ctx;
+    atomic_long steals;
+} WorkPool;
+
+// Online CPU count, at least 1.
+int workPoolDefaultThreads(void);
+// threadCount <= 0 means workPoolDefaultThreads(). Returns 0 or -1.
+int workPoolInit(WorkPool* pool, int threadCount);
+void workPoolDestroy(WorkPool* pool);
+// Calls fn(ctx, i, worker) for every i in [0, taskCount) and returns when all are done.
+void workPoolRun(WorkPool* pool, long taskCount, WorkPoolTaskFn fn, void* ctx);
+
+#endif // WORKPOOL_H